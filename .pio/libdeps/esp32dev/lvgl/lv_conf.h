@@ -81,6 +81,14 @@
         #undef LV_MEM_POOL_INCLUDE
         #undef LV_MEM_POOL_ALLOC
     #endif
+
+    /** Bytes of `LV_MEM_SIZE` reserved for slabs. Allocations up to 256 bytes (draw tasks,
+     *  widgets, short texts) are served in O(1) from size-class pages in this region and
+     *  go to TLSF only when it is full, so the frame-rate churn doesn't fragment the heap.
+     *  Must be a multiple of 1 kB. 0: disable */
+    #ifndef LV_MEM_SLAB_SIZE
+        #define LV_MEM_SLAB_SIZE (12 * 1024U)
+    #endif
 #endif  /*LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN*/
 
 /*====================
@@ -107,7 +115,13 @@
  * - LV_OS_MQX
  * - LV_OS_SDL2
  * - LV_OS_CUSTOM */
-#define LV_USE_OS   LV_OS_NONE
+#if defined(DASH_DUAL_CORE) && defined(ARDUINO)
+    #define LV_USE_OS   LV_OS_FREERTOS  /* Opt-in (build flag DASH_DUAL_CORE): render on both ESP32 cores */
+#elif defined(DASH_DUAL_CORE)
+    #define LV_USE_OS   LV_OS_PTHREAD   /* Same configuration on a host build */
+#else
+    #define LV_USE_OS   LV_OS_NONE
+#endif
 
 #if LV_USE_OS == LV_OS_CUSTOM
     #define LV_OS_CUSTOM_INCLUDE <stdint.h>
@@ -165,6 +179,17 @@
  *  rendering performance but might cause other tasks to starve. */
 #define LV_DRAW_THREAD_PRIO LV_THREAD_PRIO_HIGH
 
+/** Find the older draw tasks a task depends on through a grid over the layer instead of
+ *  testing every older task of the layer. Only useful with an OS, where the draw threads
+ *  take tasks out of order. The grid is built when a layer holds
+ *  `LV_DRAW_TASK_INDEX_MIN_TASKS` tasks and freed when they are all done.
+ *  Off, also with DASH_DUAL_CORE: the "stress" command showed no frame time it saves,
+ *  as the draw units take tasks before many are pending. Time it there before enabling.*/
+#define LV_DRAW_TASK_INDEX              0
+#if LV_DRAW_TASK_INDEX
+    #define LV_DRAW_TASK_INDEX_MIN_TASKS    32
+#endif
+
 #define LV_USE_DRAW_SW 1
 #if LV_USE_DRAW_SW == 1
     /*
@@ -192,7 +217,11 @@
     /** Set number of draw units.
      *  - > 1 requires operating system to be enabled in `LV_USE_OS`.
      *  - > 1 means multiple threads will render the screen in parallel. */
-    #define LV_DRAW_SW_DRAW_UNIT_CNT    1
+    #if LV_USE_OS != LV_OS_NONE
+        #define LV_DRAW_SW_DRAW_UNIT_CNT    2
+    #else
+        #define LV_DRAW_SW_DRAW_UNIT_CNT    1
+    #endif
 
     /** Use Arm-2D to accelerate software (sw) rendering. */
     #define LV_USE_DRAW_ARM2D_SYNC      0
@@ -216,17 +245,28 @@
          *  `radius * 4` bytes are used per circle (the most often used radiuses are saved).
          *  - 0: disables caching */
         #define LV_DRAW_SW_CIRCLE_CACHE_SIZE 4
+
+        /** Size of the cache of rendered shadow corners and rounded-corner masks [bytes].
+         *  Masks are looked up by their shape (size, radius, spread, blur), so objects of the
+         *  same style share them and a redraw needs no mask calculation.
+         *  - 0: disables caching */
+        #define LV_DRAW_SW_MASK_CACHE_SIZE (4 * 1024)
     #endif
 
-    #define  LV_USE_DRAW_SW_ASM     LV_DRAW_SW_ASM_NONE
+    /*Two-pixels-per-word RGB565 kernels from the project (include/blend_swar.h)*/
+    #define  LV_USE_DRAW_SW_ASM     LV_DRAW_SW_ASM_CUSTOM
 
     #if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_CUSTOM
-        #define  LV_DRAW_SW_ASM_CUSTOM_INCLUDE ""
+        #define  LV_DRAW_SW_ASM_CUSTOM_INCLUDE "blend_swar.h"
     #endif
 
     /** Enable drawing complex gradients in software: linear at an angle, radial or conical */
     #define LV_USE_DRAW_SW_COMPLEX_GRADIENTS    0
 
+    /** Blend plain (uncompressed) 4 bpp glyphs straight from the font bitmap into
+     *  RGB565 layers instead of unpacking them to an A8 buffer first */
+    #define LV_DRAW_SW_GLYPH_A4_DIRECT    1
+
 #endif
 
 /*Use TSi's aka (Think Silicon) NemaGFX */
@@ -503,6 +543,14 @@
  *  The main logic is like `LV_CACHE_DEF_SIZE` but for image headers. */
 #define LV_IMAGE_HEADER_CACHE_DEF_CNT 0
 
+/** Byte budget of the LRU cache holding decoded (A8) glyph masks, so glyphs that are
+ *  redrawn often are not decoded from the font again on every band and frame.
+ *  It only serves glyphs that take the unpack path: compressed or non-A4 fonts, and
+ *  A4 glyphs drawn to non-RGB565 layers. With `LV_DRAW_SW_GLYPH_A4_DIRECT` every font
+ *  of this project is blended straight from flash and never reaches it.
+ *  0: disable the glyph cache */
+#define LV_GLYPH_CACHE_SIZE     0
+
 /** Number of stops allowed per gradient. Increase this to allow more stops.
  *  This adds (sizeof(lv_color_t) + 1) bytes per additional stop. */
 #define LV_GRADIENT_MAX_STOPS   2
@@ -687,6 +735,11 @@
  *  Depends on LV_TXT_LINE_BREAK_LONG_LEN. */
 #define LV_TXT_LINE_BREAK_LONG_POST_MIN_LEN 3
 
+/** Number of fonts whose ASCII advance widths are kept in a table to measure and wrap text
+ *  without glyph lookups. Only fonts in LVGL's own format (C arrays and BIN fonts) are cached,
+ *  the first that many to be measured. Uses ~100 bytes per font. 0: disable */
+#define LV_TEXT_ASCII_ADV_CACHE_CNT 8
+
 /** Support bidirectional text. Allows mixing Left-to-Right and Right-to-Left text.
  *  The direction will be processed according to the Unicode Bidirectional Algorithm:
  *  https://www.w3.org/International/articles/inline-bidi-markup/uba-basics */
@@ -914,10 +967,11 @@
 #endif
 
 /** API for Arduino Sd. */
-#define LV_USE_FS_ARDUINO_SD 0
+#define LV_USE_FS_ARDUINO_SD 1
 #if LV_USE_FS_ARDUINO_SD
-    #define LV_FS_ARDUINO_SD_LETTER '\0'  /**< Set an upper-case driver-identifier letter for this driver (e.g. 'A'). */
+    #define LV_FS_ARDUINO_SD_LETTER 'S'   /**< Set an upper-case driver-identifier letter for this driver (e.g. 'A'). */
     #define LV_FS_ARDUINO_SD_PATH ""      /**< Set the working directory. File/directory paths will be appended to it. */
+    #define LV_FS_ARDUINO_SD_CACHE_SIZE 2048 /**< >0 to cache this number of bytes in lv_fs_read() */
 #endif
 
 /** API for UEFI */
@@ -1072,20 +1126,28 @@
     #endif
 #endif /*LV_USE_SYSMON*/
 
-/** 1: Enable runtime performance profiler */
-#define LV_USE_PROFILER 0
+/** 1: Enable runtime performance profiler
+ *  Opt-in with the build flag DASH_TRACE: the project's trace module (include/trace.h)
+ *  streams the markers over the serial port. */
+#ifdef DASH_TRACE
+    #define LV_USE_PROFILER 1
+#else
+    #define LV_USE_PROFILER 0
+#endif
 #if LV_USE_PROFILER
     /** 1: Enable the built-in profiler */
     #define LV_USE_PROFILER_BUILTIN 1
     #if LV_USE_PROFILER_BUILTIN
-        /** Default profiler trace buffer size */
-        #define LV_PROFILER_BUILTIN_BUF_SIZE (16 * 1024)     /**< [bytes] */
+        /** Default profiler trace buffer size
+         *  The trace module empties it every loop(), so 8 kB (512 markers) is plenty and
+         *  leaves the rest of the LVGL heap to the UI. */
+        #define LV_PROFILER_BUILTIN_BUF_SIZE (8 * 1024)     /**< [bytes] */
         #define LV_PROFILER_BUILTIN_DEFAULT_ENABLE 1
         #define LV_USE_PROFILER_BUILTIN_POSIX 0 /**< Enable POSIX profiler port */
     #endif
 
     /** Header to include for profiler */
-    #define LV_PROFILER_INCLUDE "lvgl/src/misc/lv_profiler_builtin.h"
+    #define LV_PROFILER_INCLUDE "lv_profiler_builtin.h"
 
     /** Profiler start point function */
     #define LV_PROFILER_BEGIN    LV_PROFILER_BUILTIN_BEGIN
@@ -1115,7 +1177,7 @@
     #define LV_PROFILER_DECODER 1
 
     /*Enable font profiler*/
-    #define LV_PROFILER_FONT 1
+    #define LV_PROFILER_FONT 0     /*Off: a marker pair per glyph would flood the buffer*/
 
     /*Enable fs profiler*/
     #define LV_PROFILER_FS 1
@@ -1127,10 +1189,10 @@
     #define LV_PROFILER_TIMER 1
 
     /*Enable cache profiler*/
-    #define LV_PROFILER_CACHE 1
+    #define LV_PROFILER_CACHE 0    /*Off: a marker pair per cache lookup would flood the buffer*/
 
     /*Enable event profiler*/
-    #define LV_PROFILER_EVENT 1
+    #define LV_PROFILER_EVENT 0    /*Off: a marker pair per object event would flood the buffer*/
 #endif
 
 /** 1: Enable Monkey test */
@@ -1309,6 +1371,23 @@
 /** Interface for TFT_eSPI */
 #define LV_USE_TFT_ESPI         1
 
+#if LV_USE_TFT_ESPI
+    /** Don't send the tiles of a flushed area whose pixels didn't change. A 32-bit hash per
+     *  tile (4 bytes per tile in the LVGL heap) remembers what the panel shows. 0: disable*/
+    #ifndef LV_TFT_ESPI_TILE_DIFF
+        #define LV_TFT_ESPI_TILE_DIFF   1
+    #endif
+    #define LV_TFT_ESPI_TILE_W      16
+    #define LV_TFT_ESPI_TILE_H      8
+
+    /** Keep the SPI bus claimed from the first to the last area of a refresh and only resend the
+     *  column or row range of an address window when it changed. 0: one transaction and a full
+     *  address window per area*/
+    #ifndef LV_TFT_ESPI_BATCH_WRITES
+        #define LV_TFT_ESPI_BATCH_WRITES 1
+    #endif
+#endif
+
 /** Interface for Lovyan_GFX */
 #define LV_USE_LOVYAN_GFX         0
 
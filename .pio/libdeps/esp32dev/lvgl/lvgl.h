@@ -49,6 +49,7 @@ extern "C" {
 #include "src/display/lv_display.h"
 
 #include "src/font/lv_font.h"
+#include "src/misc/cache/instance/lv_glyph_cache.h"
 #include "src/font/lv_binfont_loader.h"
 #include "src/font/lv_font_fmt_txt.h"
 
@@ -127,6 +128,7 @@ extern "C" {
 #include "src/draw/lv_draw_buf.h"
 #include "src/draw/lv_draw_vector.h"
 #include "src/draw/sw/lv_draw_sw_utils.h"
+#include "src/draw/sw/lv_draw_sw_mask_cache.h"
 #include "src/draw/eve/lv_draw_eve_target.h"
 
 #include "src/themes/lv_theme.h"
@@ -21,6 +21,7 @@ extern "C" {
 #include "src/misc/cache/lv_cache.h"
 #include "src/misc/cache/lv_cache_entry_private.h"
 #include "src/misc/cache/lv_cache_private.h"
+#include "src/misc/cache/instance/lv_glyph_cache_private.h"
 #include "src/layouts/lv_layout_private.h"
 #include "src/stdlib/lv_mem_private.h"
 #include "src/others/file_explorer/lv_file_explorer_private.h"
@@ -43,6 +44,7 @@ extern "C" {
 #include "src/draw/lv_draw_mask_private.h"
 #include "src/draw/sw/lv_draw_sw_private.h"
 #include "src/draw/sw/lv_draw_sw_mask_private.h"
+#include "src/draw/sw/lv_draw_sw_mask_cache_private.h"
 #include "src/draw/sw/blend/lv_draw_sw_blend_private.h"
 #include "src/drivers/libinput/lv_xkb_private.h"
 #include "src/drivers/libinput/lv_libinput_private.h"
@@ -26,6 +26,7 @@ extern "C" {
 #include "../misc/lv_ll.h"
 #include "../misc/lv_log.h"
 #include "../misc/lv_style.h"
+#include "../misc/lv_text_private.h"
 #include "../misc/lv_timer.h"
 #include "../osal/lv_os_private.h"
 #include "../others/sysmon/lv_sysmon.h"
@@ -134,6 +135,13 @@ typedef struct _lv_global_t {
     lv_cache_t * img_cache;
     lv_cache_t * img_header_cache;
 
+#if LV_GLYPH_CACHE_SIZE > 0
+    lv_cache_t * glyph_cache;
+    lv_ll_t glyph_cache_pinned_ll;      /**< Entries held by `lv_glyph_cache_pin()`*/
+    uint32_t glyph_cache_hits;
+    uint32_t glyph_cache_misses;
+#endif
+
     lv_draw_global_info_t draw_info;
     lv_ll_t draw_sw_blend_handler_ll;
 #if defined(LV_DRAW_SW_SHADOW_CACHE_SIZE) && LV_DRAW_SW_SHADOW_CACHE_SIZE > 0
@@ -142,6 +150,11 @@ typedef struct _lv_global_t {
 #if LV_DRAW_SW_COMPLEX
     lv_draw_sw_mask_radius_circle_dsc_arr_t sw_circle_cache;
 #endif
+#if LV_USE_DRAW_SW && LV_DRAW_SW_COMPLEX && LV_DRAW_SW_MASK_CACHE_SIZE > 0
+    lv_cache_t * sw_mask_cache;
+    uint32_t sw_mask_cache_hits;
+    uint32_t sw_mask_cache_misses;
+#endif
 
 #if LV_USE_LOG
     lv_log_print_g_cb_t custom_log_print_cb;
@@ -211,6 +224,11 @@ typedef struct _lv_global_t {
     lv_font_fmt_rle_t font_fmt_rle;
 #endif
 
+#if LV_TEXT_ASCII_ADV_CACHE_CNT > 0
+    lv_text_ascii_adv_t text_ascii_adv[LV_TEXT_ASCII_ADV_CACHE_CNT];
+    lv_mutex_t text_ascii_adv_lock;     /**< Taken to build or drop a table*/
+#endif
+
 #if LV_USE_SPAN != 0
     struct _snippet_stack * span_snippet_stack;
 #endif
@@ -28,14 +28,38 @@
  *********************/
 #define _draw_info LV_GLOBAL_DEFAULT()->draw_info
 
+#define INDEX_GRID  8       /*Columns and rows of the task index*/
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_DRAW_TASK_INDEX
+typedef struct {
+    lv_draw_task_t ** tasks;    /*In the order they were added to the layer*/
+    uint32_t cnt;
+    uint32_t cap;
+} index_cell_t;
+
+typedef struct _lv_draw_task_index_t {
+    lv_area_t area;             /*`buf_area` of the layer*/
+    int32_t cell_w;
+    int32_t cell_h;
+    index_cell_t cells[INDEX_GRID * INDEX_GRID];
+} lv_draw_task_index_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static bool is_independent(lv_layer_t * layer, lv_draw_task_t * t_check, uint8_t draw_unit_id);
+static inline bool depends_on(const lv_draw_task_t * t_check, const lv_draw_task_t * t, uint8_t draw_unit_id);
+#if LV_DRAW_TASK_INDEX
+    static void task_index_build(lv_layer_t * layer);
+    static void task_index_free(lv_layer_t * layer);
+    static void task_index_insert(lv_layer_t * layer, lv_draw_task_t * t);
+    static void task_index_remove(lv_draw_task_index_t * index, lv_draw_task_t * t);
+    static bool is_independent_indexed(lv_draw_task_index_t * index, lv_draw_task_t * t_check, uint8_t draw_unit_id);
+#endif
 static void cleanup_task(lv_draw_task_t * t, lv_display_t * disp);
 static inline size_t get_draw_dsc_size(lv_draw_task_type_t type);
 static lv_draw_task_t * get_first_available_task(lv_layer_t * layer);
@@ -117,16 +141,29 @@ lv_draw_task_t * lv_draw_add_task(lv_layer_t * layer, const lv_area_t * coords,
     new_task->state = LV_DRAW_TASK_STATE_WAITING;
 
     /*Find the tail*/
+    uint32_t task_cnt = 1;
     if(layer->draw_task_head == NULL) {
         layer->draw_task_head = new_task;
     }
     else {
         lv_draw_task_t * tail = layer->draw_task_head;
-        while(tail->next) tail = tail->next;
+        task_cnt++;
+        while(tail->next) {
+            tail = tail->next;
+            task_cnt++;
+        }
 
         tail->next = new_task;
     }
 
+#if LV_DRAW_TASK_INDEX
+    new_task->seq = _draw_info.task_seq++;
+    if(layer->task_index) task_index_insert(layer, new_task);
+    else if(task_cnt == LV_DRAW_TASK_INDEX_MIN_TASKS) task_index_build(layer);
+#else
+    LV_UNUSED(task_cnt);
+#endif
+
     LV_PROFILER_DRAW_END;
     return new_task;
 }
@@ -137,6 +174,11 @@ void lv_draw_finalize_task_creation(lv_layer_t * layer, lv_draw_task_t * t)
     lv_draw_dsc_base_t * base_dsc = t->draw_dsc;
     base_dsc->layer = layer;
 
+#if LV_DRAW_TASK_INDEX
+    /*The real area of e.g. transformed images is set after the task was added*/
+    if(layer->task_index) task_index_insert(layer, t);
+#endif
+
     lv_draw_global_info_t * info = &_draw_info;
 
     /*Send LV_EVENT_DRAW_TASK_ADDED and dispatch only on the "main" draw_task
@@ -242,6 +284,9 @@ bool lv_draw_dispatch_layer(lv_display_t * disp, lv_layer_t * layer)
     while(t) {
         t_next = t->next;
         if(t->state == LV_DRAW_TASK_STATE_FINISHED) {
+#if LV_DRAW_TASK_INDEX
+            if(layer->task_index) task_index_remove(layer->task_index, t);
+#endif
             cleanup_task(t, disp);
             remove_task = true;
             if(t_prev != NULL)
@@ -255,6 +300,10 @@ bool lv_draw_dispatch_layer(lv_display_t * disp, lv_layer_t * layer)
         t = t_next;
     }
 
+#if LV_DRAW_TASK_INDEX
+    if(layer->draw_task_head == NULL && layer->task_index) task_index_free(layer);
+#endif
+
     bool task_dispatched = false;
 
     /*This layer is ready, enable blending its buffer*/
@@ -551,20 +600,19 @@ void lv_draw_task_get_area(const lv_draw_task_t * t, lv_area_t * area)
 static bool is_independent(lv_layer_t * layer, lv_draw_task_t * t_check, uint8_t draw_unit_id)
 {
     LV_PROFILER_DRAW_BEGIN;
+#if LV_DRAW_TASK_INDEX
+    if(layer->task_index && t_check->indexed) {
+        bool independent = is_independent_indexed(layer->task_index, t_check, draw_unit_id);
+        LV_PROFILER_DRAW_END;
+        return independent;
+    }
+#endif
+
     lv_draw_task_t * t = layer->draw_task_head;
 
     /*If t_check is outside of the older tasks then it's independent*/
     while(t && t != t_check) {
-        /*It's independent of finished draw tasks, and queued draw tasks of the same draw unit,
-         *so no need to check it*/
-        if(t->state == LV_DRAW_TASK_STATE_FINISHED ||
-           (t->state == LV_DRAW_TASK_STATE_QUEUED && t->preferred_draw_unit_id == draw_unit_id)) {
-            t = t->next;
-            continue;
-        }
-
-        lv_area_t a;
-        if(lv_area_intersect(&a, &t->_real_area, &t_check->_real_area)) {
+        if(depends_on(t_check, t, draw_unit_id)) {
             LV_PROFILER_DRAW_END;
             return false;
         }
@@ -575,6 +623,179 @@ static bool is_independent(lv_layer_t * layer, lv_draw_task_t * t_check, uint8_t
     return true;
 }
 
+/**
+ * Check if `t_check` has to wait for an older draw task
+ * @param t_check       the task to check
+ * @param t             a task added before `t_check`
+ * @param draw_unit_id  draw unit ID for which the independence check is called
+ * @return              true: `t` is still to be drawn and overlaps `t_check`
+ */
+static inline bool depends_on(const lv_draw_task_t * t_check, const lv_draw_task_t * t, uint8_t draw_unit_id)
+{
+    /*It's independent of finished draw tasks, and queued draw tasks of the same draw unit,
+     *so no need to check it*/
+    if(t->state == LV_DRAW_TASK_STATE_FINISHED ||
+       (t->state == LV_DRAW_TASK_STATE_QUEUED && t->preferred_draw_unit_id == draw_unit_id)) {
+        return false;
+    }
+
+    lv_area_t a;
+    return lv_area_intersect(&a, &t->_real_area, &t_check->_real_area);
+}
+
+#if LV_DRAW_TASK_INDEX
+
+/*The task index splits the layer into INDEX_GRID x INDEX_GRID cells and lists every task in the
+ *cells its real area touches, in the order the tasks were added. Areas outside the layer are
+ *clamped to the border cells, so overlapping tasks always share a cell. A task can only depend
+ *on the older tasks listed before it in its own cells.*/
+
+static void get_cells(const lv_draw_task_index_t * index, const lv_area_t * a, uint8_t * cells)
+{
+    cells[0] = (uint8_t)LV_CLAMP(0, (a->x1 - index->area.x1) / index->cell_w, INDEX_GRID - 1);
+    cells[1] = (uint8_t)LV_CLAMP(0, (a->y1 - index->area.y1) / index->cell_h, INDEX_GRID - 1);
+    cells[2] = (uint8_t)LV_CLAMP(0, (a->x2 - index->area.x1) / index->cell_w, INDEX_GRID - 1);
+    cells[3] = (uint8_t)LV_CLAMP(0, (a->y2 - index->area.y1) / index->cell_h, INDEX_GRID - 1);
+}
+
+/**
+ * Build the index of the draw tasks already in the layer
+ * @param layer     pointer to a layer
+ */
+static void task_index_build(lv_layer_t * layer)
+{
+    int32_t w = lv_area_get_width(&layer->buf_area);
+    int32_t h = lv_area_get_height(&layer->buf_area);
+    if(w <= 0 || h <= 0) return;
+
+    lv_draw_task_index_t * index = lv_malloc_zeroed(sizeof(lv_draw_task_index_t));
+    if(index == NULL) return;
+    index->area = layer->buf_area;
+    index->cell_w = (w + INDEX_GRID - 1) / INDEX_GRID;
+    index->cell_h = (h + INDEX_GRID - 1) / INDEX_GRID;
+    layer->task_index = index;
+
+    lv_draw_task_t * t = layer->draw_task_head;
+    while(t && layer->task_index) {
+        task_index_insert(layer, t);
+        t = t->next;
+    }
+}
+
+/**
+ * Free the index of a layer. The dependency checks go through the task list again.
+ * @param layer     pointer to a layer with an index
+ */
+static void task_index_free(lv_layer_t * layer)
+{
+    lv_draw_task_index_t * index = layer->task_index;
+    uint32_t i;
+    for(i = 0; i < INDEX_GRID * INDEX_GRID; i++) lv_free(index->cells[i].tasks);
+    lv_free(index);
+    layer->task_index = NULL;
+
+    lv_draw_task_t * t;
+    for(t = layer->draw_task_head; t; t = t->next) t->indexed = false;
+}
+
+/**
+ * List a task in the cells of its real area. A task that is listed already is moved if its
+ * area now touches other cells. Frees the whole index if there is no memory for it.
+ * @param layer     pointer to the layer of the task, with an index
+ * @param t         pointer to a draw task
+ */
+static void task_index_insert(lv_layer_t * layer, lv_draw_task_t * t)
+{
+    lv_draw_task_index_t * index = layer->task_index;
+    uint8_t cells[4];
+    get_cells(index, &t->_real_area, cells);
+    if(t->indexed) {
+        if(lv_memcmp(cells, t->index_cells, sizeof(cells)) == 0) return;
+        task_index_remove(index, t);
+    }
+
+    int32_t x, y;
+    for(y = cells[1]; y <= cells[3]; y++) {
+        for(x = cells[0]; x <= cells[2]; x++) {
+            index_cell_t * cell = &index->cells[y * INDEX_GRID + x];
+            if(cell->cnt == cell->cap) {
+                uint32_t cap = cell->cap ? cell->cap * 2 : 8;
+                lv_draw_task_t ** tasks = lv_realloc(cell->tasks, cap * sizeof(lv_draw_task_t *));
+                if(tasks == NULL) {
+                    LV_LOG_WARN("no memory for the draw task index, checking the task list instead");
+                    task_index_free(layer);
+                    return;
+                }
+                cell->tasks = tasks;
+                cell->cap = cap;
+            }
+
+            /*Nearly always the newest task, which goes to the end*/
+            uint32_t i = cell->cnt;
+            while(i > 0 && (int32_t)(cell->tasks[i - 1]->seq - t->seq) > 0) {
+                cell->tasks[i] = cell->tasks[i - 1];
+                i--;
+            }
+            cell->tasks[i] = t;
+            cell->cnt++;
+        }
+    }
+
+    lv_memcpy(t->index_cells, cells, sizeof(cells));
+    t->indexed = true;
+}
+
+/**
+ * Remove a task from the cells it's listed in
+ * @param index     pointer to the index of the task's layer
+ * @param t         pointer to a draw task
+ */
+static void task_index_remove(lv_draw_task_index_t * index, lv_draw_task_t * t)
+{
+    if(!t->indexed) return;
+
+    const uint8_t * cells = t->index_cells;
+    int32_t x, y;
+    for(y = cells[1]; y <= cells[3]; y++) {
+        for(x = cells[0]; x <= cells[2]; x++) {
+            index_cell_t * cell = &index->cells[y * INDEX_GRID + x];
+            uint32_t i;
+            /*Older tasks finish first, so it's usually near the start*/
+            for(i = 0; i < cell->cnt; i++) {
+                if(cell->tasks[i] == t) {
+                    lv_memmove(&cell->tasks[i], &cell->tasks[i + 1], (cell->cnt - i - 1) * sizeof(lv_draw_task_t *));
+                    cell->cnt--;
+                    break;
+                }
+            }
+        }
+    }
+    t->indexed = false;
+}
+
+/**
+ * Same as `is_independent()`, but only test the older tasks that share a cell with `t_check`
+ */
+static bool is_independent_indexed(lv_draw_task_index_t * index, lv_draw_task_t * t_check, uint8_t draw_unit_id)
+{
+    const uint8_t * cells = t_check->index_cells;
+    int32_t x, y;
+    for(y = cells[1]; y <= cells[3]; y++) {
+        for(x = cells[0]; x <= cells[2]; x++) {
+            const index_cell_t * cell = &index->cells[y * INDEX_GRID + x];
+            uint32_t i;
+            for(i = 0; i < cell->cnt; i++) {
+                const lv_draw_task_t * t = cell->tasks[i];
+                if(t == t_check) break;     /*The rest are newer*/
+                if(depends_on(t_check, t, draw_unit_id)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+#endif /*LV_DRAW_TASK_INDEX*/
+
 /**
  * Get the size of the draw descriptor of a draw task
  * @param type      type of the draw task
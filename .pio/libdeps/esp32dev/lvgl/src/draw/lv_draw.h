@@ -143,6 +143,11 @@ struct _lv_layer_t  {
 
     /** Opacity of the layer */
     lv_opa_t opa;
+
+#if LV_DRAW_TASK_INDEX
+    /** Grid of the draw tasks for the dependency checks. NULL: not built*/
+    struct _lv_draw_task_index_t * task_index;
+#endif
 };
 
 typedef struct {
@@ -84,6 +84,14 @@ struct _lv_draw_task_t {
      */
     uint8_t preference_score;
 
+#if LV_DRAW_TASK_INDEX
+    /** Order in which the tasks were added, for the dependency checks with the grid*/
+    uint32_t seq;
+
+    /** First and last column and row of the grid cells the task is listed in*/
+    uint8_t index_cells[4];
+    bool indexed;
+#endif
 };
 
 struct _lv_draw_mask_t {
@@ -193,6 +201,9 @@ typedef struct {
 #endif
     lv_mutex_t circle_cache_mutex;
     bool task_running;
+#if LV_DRAW_TASK_INDEX
+    uint32_t task_seq;
+#endif
 } lv_draw_global_info_t;
 
 /**********************
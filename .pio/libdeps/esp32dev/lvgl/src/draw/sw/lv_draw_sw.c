@@ -7,6 +7,7 @@
  *      INCLUDES
  *********************/
 #include "lv_draw_sw_private.h"
+#include "lv_draw_sw_mask_cache.h"
 #include "../lv_draw_private.h"
 #if LV_USE_DRAW_SW
 
@@ -77,6 +78,9 @@ void lv_draw_sw_init(void)
 
 #if LV_DRAW_SW_COMPLEX == 1
     lv_draw_sw_mask_init();
+#if LV_DRAW_SW_MASK_CACHE_SIZE > 0
+    lv_draw_sw_mask_cache_init(LV_DRAW_SW_MASK_CACHE_SIZE);
+#endif
 #endif
 
     lv_draw_sw_unit_t * draw_sw_unit = lv_draw_create_unit(sizeof(lv_draw_sw_unit_t));
@@ -119,6 +123,9 @@ void lv_draw_sw_deinit(void)
 #endif
 
 #if LV_DRAW_SW_COMPLEX == 1
+#if LV_DRAW_SW_MASK_CACHE_SIZE > 0
+    lv_draw_sw_mask_cache_deinit();
+#endif
     lv_draw_sw_mask_deinit();
 #endif
 }
@@ -8,6 +8,7 @@
  *********************/
 #include "../../misc/lv_area_private.h"
 #include "lv_draw_sw_mask_private.h"
+#include "lv_draw_sw_mask_cache_private.h"
 #include "../lv_draw_private.h"
 #include "lv_draw_sw.h"
 #if LV_USE_DRAW_SW
@@ -42,6 +43,9 @@
 static void /* LV_ATTRIBUTE_FAST_MEM */ shadow_draw_corner_buf(const lv_area_t * coords, uint16_t * sh_buf, int32_t s,
                                                                int32_t r);
 static void /* LV_ATTRIBUTE_FAST_MEM */ shadow_blur_corner(int32_t size, int32_t sw, uint16_t * sh_ups_buf);
+#if LV_DRAW_SW_MASK_CACHE_SIZE > 0
+    static bool shadow_cache_render_cb(lv_draw_sw_mask_cache_data_t * data);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -99,7 +103,31 @@ void lv_draw_sw_box_shadow(lv_draw_task_t * t, const lv_draw_box_shadow_dsc_t *
 
     lv_opa_t * sh_buf;
 
-#if LV_DRAW_SW_SHADOW_CACHE_SIZE
+#if LV_DRAW_SW_MASK_CACHE_SIZE > 0
+    /*The corner is mirrored in place below, so work on a copy of the cached one*/
+    lv_draw_sw_mask_cache_data_t key;
+    lv_memzero(&key, sizeof(key));
+    key.slot.size = corner_size * corner_size;
+    key.type = LV_DRAW_SW_MASK_CACHE_SHADOW;
+    key.w = lv_area_get_width(coords);
+    key.h = lv_area_get_height(coords);
+    key.radius = r_sh;
+    key.spread = dsc->spread;
+    key.blur = dsc->width;
+    lv_cache_entry_t * entry = lv_draw_sw_mask_cache_acquire(&key, shadow_cache_render_cb);
+    if(entry) {
+        lv_draw_sw_mask_cache_data_t * data = lv_cache_entry_get_data(entry);
+        sh_buf = lv_malloc(corner_size * corner_size);
+        LV_ASSERT_MALLOC(sh_buf);
+        lv_memcpy(sh_buf, data->buf, corner_size * corner_size);
+        lv_draw_sw_mask_cache_release(entry);
+    }
+    else {
+        sh_buf = lv_malloc(corner_size * corner_size * sizeof(uint16_t));
+        LV_ASSERT_MALLOC(sh_buf);
+        shadow_draw_corner_buf(&core_area, (uint16_t *)sh_buf, dsc->width, r_sh);
+    }
+#elif LV_DRAW_SW_SHADOW_CACHE_SIZE
     lv_draw_sw_shadow_cache_t * cache = &shadow_cache;
     if(cache->cache_size == corner_size && cache->cache_r == r_sh) {
         /*Use the cache if available*/
@@ -124,7 +152,7 @@ void lv_draw_sw_box_shadow(lv_draw_task_t * t, const lv_draw_box_shadow_dsc_t *
     sh_buf = lv_malloc(corner_size * corner_size * sizeof(uint16_t));
     LV_ASSERT_MALLOC(sh_buf);
     shadow_draw_corner_buf(&core_area, (uint16_t *)sh_buf, dsc->width, r_sh);
-#endif /*LV_DRAW_SW_SHADOW_CACHE_SIZE*/
+#endif /*LV_DRAW_SW_MASK_CACHE_SIZE*/
 
     /*Skip a lot of masking if the background will cover the shadow that would be masked out*/
     bool simple = dsc->bg_cover;
@@ -730,6 +758,29 @@ static void LV_ATTRIBUTE_FAST_MEM shadow_blur_corner(int32_t size, int32_t sw, u
     lv_free(sh_ups_blur_buf);
 }
 
+#if LV_DRAW_SW_MASK_CACHE_SIZE > 0
+/**
+ * Render a shadow corner for the mask cache. Only the size of the core area
+ * matters, not its position.
+ * @param data  the key of the corner and its `buf` to render to
+ * @return      false if the temporary buffer couldn't be allocated
+ */
+static bool shadow_cache_render_cb(lv_draw_sw_mask_cache_data_t * data)
+{
+    lv_area_t core_area;
+    lv_area_set(&core_area, 0, 0, data->w + 2 * data->spread - 1, data->h + 2 * data->spread - 1);
+
+    /*The calculation needs 16 bits per pixel*/
+    uint16_t * tmp_buf = lv_malloc(data->slot.size * sizeof(uint16_t));
+    if(tmp_buf == NULL) return false;
+
+    shadow_draw_corner_buf(&core_area, tmp_buf, data->blur, data->radius);
+    lv_memcpy(data->buf, tmp_buf, data->slot.size);
+    lv_free(tmp_buf);
+    return true;
+}
+#endif /*LV_DRAW_SW_MASK_CACHE_SIZE > 0*/
+
 #else /*LV_DRAW_SW_COMPLEX*/
 
 void lv_draw_sw_box_shadow(lv_draw_task_t * t, const lv_draw_box_shadow_dsc_t * dsc, const lv_area_t * coords)
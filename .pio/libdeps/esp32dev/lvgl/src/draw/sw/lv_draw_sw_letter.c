@@ -23,16 +23,22 @@
 #include "../../display/lv_display.h"
 #include "../../misc/lv_math.h"
 #include "../../misc/lv_assert.h"
-#include "../../misc/lv_area.h"
+#include "../../misc/lv_area_private.h"
 #include "../../misc/lv_style.h"
 #include "../../font/lv_font.h"
+#include "../../font/lv_font_fmt_txt.h"
 #include "../../core/lv_refr_private.h"
 #include "../../stdlib/lv_string.h"
+#include "../../misc/cache/lv_cache.h"
+#include "../../misc/cache/instance/lv_glyph_cache_private.h"
 
 /*********************
  *      DEFINES
  *********************/
 
+/*RGB565 spread over 32 bits as G:R:B with gaps, see `lv_color_16_16_mix()`*/
+#define RGB565_SPLIT_MASK   0x07E0F81Fu
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -53,6 +59,10 @@ typedef struct {
 static void /* LV_ATTRIBUTE_FAST_MEM */ draw_letter_cb(lv_draw_task_t * t, lv_draw_glyph_dsc_t * glyph_draw_dsc,
                                                        lv_draw_fill_dsc_t * fill_draw_dsc, const lv_area_t * fill_area);
 
+#if LV_DRAW_SW_GLYPH_A4_DIRECT && LV_DRAW_SW_SUPPORT_RGB565
+    static bool draw_a4_glyph_rgb565(lv_draw_task_t * t, lv_draw_glyph_dsc_t * glyph_draw_dsc);
+#endif
+
 #if LV_USE_FREETYPE && LV_USE_VECTOR_GRAPHIC && LV_USE_THORVG
 
     static void freetype_outline_event_cb(lv_event_t * e);
@@ -151,6 +161,9 @@ static void LV_ATTRIBUTE_FAST_MEM draw_letter_cb(lv_draw_task_t * t, lv_draw_gly
             case LV_FONT_GLYPH_FORMAT_A8:
             case LV_FONT_GLYPH_FORMAT_IMAGE: {
                     if(glyph_draw_dsc->rotation % 3600 == 0 && glyph_draw_dsc->format != LV_FONT_GLYPH_FORMAT_IMAGE) {
+#if LV_DRAW_SW_GLYPH_A4_DIRECT && LV_DRAW_SW_SUPPORT_RGB565
+                        if(draw_a4_glyph_rgb565(t, glyph_draw_dsc)) break;
+#endif
                         lv_area_t mask_area = *glyph_draw_dsc->letter_coords;
 
                         if(lv_font_has_static_bitmap(glyph_draw_dsc->g->resolved_font) &&
@@ -169,10 +182,26 @@ static void LV_ATTRIBUTE_FAST_MEM draw_letter_cb(lv_draw_task_t * t, lv_draw_gly
                             lv_draw_sw_blend(t, &blend_dsc);
                         }
                         else {
-                            glyph_draw_dsc->glyph_data = lv_font_get_glyph_bitmap(glyph_draw_dsc->g, glyph_draw_dsc->_draw_buf);
-                            if(glyph_draw_dsc->glyph_data == NULL) {
-                                LV_LOG_WARN("Couldn't get the bitmap of a glyph");
-                                break;
+                            const uint8_t * mask_buf;
+                            uint32_t mask_stride;
+#if LV_GLYPH_CACHE_SIZE > 0
+                            lv_cache_entry_t * cache_entry = lv_glyph_cache_acquire(glyph_draw_dsc->g);
+                            if(cache_entry) {
+                                const lv_glyph_cache_data_t * cached = lv_cache_entry_get_data(cache_entry);
+                                mask_buf = cached->bitmap;
+                                mask_stride = cached->stride;
+                            }
+                            else
+#endif
+                            {
+                                glyph_draw_dsc->glyph_data = lv_font_get_glyph_bitmap(glyph_draw_dsc->g, glyph_draw_dsc->_draw_buf);
+                                if(glyph_draw_dsc->glyph_data == NULL) {
+                                    LV_LOG_WARN("Couldn't get the bitmap of a glyph");
+                                    break;
+                                }
+                                const lv_draw_buf_t * draw_buf = glyph_draw_dsc->glyph_data;
+                                mask_buf = draw_buf->data;
+                                mask_stride = draw_buf->header.stride;
                             }
 
                             mask_area.x2 = mask_area.x1 + lv_draw_buf_width_to_stride(lv_area_get_width(&mask_area), LV_COLOR_FORMAT_A8) - 1;
@@ -180,13 +209,15 @@ static void LV_ATTRIBUTE_FAST_MEM draw_letter_cb(lv_draw_task_t * t, lv_draw_gly
                             lv_memzero(&blend_dsc, sizeof(blend_dsc));
                             blend_dsc.color = glyph_draw_dsc->color;
                             blend_dsc.opa = glyph_draw_dsc->opa;
-                            const lv_draw_buf_t * draw_buf = glyph_draw_dsc->glyph_data;
-                            blend_dsc.mask_buf = draw_buf->data;
+                            blend_dsc.mask_buf = mask_buf;
                             blend_dsc.mask_area = &mask_area;
-                            blend_dsc.mask_stride = draw_buf->header.stride;
+                            blend_dsc.mask_stride = mask_stride;
                             blend_dsc.blend_area = glyph_draw_dsc->letter_coords;
                             blend_dsc.mask_res = LV_DRAW_SW_MASK_RES_CHANGED;
                             lv_draw_sw_blend(t, &blend_dsc);
+#if LV_GLYPH_CACHE_SIZE > 0
+                            if(cache_entry) lv_glyph_cache_release(cache_entry);
+#endif
                         }
                     }
                     else {
@@ -224,6 +255,105 @@ static void LV_ATTRIBUTE_FAST_MEM draw_letter_cb(lv_draw_task_t * t, lv_draw_gly
     }
 }
 
+#if LV_DRAW_SW_GLYPH_A4_DIRECT && LV_DRAW_SW_SUPPORT_RGB565
+
+static inline void LV_ATTRIBUTE_FAST_MEM blend_a4_pixel(uint16_t * dest, uint16_t color16, uint32_t fg,
+                                                        uint32_t weight)
+{
+    if(weight == 0) return;
+    if(weight == 32) {
+        *dest = color16;
+        return;
+    }
+
+    uint32_t bg = ((uint32_t)*dest | ((uint32_t)*dest << 16)) & RGB565_SPLIT_MASK;
+    uint32_t res = ((((fg - bg) * weight) >> 5) + bg) & RGB565_SPLIT_MASK;
+    *dest = (uint16_t)((res >> 16) | res);
+}
+
+/**
+ * Blend a plain 4 bpp glyph of a built-in font straight from the font's bitmap
+ * into an RGB565 layer, clipped to the draw task's area. Each nibble is turned
+ * into a 0..32 blend weight by a 16 entry table, so the glyph is never unpacked
+ * into the A8 draw buffer and read back. The result is the same as unpacking
+ * and calling `lv_draw_sw_blend()`.
+ * @param t                 the draw task
+ * @param glyph_draw_dsc    the glyph to draw
+ * @return                  false if the glyph or the layer is not supported (nothing was drawn)
+ */
+static bool LV_ATTRIBUTE_FAST_MEM draw_a4_glyph_rgb565(lv_draw_task_t * t, lv_draw_glyph_dsc_t * glyph_draw_dsc)
+{
+    lv_font_glyph_dsc_t * g = glyph_draw_dsc->g;
+    const lv_font_t * font = g->resolved_font;
+    lv_layer_t * layer = t->target_layer;
+
+    if(glyph_draw_dsc->format != LV_FONT_GLYPH_FORMAT_A4) return false;
+    if(font->get_glyph_bitmap != lv_font_get_bitmap_fmt_txt) return false;
+    if(((const lv_font_fmt_txt_dsc_t *)font->dsc)->bitmap_format != LV_FONT_FMT_TXT_PLAIN) return false;
+    if(layer->color_format != LV_COLOR_FORMAT_RGB565) return false;
+    if(lv_draw_sw_get_blend_handler(layer->color_format)) return false;
+
+    lv_opa_t opa = glyph_draw_dsc->opa;
+    if(opa <= LV_OPA_MIN) return true;
+
+    lv_area_t clip;
+    const lv_area_t * letter = glyph_draw_dsc->letter_coords;
+    if(!lv_area_intersect(&clip, letter, &t->clip_area)) return true;
+
+    const uint8_t save_req = g->req_raw_bitmap;
+    g->req_raw_bitmap = 1;
+    const uint8_t * bitmap = lv_font_get_bitmap_fmt_txt(g, NULL);
+    g->req_raw_bitmap = save_req;
+    if(bitmap == NULL) return false;
+
+    /*Same mask values as the A8 unpacker (n * 17), mixed with the opacity as the blender would*/
+    uint8_t weight[16];
+    uint32_t i;
+    for(i = 0; i < 16; i++) {
+        lv_opa_t a = (lv_opa_t)(i * 17);
+        if(opa < LV_OPA_MAX) a = LV_OPA_MIX2(a, opa);
+        weight[i] = (uint8_t)((a + 4) >> 3);
+    }
+
+    uint16_t color16 = lv_color_to_u16(glyph_draw_dsc->color);
+    uint32_t fg = ((uint32_t)color16 | ((uint32_t)color16 << 16)) & RGB565_SPLIT_MASK;
+
+    /*Without a stride the rows follow each other without padding, even mid-byte*/
+    uint32_t row_nibbles = g->stride ? g->stride * 2 : g->box_w;
+    uint32_t nibble = (clip.y1 - letter->y1) * row_nibbles + (clip.x1 - letter->x1);
+    int32_t w = lv_area_get_width(&clip);
+    int32_t h = lv_area_get_height(&clip);
+    uint32_t dest_stride = layer->draw_buf->header.stride;
+    uint16_t * dest = lv_draw_layer_go_to_xy(layer, clip.x1 - layer->buf_area.x1, clip.y1 - layer->buf_area.y1);
+
+    int32_t y;
+    for(y = 0; y < h; y++) {
+        const uint8_t * src = bitmap + (nibble >> 1);
+        int32_t x = 0;
+        if(nibble & 1) {
+            blend_a4_pixel(&dest[0], color16, fg, weight[*src & 0xF]);
+            src++;
+            x = 1;
+        }
+
+        for(; x < w - 1; x += 2, src++) {
+            uint8_t px2 = *src;
+            if(px2 == 0x00) continue;
+            blend_a4_pixel(&dest[x], color16, fg, weight[px2 >> 4]);
+            blend_a4_pixel(&dest[x + 1], color16, fg, weight[px2 & 0xF]);
+        }
+
+        if(x < w) blend_a4_pixel(&dest[x], color16, fg, weight[*src >> 4]);
+
+        nibble += row_nibbles;
+        dest = (uint16_t *)((uint8_t *)dest + dest_stride);
+    }
+
+    return true;
+}
+
+#endif /*LV_DRAW_SW_GLYPH_A4_DIRECT && LV_DRAW_SW_SUPPORT_RGB565*/
+
 #if LV_USE_FREETYPE && LV_USE_VECTOR_GRAPHIC && LV_USE_THORVG
 
 /*
@@ -0,0 +1,170 @@
+/**
+ * @file lv_draw_sw_mask_cache.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lv_draw_sw_mask_cache_private.h"
+
+#if LV_USE_DRAW_SW && LV_DRAW_SW_COMPLEX && LV_DRAW_SW_MASK_CACHE_SIZE > 0
+
+#include "../../misc/lv_assert.h"
+#include "../../core/lv_global.h"
+#include "../../stdlib/lv_string.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#define CACHE_NAME  "SW_MASK"
+
+#define mask_cache_p (LV_GLOBAL_DEFAULT()->sw_mask_cache)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static lv_cache_compare_res_t mask_cache_compare_cb(const lv_draw_sw_mask_cache_data_t * lhs,
+                                                    const lv_draw_sw_mask_cache_data_t * rhs);
+static bool mask_cache_create_cb(lv_draw_sw_mask_cache_data_t * data, void * user_data);
+static void mask_cache_free_cb(lv_draw_sw_mask_cache_data_t * data, void * user_data);
+
+/**********************
+ *  GLOBAL VARIABLES
+ **********************/
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_result_t lv_draw_sw_mask_cache_init(uint32_t size)
+{
+    if(mask_cache_p != NULL) {
+        return LV_RESULT_OK;
+    }
+
+    mask_cache_p = lv_cache_create(&lv_cache_class_lru_rb_size,
+    sizeof(lv_draw_sw_mask_cache_data_t), size, (lv_cache_ops_t) {
+        .compare_cb = (lv_cache_compare_cb_t) mask_cache_compare_cb,
+        .create_cb = (lv_cache_create_cb_t) mask_cache_create_cb,
+        .free_cb = (lv_cache_free_cb_t) mask_cache_free_cb,
+    });
+
+    if(mask_cache_p == NULL) return LV_RESULT_INVALID;
+    lv_cache_set_name(mask_cache_p, CACHE_NAME);
+    return LV_RESULT_OK;
+}
+
+void lv_draw_sw_mask_cache_deinit(void)
+{
+    if(mask_cache_p == NULL) return;
+
+    lv_cache_destroy(mask_cache_p, NULL);
+    mask_cache_p = NULL;
+}
+
+void lv_draw_sw_mask_cache_resize(uint32_t size, bool evict_now)
+{
+    if(mask_cache_p == NULL) return;
+
+    lv_cache_set_max_size(mask_cache_p, size, NULL);
+    if(evict_now) {
+        while(lv_cache_get_size(mask_cache_p, NULL) > size && lv_cache_evict_one(mask_cache_p, NULL)) {}
+    }
+}
+
+lv_cache_entry_t * lv_draw_sw_mask_cache_acquire(const lv_draw_sw_mask_cache_data_t * key,
+                                                 lv_draw_sw_mask_cache_render_cb_t render_cb)
+{
+    if(mask_cache_p == NULL) return NULL;
+    if(key->slot.size == 0 || key->slot.size > lv_cache_get_max_size(mask_cache_p, NULL)) return NULL;
+
+    lv_cache_entry_t * entry = lv_cache_acquire(mask_cache_p, key, NULL);
+    if(entry) {
+        LV_GLOBAL_DEFAULT()->sw_mask_cache_hits++;
+        return entry;
+    }
+
+    LV_GLOBAL_DEFAULT()->sw_mask_cache_misses++;
+    return lv_cache_acquire_or_create(mask_cache_p, key, &render_cb);
+}
+
+void lv_draw_sw_mask_cache_release(lv_cache_entry_t * entry)
+{
+    lv_cache_release(mask_cache_p, entry, NULL);
+}
+
+void lv_draw_sw_mask_cache_get_stats(lv_draw_sw_mask_cache_stats_t * stats)
+{
+    LV_ASSERT_NULL(stats);
+    lv_memzero(stats, sizeof(*stats));
+    if(mask_cache_p == NULL) return;
+
+    stats->hits = LV_GLOBAL_DEFAULT()->sw_mask_cache_hits;
+    stats->misses = LV_GLOBAL_DEFAULT()->sw_mask_cache_misses;
+    stats->size = lv_cache_get_size(mask_cache_p, NULL);
+    stats->max_size = lv_cache_get_max_size(mask_cache_p, NULL);
+}
+
+void lv_draw_sw_mask_cache_reset_stats(void)
+{
+    LV_GLOBAL_DEFAULT()->sw_mask_cache_hits = 0;
+    LV_GLOBAL_DEFAULT()->sw_mask_cache_misses = 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static lv_cache_compare_res_t mask_cache_compare_cb(const lv_draw_sw_mask_cache_data_t * lhs,
+                                                    const lv_draw_sw_mask_cache_data_t * rhs)
+{
+    if(lhs->type != rhs->type) return lhs->type > rhs->type ? 1 : -1;
+    if(lhs->w != rhs->w) return lhs->w > rhs->w ? 1 : -1;
+    if(lhs->h != rhs->h) return lhs->h > rhs->h ? 1 : -1;
+    if(lhs->radius != rhs->radius) return lhs->radius > rhs->radius ? 1 : -1;
+    if(lhs->spread != rhs->spread) return lhs->spread > rhs->spread ? 1 : -1;
+    if(lhs->blur != rhs->blur) return lhs->blur > rhs->blur ? 1 : -1;
+    return 0;
+}
+
+static bool mask_cache_create_cb(lv_draw_sw_mask_cache_data_t * data, void * user_data)
+{
+    lv_draw_sw_mask_cache_render_cb_t render_cb = *(lv_draw_sw_mask_cache_render_cb_t *)user_data;
+
+    data->buf = lv_malloc(data->slot.size);
+    if(data->buf == NULL) return false;
+
+    if(!render_cb(data)) {
+        lv_free(data->buf);
+        data->buf = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+static void mask_cache_free_cb(lv_draw_sw_mask_cache_data_t * data, void * user_data)
+{
+    LV_UNUSED(user_data);
+
+    lv_free(data->buf);
+    data->buf = NULL;
+}
+
+#endif /*LV_USE_DRAW_SW && LV_DRAW_SW_COMPLEX && LV_DRAW_SW_MASK_CACHE_SIZE > 0*/
@@ -0,0 +1,82 @@
+/**
+ * @file lv_draw_sw_mask_cache.h
+ *
+ */
+
+#ifndef LV_DRAW_SW_MASK_CACHE_H
+#define LV_DRAW_SW_MASK_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lv_conf_internal.h"
+#include "../../misc/lv_types.h"
+
+#if LV_USE_DRAW_SW && LV_DRAW_SW_COMPLEX && LV_DRAW_SW_MASK_CACHE_SIZE > 0
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    uint32_t hits;                  /**< Masks served from the cache*/
+    uint32_t misses;                /**< Masks that had to be rendered*/
+    uint32_t size;                  /**< Bytes in use*/
+    uint32_t max_size;              /**< Byte budget*/
+} lv_draw_sw_mask_cache_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the cache of blurred shadow corners and rounded-rectangle corner masks.
+ * Called by `lv_draw_sw_init()` with `LV_DRAW_SW_MASK_CACHE_SIZE`.
+ * @param size      byte budget for the masks
+ * @return          LV_RESULT_OK: initialization succeeded, LV_RESULT_INVALID: failed.
+ */
+lv_result_t lv_draw_sw_mask_cache_init(uint32_t size);
+
+/**
+ * Free the mask cache.
+ */
+void lv_draw_sw_mask_cache_deinit(void);
+
+/**
+ * Change the byte budget of the mask cache. If set to 0, nothing new is cached.
+ * @param size      new byte budget
+ * @param evict_now true: evict least recently used masks now, false: on the next insertion
+ */
+void lv_draw_sw_mask_cache_resize(uint32_t size, bool evict_now);
+
+/**
+ * Get the hit/miss counters and the memory usage of the mask cache.
+ * @param stats     store the statistics here
+ */
+void lv_draw_sw_mask_cache_get_stats(lv_draw_sw_mask_cache_stats_t * stats);
+
+/**
+ * Reset the hit and miss counters.
+ */
+void lv_draw_sw_mask_cache_reset_stats(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_DRAW_SW && LV_DRAW_SW_COMPLEX && LV_DRAW_SW_MASK_CACHE_SIZE > 0*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_SW_MASK_CACHE_H*/
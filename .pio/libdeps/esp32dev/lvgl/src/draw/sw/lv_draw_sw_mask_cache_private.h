@@ -0,0 +1,79 @@
+/**
+ * @file lv_draw_sw_mask_cache_private.h
+ *
+ */
+
+#ifndef LV_DRAW_SW_MASK_CACHE_PRIVATE_H
+#define LV_DRAW_SW_MASK_CACHE_PRIVATE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../misc/cache/lv_cache_private.h"
+#include "lv_draw_sw_mask_cache.h"
+
+#if LV_USE_DRAW_SW && LV_DRAW_SW_COMPLEX && LV_DRAW_SW_MASK_CACHE_SIZE > 0
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef enum {
+    LV_DRAW_SW_MASK_CACHE_SHADOW,   /**< Blurred top right corner of a box shadow, `size x size`*/
+    LV_DRAW_SW_MASK_CACHE_CORNERS,  /**< The four `r x r` corners of a rounded rectangle mask*/
+} lv_draw_sw_mask_cache_type_t;
+
+/** A rendered A8 mask. The key is everything but `buf`: only the size and shape matter,
+ *  not the position.*/
+typedef struct {
+    lv_cache_slot_size_t slot;      /**< Bytes of `buf`, counted against the cache size*/
+
+    lv_draw_sw_mask_cache_type_t type;
+    int32_t w;                      /**< Size of the object, 0 for corner masks*/
+    int32_t h;
+    int32_t radius;                 /**< Radius after clamping to the short side*/
+    int32_t spread;                 /**< Shadow spread, 0 for corner masks*/
+    int32_t blur;                   /**< Shadow width, 0 for corner masks*/
+
+    uint8_t * buf;
+} lv_draw_sw_mask_cache_data_t;
+
+/**
+ * Render the mask of `data` into `data->buf` (`data->slot.size` bytes).
+ * @return      false on failure
+ */
+typedef bool (*lv_draw_sw_mask_cache_render_cb_t)(lv_draw_sw_mask_cache_data_t * data);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Get a mask from the cache, rendering it with `render_cb` on a miss.
+ * Release the entry with `lv_draw_sw_mask_cache_release()` after drawing.
+ * @param key       the mask to get with `slot.size` set and `buf` unused
+ * @param render_cb renders the mask on a miss
+ * @return          the cache entry holding an `lv_draw_sw_mask_cache_data_t`,
+ *                  or NULL if the mask can't be cached (disabled, doesn't fit)
+ */
+lv_cache_entry_t * lv_draw_sw_mask_cache_acquire(const lv_draw_sw_mask_cache_data_t * key,
+                                                 lv_draw_sw_mask_cache_render_cb_t render_cb);
+
+/**
+ * Release an entry returned by `lv_draw_sw_mask_cache_acquire()`.
+ * @param entry the cache entry
+ */
+void lv_draw_sw_mask_cache_release(lv_cache_entry_t * entry);
+
+#endif /*LV_USE_DRAW_SW && LV_DRAW_SW_COMPLEX && LV_DRAW_SW_MASK_CACHE_SIZE > 0*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_SW_MASK_CACHE_PRIVATE_H*/
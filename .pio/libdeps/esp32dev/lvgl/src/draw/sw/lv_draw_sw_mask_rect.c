@@ -18,6 +18,7 @@
 #include "../../stdlib/lv_string.h"
 #include "lv_draw_sw.h"
 #include "lv_draw_sw_mask_private.h"
+#include "lv_draw_sw_mask_cache_private.h"
 
 /*********************
  *      DEFINES
@@ -30,6 +31,12 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+#if LV_DRAW_SW_MASK_CACHE_SIZE > 0
+    static bool corner_cache_render_cb(lv_draw_sw_mask_cache_data_t * data);
+    static void mask_corners_cached(lv_draw_task_t * t, const lv_draw_mask_rect_dsc_t * dsc,
+                                    const lv_area_t * draw_area, int32_t r, const lv_opa_t * corner_buf);
+    static void mask_span(lv_color32_t * c32_buf, const lv_opa_t * mask, int32_t len);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -80,6 +87,29 @@ void lv_draw_sw_mask_rect(lv_draw_task_t * t, const lv_draw_mask_rect_dsc_t * ds
         lv_draw_buf_clear(draw_buf, &clear_area);
     }
 
+#if LV_DRAW_SW_MASK_CACHE_SIZE > 0
+    /*Get the clamped radius*/
+    int32_t r = dsc->radius;
+    int32_t short_side = LV_MIN(lv_area_get_width(&dsc->area), lv_area_get_height(&dsc->area));
+    if(r > short_side >> 1) r = short_side >> 1;
+
+    if(r > 0) {
+        /*The corners depend only on the radius*/
+        lv_draw_sw_mask_cache_data_t key;
+        lv_memzero(&key, sizeof(key));
+        key.slot.size = 4 * r * r;
+        key.type = LV_DRAW_SW_MASK_CACHE_CORNERS;
+        key.radius = r;
+        lv_cache_entry_t * entry = lv_draw_sw_mask_cache_acquire(&key, corner_cache_render_cb);
+        if(entry) {
+            lv_draw_sw_mask_cache_data_t * data = lv_cache_entry_get_data(entry);
+            mask_corners_cached(t, dsc, &draw_area, r, data->buf);
+            lv_draw_sw_mask_cache_release(entry);
+            return;
+        }
+    }
+#endif /*LV_DRAW_SW_MASK_CACHE_SIZE > 0*/
+
     lv_draw_sw_mask_radius_param_t param;
     lv_draw_sw_mask_radius_init(&param, &dsc->area, dsc->radius, false);
 
@@ -119,6 +149,87 @@ void lv_draw_sw_mask_rect(lv_draw_task_t * t, const lv_draw_mask_rect_dsc_t * ds
  *   STATIC FUNCTIONS
  **********************/
 
+#if LV_DRAW_SW_MASK_CACHE_SIZE > 0
+
+/**
+ * Render the corners of a rounded rectangle for the mask cache. They are stored as the
+ * mask of a `2r x 2r` rectangle: rows `0..r-1` are the top corners, rows `r..2r-1` the
+ * bottom ones, and the left `r` bytes of a row belong to the left corner.
+ * @param data  the key of the corners and its `buf` to render to
+ * @return      true
+ */
+static bool corner_cache_render_cb(lv_draw_sw_mask_cache_data_t * data)
+{
+    int32_t size = 2 * data->radius;
+    lv_area_t rect;
+    lv_area_set(&rect, 0, 0, size - 1, size - 1);
+
+    lv_draw_sw_mask_radius_param_t param;
+    lv_draw_sw_mask_radius_init(&param, &rect, data->radius, false);
+
+    int32_t y;
+    lv_opa_t * row = data->buf;
+    for(y = 0; y < size; y++) {
+        lv_memset(row, 0xff, size);
+        param.dsc.cb(row, 0, y, size, &param);
+        row += size;
+    }
+
+    lv_draw_sw_mask_free_param(&param);
+    return true;
+}
+
+/**
+ * Same as the generic path of `lv_draw_sw_mask_rect()` but with the corners
+ * taken from the cache. Between the corners the mask is fully covering, so only
+ * the corner pixels of the top and bottom `r` rows are touched.
+ */
+static void mask_corners_cached(lv_draw_task_t * t, const lv_draw_mask_rect_dsc_t * dsc,
+                                const lv_area_t * draw_area, int32_t r, const lv_opa_t * corner_buf)
+{
+    lv_layer_t * target_layer = t->target_layer;
+    lv_area_t * buf_area = &target_layer->buf_area;
+    const lv_area_t * area = &dsc->area;
+    int32_t h = lv_area_get_height(area);
+
+    /*The columns of the left and right corners on the draw area*/
+    int32_t left_x1 = LV_MAX(draw_area->x1, area->x1);
+    int32_t left_x2 = LV_MIN(draw_area->x2, area->x1 + r - 1);
+    int32_t right_x1 = LV_MAX(draw_area->x1, area->x2 - r + 1);
+    int32_t right_x2 = LV_MIN(draw_area->x2, area->x2);
+
+    int32_t y;
+    for(y = draw_area->y1; y <= draw_area->y2; y++) {
+        int32_t corner_y = y - area->y1;
+        if(corner_y >= h - r) corner_y -= h - 2 * r;
+        else if(corner_y >= r) continue;
+
+        const lv_opa_t * corner_row = corner_buf + corner_y * 2 * r;
+        if(left_x1 <= left_x2) {
+            lv_color32_t * c32_buf = lv_draw_layer_go_to_xy(target_layer, left_x1 - buf_area->x1,
+                                                            y - buf_area->y1);
+            mask_span(c32_buf, &corner_row[left_x1 - area->x1], left_x2 - left_x1 + 1);
+        }
+        if(right_x1 <= right_x2) {
+            lv_color32_t * c32_buf = lv_draw_layer_go_to_xy(target_layer, right_x1 - buf_area->x1,
+                                                            y - buf_area->y1);
+            mask_span(c32_buf, &corner_row[r + right_x1 - (area->x2 - r + 1)], right_x2 - right_x1 + 1);
+        }
+    }
+}
+
+static void mask_span(lv_color32_t * c32_buf, const lv_opa_t * mask, int32_t len)
+{
+    int32_t i;
+    for(i = 0; i < len; i++) {
+        if(mask[i] != LV_OPA_COVER) {
+            c32_buf[i].alpha = LV_OPA_MIX2(c32_buf[i].alpha, mask[i]);
+        }
+    }
+}
+
+#endif /*LV_DRAW_SW_MASK_CACHE_SIZE > 0*/
+
 #else /*LV_DRAW_SW_COMPLEX*/
 
 void lv_draw_sw_mask_rect(lv_draw_unit_t * draw_unit, const lv_draw_mask_rect_dsc_t * dsc, const lv_area_t * coords)
@@ -10,16 +10,40 @@
 #if LV_USE_TFT_ESPI
 
 #include <TFT_eSPI.h>
+#include "../../../misc/lv_profiler.h"
 
 /*********************
  *      DEFINES
  *********************/
+#define TILE_W  LV_TFT_ESPI_TILE_W
+#define TILE_H  LV_TFT_ESPI_TILE_H
+
+/*Writing CASET/RASET here needs the plain DCS window commands with 16-bit parameters. Panels
+ *with a RAM offset or a different window scheme always get TFT_eSPI's complete window.*/
+#if LV_TFT_ESPI_BATCH_WRITES && defined(TFT_CASET) && defined(TFT_PASET) && defined(TFT_RAMWR) && \
+    !defined(CGRAM_OFFSET) && !defined(SPI_18BIT_DRIVER) && !defined(ILI9225_DRIVER) && \
+    !defined(SSD1351_DRIVER) && !defined(SSD1963_DRIVER) && !defined(RM68120_DRIVER)
+    #define WINDOW_CACHE    1
+#else
+    #define WINDOW_CACHE    0
+#endif
 
 /**********************
  *      TYPEDEFS
  **********************/
 typedef struct {
     TFT_eSPI * tft;
+#if LV_TFT_ESPI_BATCH_WRITES
+    bool writing;           /*Between startWrite() and endWrite()*/
+#endif
+#if WINDOW_CACHE
+    lv_area_t win;          /*The panel's current address window. x1 or y1 < 0: unknown*/
+#endif
+#if LV_TFT_ESPI_TILE_DIFF
+    uint32_t * tile_hash;   /*What each tile of the panel shows. 0: unknown*/
+    int32_t tile_cols;
+    int32_t tile_rows;
+#endif
 } lv_tft_espi_t;
 
 /**********************
@@ -27,6 +51,14 @@ typedef struct {
  **********************/
 static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map);
 static void resolution_changed_event_cb(lv_event_t * e);
+static void set_window(lv_tft_espi_t * dsc, int32_t x, int32_t y, int32_t w, int32_t h);
+static void push_rect(lv_tft_espi_t * dsc, int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t * px,
+                      int32_t stride);
+#if LV_TFT_ESPI_TILE_DIFF
+    static void tile_hash_alloc(lv_display_t * disp, lv_tft_espi_t * dsc);
+    static bool flush_changed_tiles(lv_display_t * disp, lv_tft_espi_t * dsc, const lv_area_t * area,
+                                    const uint16_t * px);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -58,6 +90,12 @@ lv_display_t * lv_tft_espi_create(uint32_t hor_res, uint32_t ver_res, void * buf
     lv_display_set_driver_data(disp, (void *)dsc);
     lv_display_set_flush_cb(disp, flush_cb);
     lv_display_add_event_cb(disp, resolution_changed_event_cb, LV_EVENT_RESOLUTION_CHANGED, NULL);
+#if WINDOW_CACHE
+    lv_area_set(&dsc->win, -1, -1, -1, -1);
+#endif
+#if LV_TFT_ESPI_TILE_DIFF
+    tile_hash_alloc(disp, dsc);
+#endif
     lv_display_set_buffers(disp, (void *)buf, NULL, buf_size_bytes, LV_DISPLAY_RENDER_MODE_PARTIAL);
     return disp;
 }
@@ -68,20 +106,216 @@ lv_display_t * lv_tft_espi_create(uint32_t hor_res, uint32_t ver_res, void * buf
 
 static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
 {
+    LV_PROFILER_BEGIN;
     lv_tft_espi_t * dsc = (lv_tft_espi_t *)lv_display_get_driver_data(disp);
+    const uint16_t * px = (const uint16_t *)px_map;
 
-    uint32_t w = (area->x2 - area->x1 + 1);
-    uint32_t h = (area->y2 - area->y1 + 1);
-
+#if LV_TFT_ESPI_BATCH_WRITES
+    /*One transaction from the first to the last area of the refresh. Other devices on the
+     *same SPI bus have to wait until the refresh is flushed.*/
+    if(!dsc->writing) {
+        dsc->tft->startWrite();
+        dsc->writing = true;
+    }
+#else
     dsc->tft->startWrite();
-    dsc->tft->setAddrWindow(area->x1, area->y1, w, h);
-    dsc->tft->pushColors((uint16_t *)px_map, w * h, true);
+#endif
+
+#if LV_TFT_ESPI_TILE_DIFF
+    if(!flush_changed_tiles(disp, dsc, area, px))
+#endif
+    {
+        int32_t w = lv_area_get_width(area);
+        push_rect(dsc, area->x1, area->y1, w, lv_area_get_height(area), px, w);
+    }
+
+#if LV_TFT_ESPI_BATCH_WRITES
+    if(lv_display_flush_is_last(disp)) {
+        dsc->tft->endWrite();
+        dsc->writing = false;
+    }
+#else
     dsc->tft->endWrite();
+#endif
 
     lv_display_flush_ready(disp);
+    LV_PROFILER_END;
+
+}
+
+/**
+ * Set the address window and start writing pixels to it. The panel keeps the column and row
+ * ranges until they are set again, so with WINDOW_CACHE only the ones that changed are sent:
+ * the bands of a full-width redraw only need RASET, the runs of one tile row only CASET.
+ */
+static void set_window(lv_tft_espi_t * dsc, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+#if WINDOW_CACHE
+    TFT_eSPI * tft = dsc->tft;
+    int32_t x2 = x + w - 1;
+    int32_t y2 = y + h - 1;
+    /*The parameters go out as two big-endian 16-bit words in one write, like pixels.
+     *pushPixels() reads whole 32-bit words, hence the padding.*/
+    uint16_t par[4] = {0};
 
+    if(x != dsc->win.x1 || x2 != dsc->win.x2) {
+        par[0] = (uint16_t)x;
+        par[1] = (uint16_t)x2;
+        tft->writecommand(TFT_CASET);
+        tft->pushColors(par, 2, true);
+        dsc->win.x1 = x;
+        dsc->win.x2 = x2;
+    }
+    if(y != dsc->win.y1 || y2 != dsc->win.y2) {
+        par[0] = (uint16_t)y;
+        par[1] = (uint16_t)y2;
+        tft->writecommand(TFT_PASET);
+        tft->pushColors(par, 2, true);
+        dsc->win.y1 = y;
+        dsc->win.y2 = y2;
+    }
+    tft->writecommand(TFT_RAMWR);
+#else
+    dsc->tft->setAddrWindow(x, y, w, h);
+#endif
 }
 
+/**
+ * Send a rectangle of a band to the panel
+ * @param px        first pixel of the rectangle
+ * @param stride    pixels per row of the band
+ */
+static void push_rect(lv_tft_espi_t * dsc, int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t * px,
+                      int32_t stride)
+{
+    TFT_eSPI * tft = dsc->tft;
+    set_window(dsc, x, y, w, h);
+    if(w == stride) {
+        tft->pushColors((uint16_t *)px, w * h, true);
+        return;
+    }
+    for(int32_t r = 0; r < h; r++) {
+        tft->pushColors((uint16_t *)px + r * stride, w, true);
+    }
+}
+
+#if LV_TFT_ESPI_TILE_DIFF
+
+/*The screen is a grid of tiles with a hash of what each one shows. A tile that a band covers
+ *completely is hashed from the band and only sent if the hash changed. A tile the band covers
+ *partly is sent as it is and its hash is forgotten, as the rest of it isn't known here. Small
+ *areas (e.g. one digit of a readout) therefore cost the same as without the tiles, while large
+ *redraws skip everything that looks the same as before.*/
+
+static void tile_hash_alloc(lv_display_t * disp, lv_tft_espi_t * dsc)
+{
+    lv_free(dsc->tile_hash);
+    dsc->tile_cols = (lv_display_get_horizontal_resolution(disp) + TILE_W - 1) / TILE_W;
+    dsc->tile_rows = (lv_display_get_vertical_resolution(disp) + TILE_H - 1) / TILE_H;
+    dsc->tile_hash = (uint32_t *)lv_malloc_zeroed(dsc->tile_cols * dsc->tile_rows * sizeof(uint32_t));
+    if(dsc->tile_hash == NULL) LV_LOG_WARN("no memory for the tile hashes, sending every pixel");
+}
+
+/*MurmurHash3 mixing: every input bit affects the whole hash, so two changes can't cancel out
+ *as easily as with a plain multiply-xor*/
+static inline uint32_t mix(uint32_t h, uint32_t k)
+{
+    k *= 0xcc9e2d51;
+    k = (k << 15) | (k >> 17);
+    k *= 0x1b873593;
+    h ^= k;
+    h = (h << 13) | (h >> 19);
+    return h * 5 + 0xe6546b64;
+}
+
+static uint32_t tile_hash(const uint16_t * px, int32_t stride, int32_t w, int32_t h)
+{
+    uint32_t hash = 0;
+    for(int32_t y = 0; y < h; y++) {
+        int32_t x;
+        for(x = 0; x + 1 < w; x += 2) hash = mix(hash, px[x] | (uint32_t)px[x + 1] << 16);
+        if(x < w) hash = mix(hash, px[x]);
+        px += stride;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    return hash ? hash : 1;
+}
+
+/**
+ * Send the band without the tiles that didn't change. Adjacent tiles to send in a tile row go
+ * out as one address window, and so do consecutive tile rows that are sent completely.
+ * @return  false if the band has to be sent as a whole
+ */
+static bool flush_changed_tiles(lv_display_t * disp, lv_tft_espi_t * dsc, const lv_area_t * area,
+                                const uint16_t * px)
+{
+    if(dsc->tile_hash == NULL) return false;
+
+    int32_t w = lv_area_get_width(area);
+    int32_t hor_res = lv_display_get_horizontal_resolution(disp);
+    int32_t ver_res = lv_display_get_vertical_resolution(disp);
+    int32_t x_end = area->x2 + 1;
+    int32_t y_end = area->y2 + 1;
+
+    int32_t full_y = -1;        /*First row of the pending full-width rows*/
+    int32_t full_h = 0;
+
+    for(int32_t ty = area->y1 / TILE_H; ty * TILE_H < y_end; ty++) {
+        /*The part of the tile row inside the band*/
+        int32_t tile_y1 = ty * TILE_H;
+        int32_t tile_y_end = LV_MIN(tile_y1 + TILE_H, ver_res);
+        int32_t y1 = LV_MAX(tile_y1, area->y1);
+        int32_t h = LV_MIN(tile_y_end, y_end) - y1;
+        bool full_rows = y1 == tile_y1 && y1 + h == tile_y_end;
+        const uint16_t * row = px + (y1 - area->y1) * w - area->x1;
+        uint32_t * hashes = &dsc->tile_hash[ty * dsc->tile_cols];
+        int32_t run_x = -1;     /*Start of the current run of tiles to send*/
+        bool row_split = false;
+
+        for(int32_t tx = area->x1 / TILE_W; tx * TILE_W < x_end; tx++) {
+            int32_t tile_x1 = tx * TILE_W;
+            int32_t tile_x_end = LV_MIN(tile_x1 + TILE_W, hor_res);
+            int32_t x1 = LV_MAX(tile_x1, area->x1);
+            int32_t x2_end = LV_MIN(tile_x_end, x_end);
+
+            bool send = true;
+            if(full_rows && x1 == tile_x1 && x2_end == tile_x_end) {
+                uint32_t hash = tile_hash(row + x1, w, x2_end - x1, h);
+                send = hashes[tx] != hash;
+                hashes[tx] = hash;
+            }
+            else {
+                hashes[tx] = 0;
+            }
+
+            if(send && run_x < 0) run_x = x1;
+            else if(!send && run_x >= 0) {
+                push_rect(dsc, run_x, y1, x1 - run_x, h, row + run_x, w);
+                run_x = -1;
+                row_split = true;
+            }
+        }
+
+        if(run_x == area->x1 && !row_split) {
+            if(full_y < 0) full_y = y1;
+            full_h += h;
+            continue;
+        }
+        if(run_x >= 0) push_rect(dsc, run_x, y1, x_end - run_x, h, row + run_x, w);
+        if(full_y >= 0) {
+            push_rect(dsc, area->x1, full_y, w, full_h, px + (full_y - area->y1) * w, w);
+            full_y = -1;
+            full_h = 0;
+        }
+    }
+    if(full_y >= 0) push_rect(dsc, area->x1, full_y, w, full_h, px + (full_y - area->y1) * w, w);
+    return true;
+}
+
+#endif /*LV_TFT_ESPI_TILE_DIFF*/
+
 static void resolution_changed_event_cb(lv_event_t * e)
 {
     lv_display_t * disp = (lv_display_t *)lv_event_get_target(e);
@@ -90,6 +324,13 @@ static void resolution_changed_event_cb(lv_event_t * e)
     int32_t ver_res = lv_display_get_vertical_resolution(disp);
     lv_display_rotation_t rot = lv_display_get_rotation(disp);
 
+#if LV_TFT_ESPI_TILE_DIFF
+    tile_hash_alloc(disp, dsc);
+#endif
+#if WINDOW_CACHE
+    lv_area_set(&dsc->win, -1, -1, -1, -1);     /*Its coordinates change meaning*/
+#endif
+
     /* handle rotation */
     switch(rot) {
         case LV_DISPLAY_ROTATION_0:
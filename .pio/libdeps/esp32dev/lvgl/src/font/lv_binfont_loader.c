@@ -9,6 +9,7 @@
 #include "lv_font_fmt_txt_private.h"
 #include "../lvgl.h"
 #include "../misc/lv_fs_private.h"
+#include "../misc/lv_text_private.h"
 #include "../misc/lv_types.h"
 #include "../stdlib/lv_string.h"
 #include "lv_binfont_loader.h"
@@ -137,6 +138,14 @@ void lv_binfont_destroy(lv_font_t * font)
     const lv_font_fmt_txt_dsc_t * dsc = font->dsc;
     if(dsc == NULL) return;
 
+#if LV_TEXT_ASCII_ADV_CACHE_CNT > 0
+    lv_text_ascii_adv_drop(font);
+#endif
+
+#if LV_GLYPH_CACHE_SIZE > 0
+    lv_glyph_cache_drop_font(font);
+#endif
+
     if(dsc->kern_classes == 0) {
         const lv_font_fmt_txt_kern_pair_t * kern_dsc = dsc->kern_dsc;
         if(NULL != kern_dsc) {
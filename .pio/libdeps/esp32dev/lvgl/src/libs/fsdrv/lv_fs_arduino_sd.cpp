@@ -32,6 +32,7 @@ extern "C" void lv_fs_arduino_sd_init(void)
     lv_fs_drv_init(fs_drv);
 
     fs_drv->letter = LV_FS_ARDUINO_SD_LETTER;
+    fs_drv->cache_size = LV_FS_ARDUINO_SD_CACHE_SIZE;
     fs_drv->open_cb = fs_open;
     fs_drv->close_cb = fs_close;
     fs_drv->read_cb = fs_read;
@@ -61,12 +62,8 @@ static void * fs_open(lv_fs_drv_t * drv, const char * path, lv_fs_mode_t mode)
 {
     LV_UNUSED(drv);
 
-    const char * flags;
-    if(mode == LV_FS_MODE_WR)
-        flags = FILE_WRITE;
-    else if(mode == LV_FS_MODE_RD)
-        flags = FILE_READ;
-    else if(mode == (LV_FS_MODE_WR | LV_FS_MODE_RD))
+    const char * flags = FILE_READ;
+    if(mode & LV_FS_MODE_WR)
         flags = FILE_WRITE;
 
     char buf[LV_FS_MAX_PATH_LEN];
@@ -145,10 +142,8 @@ static lv_fs_res_t fs_write(lv_fs_drv_t * drv, void * file_p, const void * buf,
 static lv_fs_res_t fs_seek(lv_fs_drv_t * drv, void * file_p, uint32_t pos, lv_fs_whence_t whence)
 {
     LV_UNUSED(drv);
-    SeekMode mode;
-    if(whence == LV_FS_SEEK_SET)
-        mode = SeekSet;
-    else if(whence == LV_FS_SEEK_CUR)
+    SeekMode mode = SeekSet;
+    if(whence == LV_FS_SEEK_CUR)
         mode = SeekCur;
     else if(whence == LV_FS_SEEK_END)
         mode = SeekEnd;
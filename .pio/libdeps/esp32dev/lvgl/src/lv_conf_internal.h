@@ -228,6 +228,18 @@
             #endif
         #endif
     #endif
+
+    /** Bytes of `LV_MEM_SIZE` reserved for slabs. Allocations up to 256 bytes (draw tasks,
+     *  widgets, short texts) are served in O(1) from size-class pages in this region and
+     *  go to TLSF only when it is full, so the frame-rate churn doesn't fragment the heap.
+     *  Must be a multiple of 1 kB. 0: disable */
+    #ifndef LV_MEM_SLAB_SIZE
+        #ifdef CONFIG_LV_MEM_SLAB_SIZE
+            #define LV_MEM_SLAB_SIZE CONFIG_LV_MEM_SLAB_SIZE
+        #else
+            #define LV_MEM_SLAB_SIZE 0
+        #endif
+    #endif
 #endif  /*LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN*/
 
 /*====================
@@ -392,6 +404,27 @@
     #endif
 #endif
 
+/** Find the older draw tasks a task depends on through a grid over the layer instead of
+ *  testing every older task of the layer. Only useful with an OS, where the draw threads
+ *  take tasks out of order. The grid is built when a layer holds
+ *  `LV_DRAW_TASK_INDEX_MIN_TASKS` tasks and freed when they are all done.*/
+#ifndef LV_DRAW_TASK_INDEX
+    #ifdef CONFIG_LV_DRAW_TASK_INDEX
+        #define LV_DRAW_TASK_INDEX CONFIG_LV_DRAW_TASK_INDEX
+    #else
+        #define LV_DRAW_TASK_INDEX              0
+    #endif
+#endif
+#if LV_DRAW_TASK_INDEX
+    #ifndef LV_DRAW_TASK_INDEX_MIN_TASKS
+        #ifdef CONFIG_LV_DRAW_TASK_INDEX_MIN_TASKS
+            #define LV_DRAW_TASK_INDEX_MIN_TASKS CONFIG_LV_DRAW_TASK_INDEX_MIN_TASKS
+        #else
+            #define LV_DRAW_TASK_INDEX_MIN_TASKS    32
+        #endif
+    #endif
+#endif
+
 #ifndef LV_USE_DRAW_SW
     #ifdef LV_KCONFIG_PRESENT
         #ifdef CONFIG_LV_USE_DRAW_SW
@@ -613,6 +646,18 @@
                 #define LV_DRAW_SW_CIRCLE_CACHE_SIZE 4
             #endif
         #endif
+
+        /** Size of the cache of rendered shadow corners and rounded-corner masks [bytes].
+         *  Masks are looked up by their shape (size, radius, spread, blur), so objects of the
+         *  same style share them and a redraw needs no mask calculation.
+         *  - 0: disables caching */
+        #ifndef LV_DRAW_SW_MASK_CACHE_SIZE
+            #ifdef CONFIG_LV_DRAW_SW_MASK_CACHE_SIZE
+                #define LV_DRAW_SW_MASK_CACHE_SIZE CONFIG_LV_DRAW_SW_MASK_CACHE_SIZE
+            #else
+                #define LV_DRAW_SW_MASK_CACHE_SIZE 0
+            #endif
+        #endif
     #endif
 
     #ifndef LV_USE_DRAW_SW_ASM
@@ -642,6 +687,16 @@
         #endif
     #endif
 
+    /** Blend plain (uncompressed) 4 bpp glyphs straight from the font bitmap into
+     *  RGB565 layers instead of unpacking them to an A8 buffer first */
+    #ifndef LV_DRAW_SW_GLYPH_A4_DIRECT
+        #ifdef CONFIG_LV_DRAW_SW_GLYPH_A4_DIRECT
+            #define LV_DRAW_SW_GLYPH_A4_DIRECT CONFIG_LV_DRAW_SW_GLYPH_A4_DIRECT
+        #else
+            #define LV_DRAW_SW_GLYPH_A4_DIRECT    0
+        #endif
+    #endif
+
 #endif
 
 /*Use TSi's aka (Think Silicon) NemaGFX */
@@ -1456,6 +1511,17 @@
     #endif
 #endif
 
+/** Byte budget of the LRU cache holding decoded (A8) glyph masks, so glyphs that are
+ *  redrawn often are not decoded from the font again on every band and frame.
+ *  0: disable the glyph cache */
+#ifndef LV_GLYPH_CACHE_SIZE
+    #ifdef CONFIG_LV_GLYPH_CACHE_SIZE
+        #define LV_GLYPH_CACHE_SIZE CONFIG_LV_GLYPH_CACHE_SIZE
+    #else
+        #define LV_GLYPH_CACHE_SIZE 0
+    #endif
+#endif
+
 /** Number of stops allowed per gradient. Increase this to allow more stops.
  *  This adds (sizeof(lv_color_t) + 1) bytes per additional stop. */
 #ifndef LV_GRADIENT_MAX_STOPS
@@ -2026,6 +2092,17 @@
     #endif
 #endif
 
+/** Number of fonts whose ASCII advance widths are kept in a table to measure and wrap text
+ *  without glyph lookups. Only fonts in LVGL's own format (C arrays and BIN fonts) are cached,
+ *  the first that many to be measured. Uses ~100 bytes per font. 0: disable */
+#ifndef LV_TEXT_ASCII_ADV_CACHE_CNT
+    #ifdef CONFIG_LV_TEXT_ASCII_ADV_CACHE_CNT
+        #define LV_TEXT_ASCII_ADV_CACHE_CNT CONFIG_LV_TEXT_ASCII_ADV_CACHE_CNT
+    #else
+        #define LV_TEXT_ASCII_ADV_CACHE_CNT 0
+    #endif
+#endif
+
 /** Support bidirectional text. Allows mixing Left-to-Right and Right-to-Left text.
  *  The direction will be processed according to the Unicode Bidirectional Algorithm:
  *  https://www.w3.org/International/articles/inline-bidi-markup/uba-basics */
@@ -2951,6 +3028,13 @@
             #define LV_FS_ARDUINO_SD_PATH ""      /**< Set the working directory. File/directory paths will be appended to it. */
         #endif
     #endif
+    #ifndef LV_FS_ARDUINO_SD_CACHE_SIZE
+        #ifdef CONFIG_LV_FS_ARDUINO_SD_CACHE_SIZE
+            #define LV_FS_ARDUINO_SD_CACHE_SIZE CONFIG_LV_FS_ARDUINO_SD_CACHE_SIZE
+        #else
+            #define LV_FS_ARDUINO_SD_CACHE_SIZE 0 /**< >0 to cache this number of bytes in lv_fs_read() */
+        #endif
+    #endif
 #endif
 
 /** API for UEFI */
@@ -4222,6 +4306,43 @@
     #endif
 #endif
 
+#if LV_USE_TFT_ESPI
+    /** Don't send the tiles of a flushed area whose pixels didn't change. A 32-bit hash per
+     *  tile (4 bytes per tile in the LVGL heap) remembers what the panel shows. 0: disable*/
+    #ifndef LV_TFT_ESPI_TILE_DIFF
+        #ifdef CONFIG_LV_TFT_ESPI_TILE_DIFF
+            #define LV_TFT_ESPI_TILE_DIFF CONFIG_LV_TFT_ESPI_TILE_DIFF
+        #else
+            #define LV_TFT_ESPI_TILE_DIFF   0
+        #endif
+    #endif
+    #ifndef LV_TFT_ESPI_TILE_W
+        #ifdef CONFIG_LV_TFT_ESPI_TILE_W
+            #define LV_TFT_ESPI_TILE_W CONFIG_LV_TFT_ESPI_TILE_W
+        #else
+            #define LV_TFT_ESPI_TILE_W      16
+        #endif
+    #endif
+    #ifndef LV_TFT_ESPI_TILE_H
+        #ifdef CONFIG_LV_TFT_ESPI_TILE_H
+            #define LV_TFT_ESPI_TILE_H CONFIG_LV_TFT_ESPI_TILE_H
+        #else
+            #define LV_TFT_ESPI_TILE_H      8
+        #endif
+    #endif
+
+    /** Keep the SPI bus claimed from the first to the last area of a refresh and only resend the
+     *  column or row range of an address window when it changed. 0: one transaction and a full
+     *  address window per area*/
+    #ifndef LV_TFT_ESPI_BATCH_WRITES
+        #ifdef CONFIG_LV_TFT_ESPI_BATCH_WRITES
+            #define LV_TFT_ESPI_BATCH_WRITES CONFIG_LV_TFT_ESPI_BATCH_WRITES
+        #else
+            #define LV_TFT_ESPI_BATCH_WRITES 0
+        #endif
+    #endif
+#endif
+
 /** Interface for Lovyan_GFX */
 #ifndef LV_USE_LOVYAN_GFX
     #ifdef CONFIG_LV_USE_LOVYAN_GFX
@@ -11,6 +11,7 @@
 #include "misc/lv_anim_private.h"
 #include "draw/lv_image_decoder_private.h"
 #include "draw/lv_draw_buf_private.h"
+#include "misc/cache/instance/lv_glyph_cache.h"
 #include "core/lv_refr_private.h"
 #include "core/lv_obj_style_private.h"
 #include "core/lv_group_private.h"
@@ -213,6 +214,10 @@ void lv_init(void)
 
     lv_os_init();
 
+#if LV_TEXT_ASCII_ADV_CACHE_CNT > 0
+    lv_text_ascii_adv_init();
+#endif
+
     lv_timer_core_init();
 
     lv_fs_init();
@@ -294,6 +299,9 @@ void lv_init(void)
 #endif
 
     lv_image_decoder_init(LV_CACHE_DEF_SIZE, LV_IMAGE_HEADER_CACHE_DEF_CNT);
+#if LV_GLYPH_CACHE_SIZE > 0
+    lv_glyph_cache_init(LV_GLYPH_CACHE_SIZE);
+#endif
     lv_bin_decoder_init();  /*LVGL built-in binary image decoder*/
 
 #if LV_USE_DRAW_VG_LITE
@@ -447,6 +455,10 @@ void lv_deinit(void)
     lv_span_stack_deinit();
 #endif
 
+#if LV_TEXT_ASCII_ADV_CACHE_CNT > 0
+    lv_text_ascii_adv_deinit();
+#endif
+
 #if LV_USE_FREETYPE
     lv_freetype_uninit();
 #endif
@@ -464,6 +476,9 @@ void lv_deinit(void)
 #endif
 
     lv_image_decoder_deinit();
+#if LV_GLYPH_CACHE_SIZE > 0
+    lv_glyph_cache_deinit();
+#endif
 
     lv_refr_deinit();
 
@@ -0,0 +1,285 @@
+/**
+* @file lv_glyph_cache.c
+*
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lv_glyph_cache_private.h"
+
+#if LV_GLYPH_CACHE_SIZE > 0
+
+#include "../../lv_assert.h"
+#include "../../lv_iter.h"
+#include "../../lv_text_private.h"
+#include "../../../core/lv_global.h"
+#include "../../../draw/lv_draw_buf.h"
+#include "../../../stdlib/lv_string.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#define CACHE_NAME  "GLYPH"
+
+#define glyph_cache_p (LV_GLOBAL_DEFAULT()->glyph_cache)
+#define glyph_cache_pinned_ll_p (&LV_GLOBAL_DEFAULT()->glyph_cache_pinned_ll)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static lv_cache_compare_res_t glyph_cache_compare_cb(const lv_glyph_cache_data_t * lhs,
+                                                     const lv_glyph_cache_data_t * rhs);
+static bool glyph_cache_create_cb(lv_glyph_cache_data_t * data, void * user_data);
+static void glyph_cache_free_cb(lv_glyph_cache_data_t * data, void * user_data);
+
+/**********************
+ *  GLOBAL VARIABLES
+ **********************/
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_result_t lv_glyph_cache_init(uint32_t size)
+{
+    if(glyph_cache_p != NULL) {
+        return LV_RESULT_OK;
+    }
+
+    glyph_cache_p = lv_cache_create(&lv_cache_class_lru_rb_size,
+    sizeof(lv_glyph_cache_data_t), size, (lv_cache_ops_t) {
+        .compare_cb = (lv_cache_compare_cb_t) glyph_cache_compare_cb,
+        .create_cb = (lv_cache_create_cb_t) glyph_cache_create_cb,
+        .free_cb = (lv_cache_free_cb_t) glyph_cache_free_cb,
+    });
+
+    lv_ll_init(glyph_cache_pinned_ll_p, sizeof(lv_cache_entry_t *));
+
+    if(glyph_cache_p == NULL) return LV_RESULT_INVALID;
+    lv_cache_set_name(glyph_cache_p, CACHE_NAME);
+    return LV_RESULT_OK;
+}
+
+void lv_glyph_cache_deinit(void)
+{
+    if(glyph_cache_p == NULL) return;
+
+    lv_cache_entry_t ** pinned;
+    LV_LL_READ(glyph_cache_pinned_ll_p, pinned) {
+        lv_cache_release(glyph_cache_p, *pinned, NULL);
+    }
+    lv_ll_clear(glyph_cache_pinned_ll_p);
+
+    lv_cache_destroy(glyph_cache_p, NULL);
+    glyph_cache_p = NULL;
+}
+
+void lv_glyph_cache_resize(uint32_t size, bool evict_now)
+{
+    if(glyph_cache_p == NULL) return;
+
+    lv_cache_set_max_size(glyph_cache_p, size, NULL);
+
+    /*Not `lv_cache_reserve()`: it would spin forever if pinned glyphs exceed the new size*/
+    if(evict_now) {
+        while(lv_cache_get_size(glyph_cache_p, NULL) > size && lv_cache_evict_one(glyph_cache_p, NULL)) {}
+    }
+}
+
+lv_cache_entry_t * lv_glyph_cache_acquire(lv_font_glyph_dsc_t * g)
+{
+    if(glyph_cache_p == NULL) return NULL;
+    if(g->format < LV_FONT_GLYPH_FORMAT_A1 || g->format > LV_FONT_GLYPH_FORMAT_A8) return NULL;
+    if(g->box_w == 0 || g->box_h == 0) return NULL;
+
+    uint32_t stride = lv_draw_buf_width_to_stride(g->box_w, LV_COLOR_FORMAT_A8);
+    lv_glyph_cache_data_t search_key = {
+        .slot.size = stride * g->box_h,
+        .font = g->resolved_font,
+        .gid = g->gid.index,
+        .format = g->format,
+        .stride = stride,
+    };
+
+    lv_cache_entry_t * entry = lv_cache_acquire(glyph_cache_p, &search_key, NULL);
+    if(entry) {
+        LV_GLOBAL_DEFAULT()->glyph_cache_hits++;
+        return entry;
+    }
+
+    LV_GLOBAL_DEFAULT()->glyph_cache_misses++;
+    return lv_cache_acquire_or_create(glyph_cache_p, &search_key, g);
+}
+
+void lv_glyph_cache_release(lv_cache_entry_t * entry)
+{
+    lv_cache_release(glyph_cache_p, entry, NULL);
+}
+
+uint32_t lv_glyph_cache_pin(const lv_font_t * font, const char * text)
+{
+    LV_ASSERT_NULL(font);
+    LV_ASSERT_NULL(text);
+    if(glyph_cache_p == NULL) return 0;
+
+    uint32_t pinned = 0;
+    uint32_t i = 0;
+    while(text[i] != '\0') {
+        uint32_t letter = lv_text_encoded_next(text, &i);
+
+        lv_font_glyph_dsc_t g;
+        lv_memzero(&g, sizeof(g));
+        if(!lv_font_get_glyph_dsc(font, &g, letter, 0)) continue;
+
+        lv_cache_entry_t * entry = lv_glyph_cache_acquire(&g);
+        lv_font_glyph_release_draw_data(&g);
+        if(entry == NULL) {
+            LV_LOG_WARN("Couldn't pin U+%" LV_PRIX32 ", the glyph cache is full", letter);
+            continue;
+        }
+
+        /*Keep the reference: referenced entries are never evicted*/
+        lv_cache_entry_t ** node = lv_ll_ins_tail(glyph_cache_pinned_ll_p);
+        LV_ASSERT_MALLOC(node);
+        if(node == NULL) {
+            lv_cache_release(glyph_cache_p, entry, NULL);
+            break;
+        }
+        *node = entry;
+        pinned++;
+    }
+
+    return pinned;
+}
+
+void lv_glyph_cache_drop_font(const lv_font_t * font)
+{
+    LV_ASSERT_NULL(font);
+    if(glyph_cache_p == NULL) return;
+
+    /*Unpin first: referenced entries are only marked invalid by a drop*/
+    lv_cache_entry_t ** pinned = lv_ll_get_head(glyph_cache_pinned_ll_p);
+    while(pinned) {
+        lv_cache_entry_t ** next = lv_ll_get_next(glyph_cache_pinned_ll_p, pinned);
+        const lv_glyph_cache_data_t * data = lv_cache_entry_get_data(*pinned);
+        if(data->font == font) {
+            lv_cache_release(glyph_cache_p, *pinned, NULL);
+            lv_ll_remove(glyph_cache_pinned_ll_p, pinned);
+            lv_free(pinned);
+        }
+        pinned = next;
+    }
+
+    /*A drop changes the LRU list under the iterator, so start over after each one*/
+    lv_glyph_cache_data_t * data = lv_malloc(lv_cache_entry_get_size(sizeof(lv_glyph_cache_data_t)));
+    LV_ASSERT_MALLOC(data);
+    if(data == NULL) return;
+
+    bool found;
+    do {
+        found = false;
+        lv_iter_t * iter = lv_cache_iter_create(glyph_cache_p);
+        if(iter == NULL) break;
+        while(!found && lv_iter_next(iter, data) == LV_RESULT_OK) found = data->font == font;
+        lv_iter_destroy(iter);
+        if(found) lv_cache_drop(glyph_cache_p, data, NULL);
+    } while(found);
+
+    lv_free(data);
+}
+
+void lv_glyph_cache_get_stats(lv_glyph_cache_stats_t * stats)
+{
+    LV_ASSERT_NULL(stats);
+    lv_memzero(stats, sizeof(*stats));
+    if(glyph_cache_p == NULL) return;
+
+    stats->hits = LV_GLOBAL_DEFAULT()->glyph_cache_hits;
+    stats->misses = LV_GLOBAL_DEFAULT()->glyph_cache_misses;
+    stats->pinned = lv_ll_get_len(glyph_cache_pinned_ll_p);
+    stats->size = lv_cache_get_size(glyph_cache_p, NULL);
+    stats->max_size = lv_cache_get_max_size(glyph_cache_p, NULL);
+}
+
+void lv_glyph_cache_reset_stats(void)
+{
+    LV_GLOBAL_DEFAULT()->glyph_cache_hits = 0;
+    LV_GLOBAL_DEFAULT()->glyph_cache_misses = 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static lv_cache_compare_res_t glyph_cache_compare_cb(const lv_glyph_cache_data_t * lhs,
+                                                     const lv_glyph_cache_data_t * rhs)
+{
+    if(lhs->font != rhs->font) return lhs->font > rhs->font ? 1 : -1;
+    if(lhs->gid != rhs->gid) return lhs->gid > rhs->gid ? 1 : -1;
+    if(lhs->format != rhs->format) return lhs->format > rhs->format ? 1 : -1;
+    return 0;
+}
+
+static bool glyph_cache_create_cb(lv_glyph_cache_data_t * data, void * user_data)
+{
+    lv_font_glyph_dsc_t * g = user_data;
+
+    data->bitmap = lv_malloc(data->slot.size);
+    if(data->bitmap == NULL) return false;
+
+    lv_draw_buf_t draw_buf;
+    lv_draw_buf_init(&draw_buf, g->box_w, g->box_h, LV_COLOR_FORMAT_A8, data->stride, data->bitmap, data->slot.size);
+
+    const lv_draw_buf_t * decoded = lv_font_get_glyph_bitmap(g, &draw_buf);
+    if(decoded == NULL) {
+        lv_free(data->bitmap);
+        data->bitmap = NULL;
+        return false;
+    }
+
+    /*Some font engines return their own buffer instead of filling ours*/
+    if(decoded != &draw_buf) {
+        if(decoded->header.cf != LV_COLOR_FORMAT_A8) {
+            lv_free(data->bitmap);
+            data->bitmap = NULL;
+            return false;
+        }
+
+        const uint8_t * src = decoded->data;
+        uint8_t * dest = data->bitmap;
+        uint32_t y;
+        for(y = 0; y < g->box_h; y++) {
+            lv_memcpy(dest, src, g->box_w);
+            src += decoded->header.stride;
+            dest += data->stride;
+        }
+    }
+
+    return true;
+}
+
+static void glyph_cache_free_cb(lv_glyph_cache_data_t * data, void * user_data)
+{
+    LV_UNUSED(user_data);
+
+    lv_free(data->bitmap);
+    data->bitmap = NULL;
+}
+
+#endif /*LV_GLYPH_CACHE_SIZE > 0*/
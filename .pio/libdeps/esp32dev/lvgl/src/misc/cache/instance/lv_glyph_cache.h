@@ -0,0 +1,113 @@
+/**
+* @file lv_glyph_cache.h
+*
+ */
+
+#ifndef LV_GLYPH_CACHE_H
+#define LV_GLYPH_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../../font/lv_font.h"
+
+#if LV_GLYPH_CACHE_SIZE > 0
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    uint32_t hits;                  /**< Glyphs served from the cache*/
+    uint32_t misses;                /**< Glyphs that had to be decoded*/
+    uint32_t pinned;                /**< Glyphs pinned by `lv_glyph_cache_pin()`*/
+    uint32_t size;                  /**< Bytes in use (including pinned glyphs)*/
+    uint32_t max_size;              /**< Byte budget*/
+} lv_glyph_cache_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the glyph cache. Called by `lv_init()` with `LV_GLYPH_CACHE_SIZE`.
+ * @param size      byte budget for decoded glyph masks
+ * @return          LV_RESULT_OK: initialization succeeded, LV_RESULT_INVALID: failed.
+ */
+lv_result_t lv_glyph_cache_init(uint32_t size);
+
+/**
+ * Free the glyph cache, including pinned glyphs.
+ */
+void lv_glyph_cache_deinit(void);
+
+/**
+ * Change the byte budget of the glyph cache. If set to 0, the cache is disabled.
+ * @param size      new byte budget
+ * @param evict_now true: evict least recently used glyphs now, false: on the next insertion
+ */
+void lv_glyph_cache_resize(uint32_t size, bool evict_now);
+
+/**
+ * Get the A8 mask of a bitmap glyph, decoding it on a miss.
+ * Release the entry with `lv_glyph_cache_release()` after drawing.
+ * @param g     the glyph descriptor returned by the font (A1..A8 formats only)
+ * @return      the cache entry holding an `lv_glyph_cache_data_t`, or NULL if the
+ *              glyph can't be cached (disabled, unsupported format, does not fit)
+ */
+lv_cache_entry_t * lv_glyph_cache_acquire(lv_font_glyph_dsc_t * g);
+
+/**
+ * Release an entry returned by `lv_glyph_cache_acquire()`.
+ * @param entry the cache entry
+ */
+void lv_glyph_cache_release(lv_cache_entry_t * entry);
+
+/**
+ * Decode the glyphs of `text` and keep them in the cache for good, e.g. a big
+ * font's digits at startup. Pinned glyphs are never evicted and count against
+ * the byte budget.
+ * @param font  the font
+ * @param text  UTF-8 text with the letters to pin
+ * @return      the number of glyphs pinned
+ */
+uint32_t lv_glyph_cache_pin(const lv_font_t * font, const char * text);
+
+/**
+ * Drop the glyphs of a font, pinned ones included. Call it before the font is freed.
+ * Glyphs still being drawn are freed when they are released.
+ * @param font  the font
+ */
+void lv_glyph_cache_drop_font(const lv_font_t * font);
+
+/**
+ * Get the hit/miss counters and the memory usage of the glyph cache.
+ * @param stats     store the statistics here
+ */
+void lv_glyph_cache_get_stats(lv_glyph_cache_stats_t * stats);
+
+/**
+ * Reset the hit and miss counters.
+ */
+void lv_glyph_cache_reset_stats(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_GLYPH_CACHE_SIZE > 0*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_GLYPH_CACHE_H*/
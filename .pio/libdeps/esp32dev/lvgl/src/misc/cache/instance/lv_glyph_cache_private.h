@@ -0,0 +1,44 @@
+/**
+* @file lv_glyph_cache_private.h
+*
+ */
+
+#ifndef LV_GLYPH_CACHE_PRIVATE_H
+#define LV_GLYPH_CACHE_PRIVATE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../lv_cache_private.h"
+#include "lv_glyph_cache.h"
+
+#if LV_GLYPH_CACHE_SIZE > 0
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/** A decoded glyph. The key is (font, glyph index, source format).*/
+typedef struct {
+    lv_cache_slot_size_t slot;      /**< Bytes of `bitmap`, counted against the cache size*/
+
+    const lv_font_t * font;         /**< The font the glyph was resolved from*/
+    uint32_t gid;                   /**< Glyph index in `font`*/
+    lv_font_glyph_format_t format;  /**< Format of the glyph in the font (A1..A8)*/
+
+    uint8_t * bitmap;               /**< A8 mask, `stride` bytes per row*/
+    uint32_t stride;
+} lv_glyph_cache_data_t;
+
+#endif /*LV_GLYPH_CACHE_SIZE > 0*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_GLYPH_CACHE_PRIVATE_H*/
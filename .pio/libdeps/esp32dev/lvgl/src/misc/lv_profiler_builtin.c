@@ -38,19 +38,6 @@
  *      TYPEDEFS
  **********************/
 
-/**
- * @brief Structure representing a built-in profiler item in LVGL
- */
-typedef struct {
-    uint64_t tick;     /**< The tick value of the profiler item */
-    char tag;          /**< The tag of the profiler item */
-    const char * func; /**< A pointer to the function associated with the profiler item */
-#if LV_USE_OS
-    int tid;           /**< The thread ID of the profiler item */
-    int cpu;         /**< The CPU ID of the profiler item */
-#endif
-} lv_profiler_builtin_item_t;
-
 /**
  * @brief Structure representing a context for the LVGL built-in profiler
  */
@@ -136,7 +123,7 @@ void lv_profiler_builtin_init(const lv_profiler_builtin_config_t * config)
     profiler_ctx->item_num = num;
     profiler_ctx->config = *config;
 
-    if(profiler_ctx->config.flush_cb) {
+    if(profiler_ctx->config.flush_cb && !profiler_ctx->config.flush_items_cb) {
         /* add profiler header for perfetto */
         profiler_ctx->config.flush_cb("# tracer: nop\n");
         profiler_ctx->config.flush_cb("#\n");
@@ -174,6 +161,7 @@ void lv_profiler_builtin_flush(void)
 
     LV_PROFILER_MULTEX_LOCK;
     flush_no_lock();
+    profiler_ctx->cur_index = 0;
     LV_PROFILER_MULTEX_UNLOCK;
 }
 
@@ -233,6 +221,13 @@ static int default_cpu_get_cb(void)
 
 static void flush_no_lock(void)
 {
+    if(profiler_ctx->config.flush_items_cb) {
+        if(profiler_ctx->cur_index > 0) {
+            profiler_ctx->config.flush_items_cb(profiler_ctx->item_arr, profiler_ctx->cur_index);
+        }
+        return;
+    }
+
     if(!profiler_ctx->config.flush_cb) {
         LV_LOG_WARN("flush_cb is not registered");
         return;
@@ -61,7 +61,7 @@ void lv_profiler_builtin_uninit(void);
 void lv_profiler_builtin_set_enable(bool enable);
 
 /**
- * @brief Flush the profiling data to the console
+ * @brief Flush the profiling data to the console and empty the buffer
  */
 void lv_profiler_builtin_flush(void);
 
@@ -26,6 +26,19 @@ extern "C" {
  *      TYPEDEFS
  **********************/
 
+/**
+ * @brief Structure representing a built-in profiler item in LVGL
+ */
+typedef struct {
+    uint64_t tick;     /**< The tick value of the profiler item */
+    char tag;          /**< The tag of the profiler item */
+    const char * func; /**< A pointer to the function associated with the profiler item */
+#if LV_USE_OS
+    int tid;           /**< The thread ID of the profiler item */
+    int cpu;         /**< The CPU ID of the profiler item */
+#endif
+} lv_profiler_builtin_item_t;
+
 /**
  * @brief LVGL profiler built-in configuration structure
  */
@@ -36,6 +49,13 @@ struct _lv_profiler_builtin_config_t {
     void (*flush_cb)(const char * buf); /**< Callback function to flush the profiling data */
     int (*tid_get_cb)(void);            /**< Callback function to get the current thread ID */
     int (*cpu_get_cb)(void);            /**< Callback function to get the current CPU */
+
+    /**
+     * Optional callback to flush the items as they are instead of formatting them
+     * as text for `flush_cb`. `func` of the items points to string literals or `__func__`,
+     * so it stays valid after the flush.
+     */
+    void (*flush_items_cb)(const lv_profiler_builtin_item_t * items, uint32_t cnt);
 };
 
 
@@ -14,12 +14,29 @@
 #include "../stdlib/lv_mem.h"
 #include "../stdlib/lv_string.h"
 #include "../misc/lv_types.h"
+#include "../font/lv_font_fmt_txt.h"
+#include "../core/lv_global.h"
 
 /*********************
  *      DEFINES
  *********************/
 #define NO_BREAK_FOUND UINT32_MAX
 
+#if LV_TEXT_ASCII_ADV_CACHE_CNT > 0
+#define ascii_adv_tables LV_GLOBAL_DEFAULT()->text_ascii_adv
+#define ascii_adv_lock LV_GLOBAL_DEFAULT()->text_ascii_adv_lock
+#define ASCII_ADV_SLOW 0xFF    /*The width depends on the next letter or doesn't fit 8 bits*/
+
+/*A table's font is published after its widths, for draw units on other cores*/
+#if defined(__GNUC__)
+#define ascii_adv_font_get(t)       __atomic_load_n(&(t)->font, __ATOMIC_ACQUIRE)
+#define ascii_adv_font_set(t, f)    __atomic_store_n(&(t)->font, f, __ATOMIC_RELEASE)
+#else
+#define ascii_adv_font_get(t)       ((t)->font)
+#define ascii_adv_font_set(t, f)    ((t)->font = (f))
+#endif
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -27,6 +44,12 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static const uint8_t * get_ascii_adv(const lv_font_t * font);
+static inline void letter_next_2(const char * txt, uint32_t * letter, uint32_t * letter_next, uint32_t * ofs);
+static inline int32_t get_letter_width(const lv_font_t * font, const uint8_t * adv, uint32_t letter,
+                                       uint32_t letter_next);
+static uint32_t get_unwrapped_line(const char * txt, uint32_t len, const lv_font_t * font, const uint8_t * adv,
+                                   int32_t * used_width, const lv_text_attributes_t * attributes);
 
 #if LV_TXT_ENC == LV_TXT_ENC_UTF8
     static uint8_t lv_text_utf8_size(const char * str);
@@ -214,6 +237,7 @@ bool lv_text_is_cmd(lv_text_cmd_state_t * state, uint32_t c)
  *
  * @param txt a '\0' terminated string
  * @param font pointer to a font
+ * @param adv ASCII advance widths of the font from `get_ascii_adv()`. May be NULL.
  * @param letter_space letter space
  * @param max_width max width of the text (break the lines to fit this size). Set COORD_MAX to avoid line breaks
  * @param flags settings for the text from 'txt_flag_type' enum
@@ -221,7 +245,7 @@ bool lv_text_is_cmd(lv_text_cmd_state_t * state, uint32_t c)
  * @param cmd_state Pointer to a lv_text_cmd_state_t variable which stored the current state of command processing
  * @return the index of the first char of the next word (in byte index not letter index. With UTF-8 they are different)
  */
-static uint32_t lv_text_get_next_word(const char * txt, const lv_font_t * font,
+static uint32_t lv_text_get_next_word(const char * txt, const lv_font_t * font, const uint8_t * adv,
                                       int32_t letter_space, int32_t max_width,
                                       lv_text_flag_t flag, uint32_t * word_w_ptr,
                                       lv_text_cmd_state_t * cmd_state)
@@ -258,7 +282,7 @@ static uint32_t lv_text_get_next_word(const char * txt, const lv_font_t * font,
             }
         }
 
-        letter_w = lv_font_get_glyph_width(font, letter, letter_next);
+        letter_w = get_letter_width(font, adv, letter, letter_next);
         cur_w += letter_w;
 
         if(letter_w > 0) {
@@ -370,6 +394,14 @@ uint32_t lv_text_get_next_line(const char * txt, uint32_t len,
     if(attributes->text_flags & LV_TEXT_FLAG_EXPAND) {
         attributes->max_width = LV_COORD_MAX;
     }
+
+    /*Short labels usually fit in one line so try that first*/
+    const uint8_t * adv = get_ascii_adv(font);
+    if(adv != NULL && (attributes->text_flags & LV_TEXT_FLAG_RECOLOR) == 0) {
+        uint32_t line_end = get_unwrapped_line(txt, len, font, adv, used_width, attributes);
+        if(line_end != 0) return line_end;
+    }
+
     lv_text_cmd_state_t cmd_state = LV_TEXT_CMD_STATE_WAIT;
 
     uint32_t i = 0;                                        /*Iterating index into txt*/
@@ -381,7 +413,7 @@ uint32_t lv_text_get_next_line(const char * txt, uint32_t len,
         if(i == 0) word_flag |= LV_TEXT_FLAG_BREAK_ALL;
 
         uint32_t word_w = 0;
-        uint32_t advance = lv_text_get_next_word(&txt[i], font, attributes->letter_space,
+        uint32_t advance = lv_text_get_next_word(&txt[i], font, adv, attributes->letter_space,
                                                  max_width, word_flag, &word_w, &cmd_state);
         max_width -= word_w;
         line_w += word_w;
@@ -425,6 +457,7 @@ int32_t lv_text_get_width(const char * txt, uint32_t length, const lv_font_t * f
     uint32_t i                = 0;
     int32_t width             = 0;
     lv_text_cmd_state_t cmd_state = LV_TEXT_CMD_STATE_WAIT;
+    const uint8_t * adv       = get_ascii_adv(font);
 
     if(length != 0) {
         while(txt[i] != '\0' && i < length) {
@@ -432,7 +465,7 @@ int32_t lv_text_get_width(const char * txt, uint32_t length, const lv_font_t * f
             uint32_t letter;
             uint32_t letter_next;
 
-            lv_text_encoded_letter_next_2(txt, &letter, &letter_next, &i);
+            letter_next_2(txt, &letter, &letter_next, &i);
 
             if((attributes->text_flags & LV_TEXT_FLAG_RECOLOR) != 0) {
                 if(lv_text_is_cmd(&cmd_state, letter) != false) {
@@ -440,7 +473,7 @@ int32_t lv_text_get_width(const char * txt, uint32_t length, const lv_font_t * f
                 }
             }
 
-            int32_t char_width = lv_font_get_glyph_width(font, letter, letter_next);
+            int32_t char_width = get_letter_width(font, adv, letter, letter_next);
             if(char_width > 0) {
                 width += char_width;
                 width += attributes->letter_space;
@@ -541,6 +574,220 @@ void lv_text_encoded_letter_next_2(const char * txt, uint32_t * letter, uint32_t
     *letter_next = *letter != '\0' ? lv_text_encoded_next(&txt[*ofs], NULL) : 0;
 }
 
+#if LV_TEXT_ASCII_ADV_CACHE_CNT > 0
+void lv_text_ascii_adv_init(void)
+{
+    lv_mutex_init(&ascii_adv_lock);
+}
+
+void lv_text_ascii_adv_deinit(void)
+{
+    lv_mutex_delete(&ascii_adv_lock);
+}
+
+void lv_text_ascii_adv_drop(const lv_font_t * font)
+{
+    lv_mutex_lock(&ascii_adv_lock);
+    uint32_t i;
+    for(i = 0; i < LV_TEXT_ASCII_ADV_CACHE_CNT; i++) {
+        if(font == NULL || ascii_adv_tables[i].font == font) ascii_adv_font_set(&ascii_adv_tables[i], NULL);
+    }
+    lv_mutex_unlock(&ascii_adv_lock);
+}
+#endif
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if LV_TEXT_ASCII_ADV_CACHE_CNT > 0
+/*Fill a free table. `font` is set by the caller once the widths are complete.*/
+static void build_ascii_adv(lv_text_ascii_adv_t * table, const lv_font_t * font)
+{
+    table->kerning = font->kerning;
+
+    uint32_t c;
+    uint32_t c_next;
+    for(c = LV_TEXT_ASCII_ADV_FIRST; c <= LV_TEXT_ASCII_ADV_LAST; c++) {
+        uint16_t w = lv_font_get_glyph_width(font, c, 0);
+        table->adv[c - LV_TEXT_ASCII_ADV_FIRST] = w < ASCII_ADV_SLOW ? w : ASCII_ADV_SLOW;
+    }
+
+    const lv_font_fmt_txt_dsc_t * dsc = font->dsc;
+    if(font->kerning == LV_FONT_KERNING_NONE || (dsc->kern_dsc == NULL && font->fallback == NULL)) return;
+
+    /*Letters with a kerning pair get their width from the font every time*/
+    for(c = LV_TEXT_ASCII_ADV_FIRST; c <= LV_TEXT_ASCII_ADV_LAST; c++) {
+        uint8_t * w = &table->adv[c - LV_TEXT_ASCII_ADV_FIRST];
+        for(c_next = LV_TEXT_ASCII_ADV_FIRST; c_next <= LV_TEXT_ASCII_ADV_LAST && *w != ASCII_ADV_SLOW; c_next++) {
+            if(lv_font_get_glyph_width(font, c, c_next) != *w) *w = ASCII_ADV_SLOW;
+        }
+    }
+}
+#endif
+
+#if LV_TEXT_ASCII_ADV_CACHE_CNT > 0
+/*`*has_free` is false if a new table must not be built: none is free, or the font has a
+ *table built for its other kerning mode, which a draw unit may still be reading*/
+static const uint8_t * find_ascii_adv(const lv_font_t * font, bool * has_free)
+{
+    *has_free = false;
+    uint32_t i;
+    for(i = 0; i < LV_TEXT_ASCII_ADV_CACHE_CNT; i++) {
+        lv_text_ascii_adv_t * table = &ascii_adv_tables[i];
+        const lv_font_t * table_font = ascii_adv_font_get(table);
+        if(table_font == font) {
+            *has_free = false;
+            return table->kerning == font->kerning ? table->adv : NULL;
+        }
+        if(table_font == NULL) *has_free = true;
+    }
+    return NULL;
+}
+#endif
+
+/**
+ * Get the advance widths of the printable ASCII letters of a font, building them on first use.
+ * Safe to call from draw units: tables are looked up without a lock and built under one.
+ * A table in use is never replaced, so once all are taken further fonts are measured
+ * without a table, and so is a font after its kerning was changed: its table keeps its slot
+ * until the font is destroyed.
+ * @param font      pointer to a font
+ * @return          the table indexed by `letter - LV_TEXT_ASCII_ADV_FIRST`, or NULL if
+ *                  the font is not cached
+ */
+static const uint8_t * get_ascii_adv(const lv_font_t * font)
+{
+#if LV_TEXT_ASCII_ADV_CACHE_CNT > 0
+    /*Only LVGL's own fonts have their glyphs fixed for the lifetime of the font*/
+    if(font == NULL || font->get_glyph_dsc != lv_font_get_glyph_dsc_fmt_txt) return NULL;
+
+    bool has_free;
+    const uint8_t * adv = find_ascii_adv(font, &has_free);
+    if(adv || !has_free) return adv;
+
+    /*Another thread may have built it while this one waited*/
+    lv_mutex_lock(&ascii_adv_lock);
+    adv = find_ascii_adv(font, &has_free);
+    uint32_t i;
+    for(i = 0; adv == NULL && i < LV_TEXT_ASCII_ADV_CACHE_CNT; i++) {
+        lv_text_ascii_adv_t * table = &ascii_adv_tables[i];
+        if(table->font != NULL) continue;
+        build_ascii_adv(table, font);
+        ascii_adv_font_set(table, font);
+        adv = table->adv;
+    }
+    lv_mutex_unlock(&ascii_adv_lock);
+    return adv;
+#else
+    LV_UNUSED(font);
+    return NULL;
+#endif
+}
+
+/**
+ * Like `lv_text_encoded_letter_next_2()` but without decoding ASCII letters.
+ */
+static inline void letter_next_2(const char * txt, uint32_t * letter, uint32_t * letter_next, uint32_t * ofs)
+{
+    uint8_t c = (uint8_t)txt[*ofs];
+    if(!LV_IS_ASCII(c)) {
+        lv_text_encoded_letter_next_2(txt, letter, letter_next, ofs);
+        return;
+    }
+
+    *letter = c;
+    (*ofs)++;
+    if(c == '\0') {
+        *letter_next = 0;
+        return;
+    }
+
+    c = (uint8_t)txt[*ofs];
+    *letter_next = LV_IS_ASCII(c) ? c : lv_text_encoded_next(&txt[*ofs], NULL);
+}
+
+/**
+ * Width of a letter followed by `letter_next`, from the ASCII table if possible.
+ */
+static inline int32_t get_letter_width(const lv_font_t * font, const uint8_t * adv, uint32_t letter,
+                                       uint32_t letter_next)
+{
+#if LV_TEXT_ASCII_ADV_CACHE_CNT > 0
+    if(adv != NULL && letter >= LV_TEXT_ASCII_ADV_FIRST && letter <= LV_TEXT_ASCII_ADV_LAST &&
+       (letter_next == 0 || (letter_next >= LV_TEXT_ASCII_ADV_FIRST && letter_next <= LV_TEXT_ASCII_ADV_LAST))) {
+        uint8_t w = adv[letter - LV_TEXT_ASCII_ADV_FIRST];
+        if(w != ASCII_ADV_SLOW) return w;
+    }
+#else
+    LV_UNUSED(adv);
+#endif
+    return lv_font_get_glyph_width(font, letter, letter_next);
+}
+
+/**
+ * Get the end of the line if it fits `max_width` as a whole, so no word wrapping is needed.
+ * The result is the same as what the word by word search of `lv_text_get_next_line()`
+ * would give. When in doubt it gives up and returns 0.
+ * @param txt           a '\0' terminated string, not starting with a line break
+ * @param len           max length of the text in bytes
+ * @param font          pointer to a font
+ * @param adv           ASCII advance widths of the font
+ * @param used_width    set to the width of the line on success. May be NULL.
+ * @param attributes    letter space and max width
+ * @return              length of the line including the line break, or 0 if the line needs wrapping
+ */
+static uint32_t get_unwrapped_line(const char * txt, uint32_t len, const lv_font_t * font, const uint8_t * adv,
+                                   int32_t * used_width, const lv_text_attributes_t * attributes)
+{
+    const int32_t letter_space = attributes->letter_space;
+    const int32_t max_width = attributes->max_width;
+    if(letter_space < 0 || max_width <= 0) return 0;
+    if(txt[0] == '\n' || txt[0] == '\r') return 0;
+
+    int32_t line_w = 0;
+    uint32_t i = 0;
+    uint32_t letter_prev = 0;
+    bool line_end = false;
+    while(i < len) {
+        uint32_t letter;
+        uint32_t letter_next;
+        uint32_t i_next = i;
+        letter_next_2(txt, &letter, &letter_next, &i_next);
+        if(letter == '\0') {
+            line_end = true;
+            break;
+        }
+
+        int32_t letter_w = get_letter_width(font, adv, letter, letter_next);
+        int32_t w = line_w + letter_w;
+        if(letter_w > 0) w += letter_space;
+        if(w - letter_space > max_width) return 0;
+
+        if(letter == '\n' || letter == '\r') {
+            /*Like the word search, take "\r\n" together only if it ends a word*/
+            i = i_next;
+            if(letter == '\r' && letter_next == '\n' &&
+               !lv_text_is_break_char(letter_prev) && !lv_text_is_a_word(letter_prev)) i++;
+            line_end = true;
+            break;
+        }
+
+        /*The word search stops when the line gets exactly full; leave such cases to it*/
+        if(w >= max_width && letter_next != '\0' && letter_next != '\n' && letter_next != '\r') return 0;
+
+        line_w = w;
+        i = i_next;
+        letter_prev = letter;
+    }
+
+    /*Stopped by `len` in the middle of the text*/
+    if(!line_end && txt[i] != '\0') return 0;
+
+    if(used_width) *used_width = line_w;
+    return i;
+}
+
 #if LV_TXT_ENC == LV_TXT_ENC_UTF8
 /*******************************
  *   UTF-8 ENCODER/DECODER
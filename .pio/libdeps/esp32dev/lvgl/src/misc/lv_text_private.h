@@ -40,6 +40,20 @@ typedef enum {
     LV_TEXT_CMD_STATE_IN,   /**< Processing the command*/
 } lv_text_cmd_state_t;
 
+#if LV_TEXT_ASCII_ADV_CACHE_CNT > 0
+#define LV_TEXT_ASCII_ADV_FIRST 0x20
+#define LV_TEXT_ASCII_ADV_LAST  0x7E
+
+/** Advance widths of the printable ASCII characters of a font.
+ *  Draw units read the tables without a lock: `font` is set last, after `adv[]` is complete,
+ *  and a table is never rebuilt while its font exists.*/
+typedef struct {
+    const lv_font_t * font;     /**< NULL: free*/
+    lv_font_kerning_t kerning;  /**< `font->kerning` when the table was built*/
+    uint8_t adv[LV_TEXT_ASCII_ADV_LAST - LV_TEXT_ASCII_ADV_FIRST + 1];
+} lv_text_ascii_adv_t;
+#endif
+
 typedef struct {
     int32_t letter_space;   /**< Letter space between letters*/
     int32_t line_space;     /**< Space between lines of text*/
@@ -87,6 +101,25 @@ int32_t lv_text_get_width(const char * txt, uint32_t length, const lv_font_t * f
  */
 bool lv_text_is_cmd(lv_text_cmd_state_t * state, uint32_t c);
 
+#if LV_TEXT_ASCII_ADV_CACHE_CNT > 0
+/**
+ * Initialize the ASCII advance width tables. Called by `lv_init()`.
+ */
+void lv_text_ascii_adv_init(void);
+
+/**
+ * Free the resources of the ASCII advance width tables. Called by `lv_deinit()`.
+ */
+void lv_text_ascii_adv_deinit(void);
+
+/**
+ * Forget the cached ASCII advance widths of a font. Call it before a font is freed,
+ * or after its glyphs were changed.
+ * @param font      pointer to a font, NULL to drop all fonts
+ */
+void lv_text_ascii_adv_drop(const lv_font_t * font);
+#endif
+
 /**
  * Get the next line of text. Check line length and break chars too.
  * @param txt a '\0' terminated string
@@ -38,6 +38,8 @@
 #endif
 #define state LV_GLOBAL_DEFAULT()->tlsf_state
 
+#define SLAB_MAX_SIZE   256
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -46,10 +48,25 @@
  *  STATIC PROTOTYPES
  **********************/
 static void lv_mem_walker(void * ptr, size_t size, int used, void * user);
+#if LV_MEM_SLAB_SIZE
+    static void slab_init(void);
+    static void * slab_alloc(size_t size);
+    static void slab_free(void * p);
+    static bool slab_owns(const void * p);
+    static size_t slab_size_of(const void * p);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+#if LV_MEM_SLAB_SIZE
+/*Sized for the hot allocations: short texts, event descriptors, styles, widgets and
+ *draw tasks, which carry their draw descriptor in the same allocation*/
+static const uint16_t slab_slot_size[LV_MEM_SLAB_CLASS_CNT] = {16, 32, 48, 64, 96, 128, 192, 256};
+
+/*Size class by (size - 1) / 16*/
+static const uint8_t slab_class_of[SLAB_MAX_SIZE / 16] = {0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7};
+#endif
 
 /**********************
  *      MACROS
@@ -86,6 +103,10 @@ void lv_mem_init(void)
     state.tlsf = lv_tlsf_create_with_pool((void *)LV_MEM_ADR, LV_MEM_SIZE);
 #endif
 
+#if LV_MEM_SLAB_SIZE
+    slab_init();
+#endif
+
     lv_ll_init(&state.pool_ll, sizeof(lv_pool_t));
 
     /*Record the first pool*/
@@ -141,12 +162,17 @@ void * lv_malloc_core(size_t size)
 #if LV_USE_OS
     lv_mutex_lock(&state.mutex);
 #endif
-    void * p = lv_tlsf_malloc(state.tlsf, size);
+    void * p = NULL;
+#if LV_MEM_SLAB_SIZE
+    if(size <= SLAB_MAX_SIZE) p = slab_alloc(size);
+    if(p) state.cur_used += slab_size_of(p);
+#endif
 
-    if(p) {
-        state.cur_used += lv_tlsf_block_size(p);
-        state.max_used = LV_MAX(state.cur_used, state.max_used);
+    if(p == NULL) {
+        p = lv_tlsf_malloc(state.tlsf, size);
+        if(p) state.cur_used += lv_tlsf_block_size(p);
     }
+    state.max_used = LV_MAX(state.cur_used, state.max_used);
 
 #if LV_USE_OS
     lv_mutex_unlock(&state.mutex);
@@ -160,6 +186,24 @@ void * lv_realloc_core(void * p, size_t new_size)
     lv_mutex_lock(&state.mutex);
 #endif
 
+#if LV_MEM_SLAB_SIZE
+    if(slab_owns(p)) {
+        size_t slot_size = slab_size_of(p);
+#if LV_USE_OS
+        lv_mutex_unlock(&state.mutex);
+#endif
+        /*A shrinking block keeps its slot, a growing one moves to a larger class or to TLSF*/
+        if(new_size <= slot_size) return p;
+
+        void * p_new = lv_malloc_core(new_size);
+        if(p_new) {
+            lv_memcpy(p_new, p, slot_size);
+            lv_free_core(p);
+        }
+        return p_new;
+    }
+#endif
+
     size_t old_size = lv_tlsf_block_size(p);
     void * p_new = lv_tlsf_realloc(state.tlsf, p, new_size);
 
@@ -181,8 +225,24 @@ void lv_free_core(void * p)
     lv_mutex_lock(&state.mutex);
 #endif
 
+#if LV_MEM_SLAB_SIZE
+    if(slab_owns(p)) {
+        size_t slot_size = slab_size_of(p);
+#if LV_MEM_ADD_JUNK
+        lv_memset(p, 0xbb, slot_size);   /*Before slab_free() links the slot into the free list*/
+#endif
+        slab_free(p);
+        if(state.cur_used > slot_size) state.cur_used -= slot_size;
+        else state.cur_used = 0;
+#if LV_USE_OS
+        lv_mutex_unlock(&state.mutex);
+#endif
+        return;
+    }
+#endif
+
 #if LV_MEM_ADD_JUNK
-    lv_memset(p, 0xbb, lv_tlsf_block_size(data));
+    lv_memset(p, 0xbb, lv_tlsf_block_size(p));
 #endif
     size_t size = lv_tlsf_block_size(p);
     lv_tlsf_free(state.tlsf, p);
@@ -250,6 +310,27 @@ lv_result_t lv_mem_test_core(void)
     return LV_RESULT_OK;
 }
 
+#if LV_MEM_SLAB_SIZE
+void lv_mem_slab_get_stats(lv_mem_slab_stats_t * stats)
+{
+#if LV_USE_OS
+    lv_mutex_lock(&state.mutex);
+#endif
+    *stats = state.slab.stats;
+#if LV_USE_OS
+    lv_mutex_unlock(&state.mutex);
+#endif
+
+    stats->free_size = 0;
+    uint32_t c;
+    for(c = 0; c < LV_MEM_SLAB_CLASS_CNT; c++) {
+        const lv_mem_slab_class_stats_t * cs = &stats->cls[c];
+        uint32_t slot_cnt = cs->page_cnt * (LV_MEM_SLAB_PAGE_SIZE / cs->slot_size);
+        stats->free_size += (slot_cnt - cs->used_cnt) * cs->slot_size;
+    }
+}
+#endif
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -270,4 +351,144 @@ static void lv_mem_walker(void * ptr, size_t size, int used, void * user)
             mon_p->free_biggest_size = size;
     }
 }
+
+#if LV_MEM_SLAB_SIZE
+
+/*The region is cut into pages. A page with a free slot is on the partial list of its size
+ *class; a page whose last slot is freed goes back to the free pages for any class to use.
+ *Alloc and free only touch the head of these lists and the page of the slot.*/
+
+static void slab_init(void)
+{
+    lv_mem_slab_t * slab = &state.slab;
+    lv_memzero(slab, sizeof(lv_mem_slab_t));
+
+    uint32_t c;
+    for(c = 0; c < LV_MEM_SLAB_CLASS_CNT; c++) {
+        slab->partial[c] = LV_MEM_SLAB_NONE;
+        slab->stats.cls[c].slot_size = slab_slot_size[c];
+    }
+    slab->free_page = LV_MEM_SLAB_NONE;
+
+    /*Taken first, so the region sits at the start of the pool and the rest stays contiguous*/
+    slab->base = lv_tlsf_malloc(state.tlsf, LV_MEM_SLAB_SIZE);
+    if(slab->base == NULL) {
+        LV_LOG_WARN("couldn't reserve the slab region, all allocations use TLSF");
+        return;
+    }
+
+    uint32_t i;
+    for(i = LV_MEM_SLAB_PAGE_CNT; i > 0; i--) {
+        slab->page[i - 1].next = slab->free_page;
+        slab->free_page = i - 1;
+    }
+    slab->stats.total_size = LV_MEM_SLAB_SIZE;
+    slab->stats.page_cnt = LV_MEM_SLAB_PAGE_CNT;
+}
+
+static void slab_partial_add(lv_mem_slab_t * slab, uint8_t c, uint8_t id)
+{
+    lv_mem_slab_page_t * page = &slab->page[id];
+    page->prev = LV_MEM_SLAB_NONE;
+    page->next = slab->partial[c];
+    if(page->next != LV_MEM_SLAB_NONE) slab->page[page->next].prev = id;
+    slab->partial[c] = id;
+}
+
+static void slab_partial_remove(lv_mem_slab_t * slab, uint8_t c, uint8_t id)
+{
+    lv_mem_slab_page_t * page = &slab->page[id];
+    if(page->prev != LV_MEM_SLAB_NONE) slab->page[page->prev].next = page->next;
+    else slab->partial[c] = page->next;
+    if(page->next != LV_MEM_SLAB_NONE) slab->page[page->next].prev = page->prev;
+}
+
+static void * slab_alloc(size_t size)
+{
+    lv_mem_slab_t * slab = &state.slab;
+    uint8_t c = slab_class_of[(size - 1) >> 4];
+    lv_mem_slab_class_stats_t * cs = &slab->stats.cls[c];
+    uint32_t slot_size = slab_slot_size[c];
+
+    uint8_t id = slab->partial[c];
+    if(id == LV_MEM_SLAB_NONE) {
+        id = slab->free_page;
+        if(id == LV_MEM_SLAB_NONE) {
+            cs->fallback_cnt++;
+            return NULL;
+        }
+        slab->free_page = slab->page[id].next;
+
+        lv_mem_slab_page_t * page = &slab->page[id];
+        page->cls = c;
+        page->used = 0;
+        page->bump = 0;
+        page->free_slot = LV_MEM_SLAB_NONE;
+        slab_partial_add(slab, c, id);
+
+        cs->page_cnt++;
+        slab->stats.page_used++;
+        slab->stats.page_used_max = LV_MAX(slab->stats.page_used, slab->stats.page_used_max);
+    }
+
+    lv_mem_slab_page_t * page = &slab->page[id];
+    uint8_t * page_buf = slab->base + id * LV_MEM_SLAB_PAGE_SIZE;
+    uint8_t * slot;
+    if(page->free_slot != LV_MEM_SLAB_NONE) {
+        slot = page_buf + page->free_slot * slot_size;
+        page->free_slot = slot[0];
+    }
+    else {
+        slot = page_buf + page->bump * slot_size;
+        page->bump++;
+    }
+
+    page->used++;
+    if(page->used == LV_MEM_SLAB_PAGE_SIZE / slot_size) slab_partial_remove(slab, c, id);
+
+    cs->alloc_cnt++;
+    cs->used_cnt++;
+    cs->used_max = LV_MAX(cs->used_cnt, cs->used_max);
+    return slot;
+}
+
+static void slab_free(void * p)
+{
+    lv_mem_slab_t * slab = &state.slab;
+    uint32_t ofs = (uint32_t)((uint8_t *)p - slab->base);
+    uint8_t id = ofs / LV_MEM_SLAB_PAGE_SIZE;
+    lv_mem_slab_page_t * page = &slab->page[id];
+    uint8_t c = page->cls;
+    uint32_t slot_size = slab_slot_size[c];
+
+    if(page->used == LV_MEM_SLAB_PAGE_SIZE / slot_size) slab_partial_add(slab, c, id);
+
+    *(uint8_t *)p = page->free_slot;
+    page->free_slot = (ofs % LV_MEM_SLAB_PAGE_SIZE) / slot_size;
+    page->used--;
+    slab->stats.cls[c].used_cnt--;
+
+    if(page->used == 0) {
+        slab_partial_remove(slab, c, id);
+        page->next = slab->free_page;
+        slab->free_page = id;
+        slab->stats.cls[c].page_cnt--;
+        slab->stats.page_used--;
+    }
+}
+
+static bool slab_owns(const void * p)
+{
+    lv_uintptr_t base = (lv_uintptr_t)state.slab.base;
+    return base && (lv_uintptr_t)p >= base && (lv_uintptr_t)p < base + LV_MEM_SLAB_SIZE;
+}
+
+static size_t slab_size_of(const void * p)
+{
+    uint32_t id = (uint32_t)((const uint8_t *)p - state.slab.base) / LV_MEM_SLAB_PAGE_SIZE;
+    return slab_slot_size[state.slab.page[id].cls];
+}
+
+#endif /*LV_MEM_SLAB_SIZE*/
+
 #endif /*LV_STDLIB_BUILTIN*/
@@ -17,16 +17,45 @@ extern "C" {
  *********************/
 
 #include "lv_tlsf.h"
+#include "../lv_mem.h"
 #include "../../osal/lv_os_private.h"
 
 /*********************
  *      DEFINES
  *********************/
 
+#if LV_MEM_SLAB_SIZE
+#define LV_MEM_SLAB_PAGE_CNT    (LV_MEM_SLAB_SIZE / LV_MEM_SLAB_PAGE_SIZE)
+#define LV_MEM_SLAB_NONE        0xFF
+
+#if LV_MEM_SLAB_PAGE_CNT >= LV_MEM_SLAB_NONE
+#error "LV_MEM_SLAB_SIZE is too large"
+#endif
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
 
+#if LV_MEM_SLAB_SIZE
+typedef struct {
+    uint8_t cls;            /**< Owner size class*/
+    uint8_t used;           /**< Slots in use*/
+    uint8_t bump;           /**< Slots from here on were never handed out*/
+    uint8_t free_slot;      /**< First freed slot; each holds the index of the next one*/
+    uint8_t next;           /**< Next page in the partial list of the class or in the free pages*/
+    uint8_t prev;
+} lv_mem_slab_page_t;
+
+typedef struct {
+    uint8_t * base;
+    uint8_t free_page;                          /**< Head of the pages not owned by a class*/
+    uint8_t partial[LV_MEM_SLAB_CLASS_CNT];     /**< Head of the pages of each class with a free slot*/
+    lv_mem_slab_page_t page[LV_MEM_SLAB_PAGE_CNT];
+    lv_mem_slab_stats_t stats;
+} lv_mem_slab_t;
+#endif
+
 typedef struct {
 #if LV_USE_OS
     lv_mutex_t mutex;
@@ -35,6 +64,9 @@ typedef struct {
     size_t cur_used;
     size_t max_used;
     lv_ll_t  pool_ll;
+#if LV_MEM_SLAB_SIZE
+    lv_mem_slab_t slab;
+#endif
 } lv_tlsf_state_t;
 
 /**********************
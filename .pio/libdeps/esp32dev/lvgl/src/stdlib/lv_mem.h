@@ -23,6 +23,10 @@ extern "C" {
  *      DEFINES
  *********************/
 
+/** Page size and number of size classes of the slabs, see `LV_MEM_SLAB_SIZE`*/
+#define LV_MEM_SLAB_PAGE_SIZE   1024
+#define LV_MEM_SLAB_CLASS_CNT   8
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -43,6 +47,30 @@ typedef struct {
     uint8_t frag_pct;   /**< Amount of fragmentation */
 } lv_mem_monitor_t;
 
+/**
+ * Counters of a slab size class
+ */
+typedef struct {
+    uint16_t slot_size;     /**< Bytes per slot*/
+    uint16_t page_cnt;      /**< Pages currently owned by the class*/
+    uint32_t used_cnt;      /**< Slots in use*/
+    uint32_t used_max;      /**< High-water mark of `used_cnt`*/
+    uint32_t alloc_cnt;     /**< Allocations served by the class*/
+    uint32_t fallback_cnt;  /**< Allocations passed to TLSF because no slot and no page was free*/
+} lv_mem_slab_class_stats_t;
+
+/**
+ * Slab information structure.
+ */
+typedef struct {
+    size_t total_size;      /**< Size of the slab region*/
+    size_t free_size;       /**< Free slot bytes in pages owned by a class*/
+    uint16_t page_cnt;
+    uint16_t page_used;     /**< Pages owned by a class*/
+    uint16_t page_used_max; /**< High-water mark of `page_used`*/
+    lv_mem_slab_class_stats_t cls[LV_MEM_SLAB_CLASS_CNT];
+} lv_mem_slab_stats_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -155,6 +183,15 @@ lv_result_t lv_mem_test(void);
  */
 void lv_mem_monitor(lv_mem_monitor_t * mon_p);
 
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN && LV_MEM_SLAB_SIZE
+/**
+ * Give information about the slabs in front of the builtin heap.
+ * The slab region is a single used block for `lv_mem_monitor()`.
+ * @param stats     pointer to a lv_mem_slab_stats_t variable to fill
+ */
+void lv_mem_slab_get_stats(lv_mem_slab_stats_t * stats);
+#endif
+
 /**********************
  *      MACROS
  **********************/
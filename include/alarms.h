@@ -0,0 +1,93 @@
+#pragma once
+// alarms.h - threshold alarms on decoded fields, with hysteresis and debounce
+
+#include "shared.h"
+
+// Rules are a constant table (alarms.cpp, in flash) of {field, comparator,
+// threshold, hysteresis, debounce, severity}. A rule raises once its field has been
+// past the threshold for the debounce time, and clears when the value is back by
+// the hysteresis. The rules are linked per field, so a frame only evaluates the
+// rules of the fields it carried. Debounce is checked when the field arrives, so a
+// raise can come up to one field period after the debounce time.
+//
+// The active alarm of the highest severity (the earliest rule among equals) is
+// shown in a fixed-size badge on LVGL's top layer, over every screen. The badge is
+// only touched when the alarm it shows changes.
+//
+// Values are in the DashboardData units, voltage and current in 0.01 V and 0.01 A
+// (as in telemetry_log.h).
+
+// ===== Alarm configuration (override with build_flags) =====
+#ifndef ALARM_BATT_TEMP_WARN_C
+#define ALARM_BATT_TEMP_WARN_C    55
+#endif
+#ifndef ALARM_BATT_TEMP_CRIT_C
+#define ALARM_BATT_TEMP_CRIT_C    60
+#endif
+#ifndef ALARM_MOTOR_TEMP_WARN_C
+#define ALARM_MOTOR_TEMP_WARN_C   100
+#endif
+#ifndef ALARM_MOTOR_TEMP_CRIT_C
+#define ALARM_MOTOR_TEMP_CRIT_C   120
+#endif
+#ifndef ALARM_SOC_WARN_PCT
+#define ALARM_SOC_WARN_PCT        20
+#endif
+#ifndef ALARM_SOC_CRIT_PCT
+#define ALARM_SOC_CRIT_PCT        10
+#endif
+#ifndef ALARM_CURRENT_WARN_A
+#define ALARM_CURRENT_WARN_A      150     // discharge
+#endif
+#ifndef ALARM_CURRENT_CRIT_A
+#define ALARM_CURRENT_CRIT_A      200
+#endif
+#ifndef ALARM_BENCH_RULES
+#define ALARM_BENCH_RULES         128     // "alarmbench" serial command
+#endif
+#ifndef ALARM_BENCH_FRAMES
+#define ALARM_BENCH_FRAMES        2000
+#endif
+
+typedef enum {
+  ALARM_ABOVE = 0,           // raised while value > threshold
+  ALARM_BELOW                // raised while value < threshold
+} alarm_cmp_t;
+
+typedef enum {
+  ALARM_WARNING = 0,
+  ALARM_CRITICAL             // drawn at once, ahead of the rest of the frame
+} alarm_severity_t;
+
+typedef struct {
+  uint8_t field;             // ID_*
+  uint8_t cmp;               // alarm_cmp_t
+  uint8_t severity;          // alarm_severity_t
+  uint16_t debounce_ms;      // past the threshold this long before raising
+  int32_t threshold;
+  int32_t hysteresis;        // cleared at threshold -/+ hysteresis
+  const char *text;          // badge text
+} alarm_rule_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Link the rule table and create the badge. Call once the display exists.
+void alarms_begin(void);
+
+// Evaluate the rules of the fields decoded from the current frame. Call with
+// lv_lock() held, before the frame's UI updates. Returns true if a critical alarm
+// was raised: refresh the display right away, or make the refresh timer due where
+// the caller can't render.
+bool alarms_frame(const uint8_t *ids, uint8_t count);
+
+// Time `frames` synthetic frames against `rules` generated rules, evaluating the
+// fields each frame carried and, for comparison, every rule. Prints over Serial,
+// takes lv_lock() itself and leaves the real alarms untouched. Returns the
+// average cost of a frame in ns.
+uint32_t alarms_bench(uint16_t rules, uint16_t frames);
+
+#ifdef __cplusplus
+}
+#endif
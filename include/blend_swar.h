@@ -0,0 +1,33 @@
+#pragma once
+// blend_swar.h - two-pixels-per-word RGB565 blend kernels for LVGL's software renderer
+//
+// Selected in lv_conf.h with LV_USE_DRAW_SW_ASM = LV_DRAW_SW_ASM_CUSTOM and
+// LV_DRAW_SW_ASM_CUSTOM_INCLUDE = "blend_swar.h". LVGL includes this header from
+// its blend sources and calls the kernels through the hook macros below; paths
+// without a hook (plain image copy, other formats) keep LVGL's own C code.
+// Results are bit-identical to lv_color_16_16_mix() (test/test_blend_swar).
+
+#include <src/misc/lv_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+lv_result_t blend_swar_color_to_rgb565(lv_draw_sw_blend_fill_dsc_t *dsc);
+lv_result_t blend_swar_color_to_rgb565_with_opa(lv_draw_sw_blend_fill_dsc_t *dsc);
+lv_result_t blend_swar_color_to_rgb565_with_mask(lv_draw_sw_blend_fill_dsc_t *dsc);
+lv_result_t blend_swar_rgb565_to_rgb565_with_opa(lv_draw_sw_blend_image_dsc_t *dsc);
+lv_result_t blend_swar_rgb565_to_rgb565_with_mask(lv_draw_sw_blend_image_dsc_t *dsc);
+
+#ifdef __cplusplus
+}
+#endif
+
+// ===== LVGL hooks =====
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565(dsc)                       blend_swar_color_to_rgb565(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA(dsc)              blend_swar_color_to_rgb565_with_opa(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_MASK(dsc)             blend_swar_color_to_rgb565_with_mask(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_MIX_MASK_OPA(dsc)          blend_swar_color_to_rgb565_with_mask(dsc)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)      blend_swar_rgb565_to_rgb565_with_opa(dsc)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)     blend_swar_rgb565_to_rgb565_with_mask(dsc)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)  blend_swar_rgb565_to_rgb565_with_mask(dsc)
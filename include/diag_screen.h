@@ -0,0 +1,16 @@
+#pragma once
+// diag_screen.h - on-device view of the runtime metrics
+
+#include "shared.h"
+#include "screen_mgr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// SCREEN_DIAG. Values refresh every METRICS_SAMPLE_INTERVAL_MS while it is shown.
+extern const screen_desc_t diag_screen_desc;
+
+#ifdef __cplusplus
+}
+#endif
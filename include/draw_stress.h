@@ -0,0 +1,32 @@
+#pragma once
+// draw_stress.h - draw-task-heavy screen for timing the renderer
+
+#include "shared.h"
+
+// A grid of small bordered, labelled tiles: each one is a background, a border and a
+// label draw task, so every band carries dozens of tasks that overlap their neighbours'
+// edges. Started with the "stress" serial command.
+
+// ===== Draw stress configuration (override with build_flags) =====
+#ifndef DRAW_STRESS_COLS
+#define DRAW_STRESS_COLS     12
+#endif
+#ifndef DRAW_STRESS_ROWS
+#define DRAW_STRESS_ROWS     10
+#endif
+#ifndef DRAW_STRESS_FRAMES
+#define DRAW_STRESS_FRAMES   20     // full redraws per run
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Show the stress screen, redraw it `frames` times, print the render times over
+// Serial and return to the previous screen. Takes lv_lock() itself.
+// Returns the average render time of a frame in microseconds.
+uint32_t draw_stress_run(uint16_t frames);
+
+#ifdef __cplusplus
+}
+#endif
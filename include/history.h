@@ -0,0 +1,56 @@
+#pragma once
+// history.h - on-device per-signal trend history (min/max/avg buckets)
+
+#include "shared.h"
+
+// ===== Resolution levels (override with build_flags) =====
+// Every signal keeps one ring of buckets per level. Defaults cover
+// 10 min at 1 s, 1 h at 10 s and 4 h at 60 s.
+#ifndef HIST_L0_BUCKETS
+#define HIST_L0_BUCKETS   600   // 1 s buckets
+#endif
+#ifndef HIST_L1_BUCKETS
+#define HIST_L1_BUCKETS   360   // 10 s buckets
+#endif
+#ifndef HIST_L2_BUCKETS
+#define HIST_L2_BUCKETS   240   // 60 s buckets
+#endif
+
+// RAM allowed for all rings (esp32dev has no PSRAM); checked at compile time
+#ifndef HIST_BUDGET_BYTES
+#define HIST_BUDGET_BYTES (40 * 1024)
+#endif
+
+// Tracked signals. Power is voltage x current in 10 W units, the rest use
+// their DashboardData units.
+typedef enum {
+  HIST_SPEED = 0,
+  HIST_POWER,
+  HIST_SOC,
+  HIST_BATTERY_TEMP,
+  HIST_MOTOR_TEMP,
+  HIST_SIGNAL_COUNT
+} hist_signal_t;
+
+// One bucket or query column. min > max marks a period without samples.
+typedef struct {
+  int16_t min;
+  int16_t max;
+  int16_t avg;
+} hist_point_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Add the current dashData value(s) belonging to a decoded field ID
+void history_record(uint8_t id);
+
+// Fill `columns` points covering the last `span_ms`, oldest first, using the
+// finest level whose bucket fits a column. Cost is O(columns + buckets in span);
+// raw samples are never stored. Returns the number of columns written.
+uint16_t history_query(hist_signal_t sig, uint32_t span_ms, hist_point_t *out, uint16_t columns);
+
+#ifdef __cplusplus
+}
+#endif
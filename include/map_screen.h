@@ -0,0 +1,52 @@
+#pragma once
+// map_screen.h - offline map centred on the position sent by the controller
+
+#include "shared.h"
+#include "screen_mgr.h"
+
+// The map pane is north up with the vehicle in the middle. Position and heading come
+// over RS485 (ID_LATITUDE, ID_LONGITUDE, ID_HEADING); each update pans the pane and
+// redraws it from cached tiles (map_tiles.h). Tiles just ahead in the direction of
+// travel (the heading, or the last movement without one) are requested for prefetch,
+// which loop() reads when LVGL has nothing due for a while. The tile cache is
+// allocated with the screen and freed when the screen manager drops it.
+
+// ===== Map screen configuration (override with build_flags) =====
+// A pane of up to 2 x 2 tiles overlaps at most 3 x 3 of them, all cached while in
+// view: 128 x 128 keeps that at 72 KB of heap
+#ifndef MAP_SCREEN_VIEW_W
+#define MAP_SCREEN_VIEW_W          128
+#endif
+#ifndef MAP_SCREEN_VIEW_H
+#define MAP_SCREEN_VIEW_H          128
+#endif
+#ifndef MAP_SCREEN_ZOOM
+#define MAP_SCREEN_ZOOM            16      // first zoom level, clamped to the pack
+#endif
+#ifndef MAP_SCREEN_PREFETCH_DEPTH
+#define MAP_SCREEN_PREFETCH_DEPTH  1       // tile columns/rows requested ahead of the view
+#endif
+#ifndef MAP_SCREEN_LOAD_MS
+#define MAP_SCREEN_LOAD_MS         8       // prefetch only if LVGL has nothing due for this long
+#endif
+#ifndef MAP_SCREEN_LOAD_BUDGET_US
+#define MAP_SCREEN_LOAD_BUDGET_US  15000   // visible misses read per map_screen_poll()
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// SCREEN_MAP
+extern const screen_desc_t map_screen_desc;
+
+// dashData's position or heading changed. Call with lv_lock() held.
+void map_screen_position_changed(void);
+
+// Read missing and prefetched tiles. Call from loop() with the return value of
+// lv_timer_handler() (ms until LVGL's next timer is due).
+void map_screen_poll(uint32_t idle_ms);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,94 @@
+#pragma once
+// map_tiles.h - offline map tiles read from a pack file on the SD card, cached in RAM
+
+#include "shared.h"
+
+// Tiles are MAP_TILE_SIZE pixels square in web mercator, with the world 256 << zoom
+// pixels wide (the usual slippy map scale, every 256 px tile cut in 4 x 4). The pack
+// (tools/map_pack.py) holds rectangles of tiles for a few zoom levels, little endian:
+//
+//   header     "DMAP", uint8_t version, uint8_t zoom_cnt, uint16_t tile_size
+//   zoom table zoom_cnt x { uint8_t zoom, 3 pad, int32_t x0, int32_t y0,
+//                           uint16_t cols, uint16_t rows, uint32_t first_entry }
+//   directory  one entry per tile, row by row for each zoom:
+//                         { uint32_t offset, uint16_t size, uint8_t encoding, uint8_t pad }
+//   tile data  RGB565 as LVGL draws it, raw or run-length encoded
+//
+// A tile's directory entry is first_entry + row * cols + col, so finding a tile is one
+// read at a computed offset, never a directory walk. The entry index is also the
+// tile's key in the cache.
+//
+// Decoded tiles stay in a cache of up to MAP_TILE_CACHE_TILES buffers, allocated one
+// at a time so a fragmented heap can still hold them. Drawing uses the cached pixels
+// directly. Tiles inside the view are never evicted; the least recently drawn other
+// tile makes room. Tiles are read from loop(), visible misses first, then prefetch
+// requests when there's time for them.
+
+#define MAP_TILE_SIZE        64                 // fixed by the pack format
+#define MAP_TILE_BYTES       (MAP_TILE_SIZE * MAP_TILE_SIZE * 2)
+#define MAP_TILE_NONE        UINT32_MAX         // outside the pack
+
+// ===== Map tile configuration (override with build_flags) =====
+#ifndef MAP_TILE_PACK
+#define MAP_TILE_PACK          "/map/tiles.bin"
+#endif
+#ifndef MAP_TILE_CACHE_TILES
+#define MAP_TILE_CACHE_TILES   12               // 8 KB each: the view's 3 x 3 and a few prefetched
+#endif
+#ifndef MAP_TILE_HEAP_RESERVE
+#define MAP_TILE_HEAP_RESERVE  (48 * 1024)      // grow the cache only while this much system heap stays free
+#endif
+#ifndef MAP_TILE_PREFETCH_QUEUE
+#define MAP_TILE_PREFETCH_QUEUE 8
+#endif
+
+typedef enum {
+  MAP_TILE_RAW = 0,       // MAP_TILE_BYTES of RGB565
+  MAP_TILE_RLE = 1,       // control byte c: c < 0x80 literal of c + 1 pixels follows,
+                          // else one pixel repeated (c & 0x7F) + 1 times follows
+} map_tile_encoding_t;
+
+typedef enum {
+  MAP_TILES_IDLE = 0,     // nothing was waiting
+  MAP_TILES_LOADED,       // a tile in the view was loaded: redraw
+  MAP_TILES_PREFETCHED,
+  MAP_TILES_NO_BUFFER,    // every buffer holds a visible tile
+} map_tiles_result_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Open the pack and allocate `min_tiles` buffers up front (the rest on demand).
+// Returns false, with nothing kept, if the pack is missing or the buffers don't fit.
+bool map_tiles_begin(uint8_t min_tiles);
+
+// Free every buffer and close the pack
+void map_tiles_end(void);
+
+// Zoom levels present in the pack; false if the pack isn't open
+bool map_tiles_zoom_range(uint8_t *min, uint8_t *max);
+
+// Directory index of a tile, or MAP_TILE_NONE if the pack doesn't cover it
+uint32_t map_tiles_index(uint8_t zoom, int32_t x, int32_t y);
+
+// Cached image of a tile for lv_draw_image(), or NULL. Marks it as just used.
+// Call with lv_lock() held; the image stays valid until the lock is released.
+const lv_image_dsc_t *map_tiles_get(uint32_t index);
+
+// Tiles now visible, in tile coordinates (inclusive). Counts hits and misses for the
+// tiles that came into view. Call with lv_lock() held.
+void map_tiles_set_view(uint8_t zoom, const lv_area_t *tiles);
+
+// Ask for a tile that is likely to come into view. Ignored if it is cached or outside
+// the pack; the oldest request is dropped when the queue is full.
+void map_tiles_prefetch(uint8_t zoom, int32_t x, int32_t y);
+
+// Read one tile: the uncached one nearest the centre of the view, else (if `prefetch`)
+// the newest prefetch request. A tile that fails to read or decode is cached blank.
+// Call from loop() without lv_lock() held; the SD read happens outside the lock.
+map_tiles_result_t map_tiles_load_next(bool prefetch);
+
+#ifdef __cplusplus
+}
+#endif
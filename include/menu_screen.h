@@ -0,0 +1,16 @@
+#pragma once
+// menu_screen.h - menu opened from the dashboard's menu button
+
+#include "shared.h"
+#include "screen_mgr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// SCREEN_MENU: one button per screen reachable from the dashboard
+extern const screen_desc_t menu_screen_desc;
+
+#ifdef __cplusplus
+}
+#endif
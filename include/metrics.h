@@ -0,0 +1,100 @@
+#pragma once
+// metrics.h - runtime counters, gauges and latency histograms
+
+#include "shared.h"
+
+// All metrics live in static arrays indexed by the enums below; updates are
+// relaxed 32-bit atomics, so any task on either core may feed them without a lock.
+// A counter only goes up, a gauge holds the last value set, and a histogram counts
+// microsecond samples in fixed buckets (METRICS_BUCKET_US) and keeps the maximum.
+
+// ===== Metrics configuration (override with build_flags) =====
+#ifndef METRICS_SAMPLE_INTERVAL_MS
+#define METRICS_SAMPLE_INTERVAL_MS  500   // heap gauges and the diagnostics screen
+#endif
+
+// Upper bounds of the histogram buckets in us; one more bucket takes the rest
+#define METRICS_BUCKET_US  { 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000 }
+#define METRICS_BUCKETS    11
+
+typedef enum {
+  // RS485 parser
+  MET_RS485_BYTES = 0,      // counter
+  MET_RS485_FRAMES,         // counter, valid frames
+  MET_RS485_BAD_FRAMES,     // counter, complete frames failing ETX/CRC
+  MET_RS485_RESYNCS,        // counter, frames dropped for a bad length or overflow
+  MET_RS485_SILENCES,       // counter, times the bus went silent (see staleness.h)
+  MET_STALE_FIELDS,         // gauge, fields past their expected period
+  MET_RS485_STACK_FREE,     // gauge, bytes of the RS485 task's stack never used (DASH_DUAL_CORE)
+  // Display
+  MET_RENDERS,              // counter, refreshes that drew something
+  MET_FLUSH_PIXELS,         // counter
+  MET_TOUCH_PRESSES,        // counter
+  // Screens
+  MET_SCREEN_BUILDS,        // counter, preloads included
+  MET_SCREEN_PRELOADS,      // counter
+  MET_SCREEN_EVICTIONS,     // counter
+  MET_SCREENS_RESIDENT,     // gauge
+  // Map tiles
+  MET_MAP_TILE_HITS,        // counter, tiles coming into view already cached
+  MET_MAP_TILE_MISSES,      // counter, tiles coming into view that had to be read first
+  MET_MAP_TILE_LOADS,       // counter, tiles read from the SD card, prefetches included
+  MET_MAP_PREFETCH_HITS,    // counter, prefetched tiles that came into view
+  MET_MAP_TILES_CACHED,     // gauge
+  // Alarms
+  MET_ALARM_RULE_EVALS,     // counter, alarm rules evaluated
+  MET_ALARM_RAISES,         // counter
+  MET_ALARMS_ACTIVE,        // gauge
+  // Trip log
+  MET_TLOG_DROPPED,         // counter, blocks lost while both write buffers were full
+  MET_TLOG_WRITE_ERRORS,    // counter, write buffers the SD card did not take in full
+  // Heap (sampled by metrics_poll())
+  MET_LV_HEAP_USED,         // gauge, bytes taken from the pool (with headers and slab pages)
+  MET_LV_HEAP_PEAK_ALLOC,   // gauge, most bytes allocated at once
+  MET_LV_HEAP_BIGGEST_FREE, // gauge, bytes in the largest free block
+  MET_LV_HEAP_FRAG,         // gauge, %
+  MET_SYS_HEAP_FREE,        // gauge, bytes
+  MET_SYS_HEAP_MIN_FREE,    // gauge, bytes
+  MET_SYS_HEAP_LARGEST,     // gauge, bytes in the largest free internal block
+  METRIC_COUNT
+} metric_t;
+
+typedef enum {
+  MET_H_RS485_FRAME = 0,    // processCompleteFrame(), including the UI update (and render, without DASH_DUAL_CORE)
+  MET_H_RENDER,             // LV_EVENT_RENDER_START..READY
+  MET_H_FLUSH,              // one flush_cb() call
+  MET_H_TOUCH_READ,         // one touch controller poll
+  MET_H_SCREEN_BUILD,       // one screen build
+  MET_H_SCREEN_SHOW,        // screen_mgr_show() up to the screen load, a build included
+  MET_H_MAP_TILE_LOAD,      // one tile read from the SD card and decoded
+  METRIC_HIST_COUNT
+} metric_hist_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void metrics_add(metric_t m, uint32_t n);
+void metrics_set(metric_t m, uint32_t v);
+uint32_t metrics_get(metric_t m);
+
+void metrics_observe_us(metric_hist_t h, uint32_t us);
+
+// Feed MET_RENDERS, MET_FLUSH_PIXELS, MET_H_RENDER and MET_H_FLUSH from the display's events
+void metrics_attach_display(lv_display_t *disp);
+
+// Sample the heap gauges every METRICS_SAMPLE_INTERVAL_MS. Call from loop().
+void metrics_poll(void);
+
+// Rows for printing: the metrics, then the histograms
+#define METRICS_ROWS  (METRIC_COUNT + METRIC_HIST_COUNT)
+const char *metrics_row_name(uint16_t row);
+// "1234" or, for a histogram, "n=.. p50<=.. p99<=.. max=.." in us (bucket bounds)
+void metrics_row_value(uint16_t row, char *buf, size_t size);
+
+// Print "name counter|gauge|hist value" per row to Serial
+void metrics_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+// num_label.h - numeric readout with tabular digit cells and a fixed size
+
+#include "shared.h"
+
+// "<prefix><number><suffix>", e.g. "Volt: " + " 72.40" + " V". Every digit position
+// is a fixed cell as wide as the font's widest digit, so the object is sized once
+// for the widest value in [min, max] and never resizes or relayouts. A new value
+// invalidates only the cells whose character changed.
+//
+// Values are fixed-point: `value` counts units of 10^-decimals (72.40 V with
+// decimals = 2 is 7240). Values outside [min, max] are clamped.
+
+#define NUM_LABEL_MAX_CELLS  12
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Font, color and letter space come from the object's text styles
+lv_obj_t *num_label_create(lv_obj_t *parent, int32_t min, int32_t max, uint8_t decimals);
+
+// Constant text around the number (copied). NULL for none.
+void num_label_set_text(lv_obj_t *obj, const char *prefix, const char *suffix);
+
+void num_label_set_value(lv_obj_t *obj, int32_t value);
+
+int32_t num_label_get_value(lv_obj_t *obj);
+
+#ifdef __cplusplus
+}
+#endif
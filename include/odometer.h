@@ -0,0 +1,49 @@
+#pragma once
+// odometer.h - power-fail-safe odometer/trip persistence
+
+#include "shared.h"
+
+// ===== Save policy (override with build_flags) =====
+// A record is appended when the odometer moved by ODO_SAVE_DISTANCE_KM, or when
+// only the trip changed and ODO_SAVE_INTERVAL_MS passed since the last write.
+#ifndef ODO_SAVE_DISTANCE_KM
+#define ODO_SAVE_DISTANCE_KM   1
+#endif
+#ifndef ODO_SAVE_INTERVAL_MS
+#define ODO_SAVE_INTERVAL_MS   60000
+#endif
+
+// Flash partition used by odometer_partition_flash() (see partitions.csv)
+#define ODO_PARTITION_LABEL    "odo"
+#define ODO_PARTITION_SUBTYPE  0x40
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Raw flash access. Addresses are relative to the start of the store.
+// Erased flash reads back as 0xFF; writes may only clear bits.
+typedef struct {
+  bool (*read)(uint32_t addr, void *buf, uint32_t len);
+  bool (*write)(uint32_t addr, const void *buf, uint32_t len);
+  bool (*erase_sector)(uint32_t sector);
+  uint32_t sector_size;
+  uint16_t sector_count;   // at least 2
+} odo_flash_t;
+
+// Flash backend over the "odo" data partition, NULL if the partition is missing
+const odo_flash_t *odometer_partition_flash(void);
+
+// Find the newest valid record and restore dashData.odo/trip from it.
+// Returns false if the store is empty or unusable (dashData is left untouched).
+bool odometer_init(const odo_flash_t *flash);
+
+// Append a record if dashData.odo/trip moved past the save policy. Call periodically.
+void odometer_update(void);
+
+// Number of records written since boot (for writes-per-km measurements)
+uint32_t odometer_write_count(void);
+
+#ifdef __cplusplus
+}
+#endif
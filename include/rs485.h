@@ -5,6 +5,11 @@
 #include <Arduino.h>
 #include "ui.h"
 
+// ===== RS485 task configuration (override with build_flags) =====
+#ifndef RS485_TASK_STACK
+#define RS485_TASK_STACK  8192   // bytes; see the rs485.stack_free metric
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -15,6 +20,11 @@ extern "C" {
 
 // Call from loop() (or from an RS485 task)
 void read_rs485_frames(void);
+
+// Run read_rs485_frames() in its own FreeRTOS task (only when LV_USE_OS is set).
+// The task parses frames and updates the widgets; loop()'s lv_timer_handler()
+// renders them. Returns false if loop() has to keep polling.
+bool rs485_start_task(void);
 uint16_t calculateChecksum(const uint8_t *data, uint16_t length);
 bool validateFrame(uint8_t* frame, uint16_t len);
 
@@ -0,0 +1,95 @@
+#pragma once
+// screen_mgr.h - screens built on first use and kept within memory budgets
+
+#include "shared.h"
+
+// A screen is built the first time it's shown and stays resident afterwards, so
+// going back to it is a single screen load. At most SCREEN_MGR_MAX_RESIDENT screens
+// are kept. Before a build, and whenever the free LVGL heap drops below
+// SCREEN_MGR_LV_RESERVE, the least recently shown screen that is neither active nor
+// pinned is deleted. The heap cost of every build is measured and used for the next
+// one. While the touch screen is idle the screen most often opened from the active
+// one is built ahead of time, if it fits without deleting anything.
+
+// ===== Screen manager configuration (override with build_flags) =====
+#ifndef SCREEN_MGR_MAX_RESIDENT
+#define SCREEN_MGR_MAX_RESIDENT  3             // built screens, pinned ones included
+#endif
+#ifndef SCREEN_MGR_LV_RESERVE
+#define SCREEN_MGR_LV_RESERVE    (12 * 1024)   // LVGL heap kept free for draw tasks and texts
+#endif
+#ifndef SCREEN_MGR_SYS_RESERVE
+#define SCREEN_MGR_SYS_RESERVE   (32 * 1024)   // system heap kept free after a build
+#endif
+#ifndef SCREEN_MGR_IDLE_MS
+#define SCREEN_MGR_IDLE_MS       2000          // no touch for this long before preloading
+#endif
+#ifndef SCREEN_MGR_POLL_MS
+#define SCREEN_MGR_POLL_MS       250           // heap check and preload period
+#endif
+#ifndef SCREEN_MGR_BACK_DEPTH
+#define SCREEN_MGR_BACK_DEPTH    4             // screens remembered for screen_mgr_back()
+#endif
+
+typedef enum {
+  SCREEN_DASHBOARD = 0,
+  SCREEN_MENU,
+  SCREEN_SETTINGS,
+  SCREEN_DIAG,
+  SCREEN_TRENDS,
+  SCREEN_MAP,
+  SCREEN_COUNT
+} screen_id_t;
+
+typedef struct {
+  const char *name;
+  // Create the screen with lv_obj_create(NULL); the manager loads it. Modules that
+  // keep pointers into it clear them on the screen's LV_EVENT_DELETE.
+  // NULL: not enough memory.
+  lv_obj_t *(*build)(void);
+  void (*on_show)(lv_obj_t *scr);   // optional, right before it's loaded
+  void (*on_hide)(lv_obj_t *scr);   // optional, after another screen was loaded
+  uint32_t lv_cost_hint;            // LVGL heap bytes, until a build measured them
+  uint32_t sys_cost_hint;           // system heap bytes, until a build measured them
+  screen_id_t likely_next;          // preload guess until switches were seen; SCREEN_COUNT: none
+  bool pinned;                      // never deleted once built
+} screen_desc_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// `desc` must stay valid. Register every screen before screen_mgr_begin().
+void screen_mgr_register(screen_id_t id, const screen_desc_t *desc);
+
+// Start the heap check and preload timer
+void screen_mgr_begin(void);
+
+// Build `id` if needed and load it. The active screen is pushed on the back stack.
+// Returns false (and stays on the active screen) if it couldn't be built.
+bool screen_mgr_show(screen_id_t id);
+
+// Return to the previous screen, or the dashboard
+void screen_mgr_back(void);
+
+// Build `id` without loading it, only if it fits without deleting another screen
+bool screen_mgr_preload(screen_id_t id);
+
+// Delete `id` (unless active) so its next show builds it again, e.g. after a setting changed
+void screen_mgr_drop(screen_id_t id);
+
+// NULL if not built
+lv_obj_t *screen_mgr_get(screen_id_t id);
+
+// SCREEN_COUNT until the first screen_mgr_show()
+screen_id_t screen_mgr_active(void);
+
+// Top bar with a back button (screen_mgr_back()) and a centred title
+lv_obj_t *screen_mgr_top_bar(lv_obj_t *scr, const char *title);
+
+// Print one line per screen (built, cost, last shown) to Serial. Call with lv_lock() held.
+void screen_mgr_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,26 @@
+#pragma once
+// settings_screen.h - runtime UI settings and the screen that changes them
+
+#include "shared.h"
+#include "screen_mgr.h"
+#include "trend_chart.h"
+
+// Kept in RAM only; every boot starts from the defaults
+typedef struct {
+  uint32_t trend_span_ms;         // time covered by the trend chart
+  trend_chart_mode_t trend_mode;
+  uint32_t stale_fast_ms;         // period of speed, voltage and current (see staleness.h)
+} ui_settings_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern ui_settings_t ui_settings;
+
+// SCREEN_SETTINGS
+extern const screen_desc_t settings_screen_desc;
+
+#ifdef __cplusplus
+}
+#endif
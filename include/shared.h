@@ -24,6 +24,17 @@
 #define ID_ODOMETER      0x8C
 #define ID_AVG_SPEED     0x8D
 
+// Field lengths by ID block, so a parser can skip IDs it doesn't know:
+//   0x80..0x8F  2 bytes (ID_SOC, ID_MODE, ID_ARMED: 1, ID_ODOMETER: 4)
+//   0x90..0x97  4 bytes
+//   0x98..0x9F  2 bytes
+//   other       1 byte
+// Firmware from before the 0x90 blocks skips their fields as 1 byte and loses
+// the rest of the frame, so only send them to dashboards that know them.
+#define ID_LATITUDE      0x90  // int32, 1e-7 degrees
+#define ID_LONGITUDE     0x91  // int32, 1e-7 degrees
+#define ID_HEADING       0x98  // uint16, 0.1 degrees clockwise from north
+
 // Driving Modes enum
 enum DrivingMode {
   MODE_ECO = 0,
@@ -46,6 +57,9 @@ struct DashboardData {
   int soc;
   float voltage;
   float current;
+  int32_t latitude;   // 1e-7 degrees
+  int32_t longitude;
+  int heading;        // degrees, -1 until the controller sends one
 };
 
 // ===== Extern globals (defined in ONE .cpp only) =====
@@ -53,8 +67,6 @@ struct DashboardData {
 extern DashboardData dashData;
 extern lv_display_t *disp;
 extern void *draw_buf;
-extern uint8_t *image_data;
-extern uint32_t image_size;
 
 // UI object pointers (created in UI module)
 extern lv_obj_t *speed_label;
@@ -84,7 +96,6 @@ extern lv_obj_t *time_label;
 // void update_ui_element(uint8_t id);
 // void update_time_display();
 // void create_ev_dashboard_ui();
-// bool load_image_to_ram(const char *path);
 
 // NOTE: serialBuffer & bufferPos are intentionally NOT externed here.
 // Keep them local to rs485.cpp for encapsulation (recommended).
@@ -0,0 +1,54 @@
+#pragma once
+// staleness.h - per-signal freshness tracking and RS485 bus-silence detection
+
+#include "shared.h"
+
+// Every decoded field has an expected period. A field that doesn't arrive again
+// within its period is marked stale in the UI (ui_set_stale()) until it does. When
+// no valid frame arrives for the shortest field period (but at least STALE_BUS_MS)
+// all fields go stale at once, so a controller that meets every field's period
+// never trips bus silence between its frames.
+//
+// Deadlines sit in a timing wheel of STALE_WHEEL_SLOTS slots of STALE_TICK_MS. An
+// arrival moves its field to the slot of its new deadline, and each timer pass only
+// visits the slots that became due since the last one. Healthy fields are always
+// re-armed before their slot comes up, so a pass costs O(expired).
+
+// ===== Staleness configuration (override with build_flags) =====
+#ifndef STALE_TICK_MS
+#define STALE_TICK_MS        100    // deadline resolution and timer period
+#endif
+#ifndef STALE_WHEEL_SLOTS
+#define STALE_WHEEL_SLOTS    64     // periods up to STALE_TICK_MS * (slots - 2)
+#endif
+#ifndef STALE_FAST_MS
+#define STALE_FAST_MS        1000   // speed, voltage, current
+#endif
+#ifndef STALE_SLOW_MS
+#define STALE_SLOW_MS        5000   // everything else
+#endif
+#ifndef STALE_BUS_MS
+#define STALE_BUS_MS         500    // no valid frame at all: lower bound
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Arm every field with its period from now. Call once the UI exists.
+void staleness_begin(void);
+
+// A valid frame arrived (re-arms the bus deadline). Call with lv_lock() held.
+void staleness_frame(void);
+
+// Field `id` was decoded from the current frame. Call with lv_lock() held.
+void staleness_touch(uint8_t id);
+
+bool staleness_is_stale(uint8_t id);
+
+// Change the expected period of a field; applies from its next arrival
+void staleness_set_period(uint8_t id, uint32_t period_ms);
+
+#ifdef __cplusplus
+}
+#endif
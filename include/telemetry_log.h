@@ -0,0 +1,54 @@
+#pragma once
+// telemetry_log.h - columnar, delta-encoded trip log on the SD card
+
+#include "shared.h"
+
+// ===== Log configuration (override with build_flags) =====
+#ifndef TLOG_COLUMN_BYTES
+#define TLOG_COLUMN_BYTES      96     // varint payload per signal before a block is closed
+#endif
+#ifndef TLOG_WRITE_BUF_BYTES
+#define TLOG_WRITE_BUF_BYTES   4096   // one SD write; two of these are double-buffered
+#endif
+#ifndef TLOG_FLUSH_INTERVAL_MS
+#define TLOG_FLUSH_INTERVAL_MS 10000  // longest time a sample stays in RAM
+#endif
+#define TLOG_DIR               "/telemetry"
+
+// ===== File format =====
+// File header: "EVTL", version (1 byte), 3 reserved bytes.
+// Then a sequence of blocks, all integers little-endian:
+//   uint8_t  signal       protocol data ID (ID_SOC, ID_SPEED, ...)
+//   uint8_t  count        samples in the block, including the first one
+//   uint16_t payload_len  bytes of varint payload that follow the header
+//   uint32_t t0           millis() of the first sample
+//   int32_t  v0           value of the first sample
+//   payload: (count - 1) x { varint dt_ms, zigzag varint dv }
+// Values are the DashboardData fields; voltage and current are in 0.01 units,
+// mode is the DrivingMode, ID_ARMED is 0/1 and latitude/longitude are in 1e-7
+// degrees. tools/telemetry_decode.py reads it.
+#define TLOG_MAGIC             "EVTL"
+#define TLOG_VERSION           1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Open a new log file and start the low-priority writer task. SD must be mounted.
+bool telemetry_log_begin(void);
+
+// Record the current dashData value of a decoded field (never blocks)
+void telemetry_log_field(uint8_t id);
+
+// Hand buffered samples to the writer once TLOG_FLUSH_INTERVAL_MS passed. Call periodically.
+void telemetry_log_poll(void);
+
+// Blocks lost because the buffer was full while the other one was still being written
+uint32_t telemetry_log_dropped(void);
+
+// Write buffers the card did not take in full (their samples are lost)
+uint32_t telemetry_log_write_errors(void);
+
+#ifdef __cplusplus
+}
+#endif
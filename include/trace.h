@@ -0,0 +1,55 @@
+#pragma once
+// trace.h - stream LVGL profiler markers over the serial port as compact binary packets
+
+#include <lvgl.h>
+
+// Opt-in with the build flag DASH_TRACE, which turns on LV_USE_PROFILER in lv_conf.h.
+// Code is instrumented with LVGL's own markers, so they compile to nothing otherwise:
+//   LV_PROFILER_BEGIN / LV_PROFILER_END              named after the function
+//   LV_PROFILER_BEGIN_TAG("x") / LV_PROFILER_END_TAG("x")
+// Tags must be string literals (only the pointer is stored). Every loop() the
+// profiler's buffer is encoded and written to the serial port; capture it with
+//   pio device monitor -b 921600 --raw > trace.bin   (or any raw serial dump)
+// and convert it with tools/trace_to_chrome.py to open it in chrome://tracing or
+// ui.perfetto.dev. Text printed on the same port is skipped by the decoder.
+
+// ===== Trace configuration (override with build_flags) =====
+#ifndef TRACE_SERIAL_BAUD
+#define TRACE_SERIAL_BAUD      921600  // ~90 kB/s; a redrawn frame is ~2-6 kB of trace
+#endif
+#ifndef TRACE_SERIAL_TX_BUF
+#define TRACE_SERIAL_TX_BUF    4096    // so a flush doesn't wait for the UART
+#endif
+#define TRACE_MAX_NAMES        128     // distinct tags; later ones are sent as "?"
+
+// ===== Stream format =====
+// Packets: 0xA5 0x5A, uint8_t len, uint8_t seq, payload[len], Fletcher-16 of seq and
+// the payload (sum1, sum2). seq counts up by one per packet, so gaps show lost bytes.
+// The payload is a sequence of records, all varints are unsigned LEB128:
+//   TRACE_REC_START                         a new trace: forget the names
+//   TRACE_REC_NAME  varint id, uint8_t len, chars
+//   TRACE_REC_BEGIN | cpu << 4, varint id, varint dt_us, varint tid
+//   TRACE_REC_END   | cpu << 4, varint id, varint dt_us, varint tid
+// dt_us is the time since the previous marker (since trace start for the first one).
+// A name is always sent before the first marker that uses it.
+#define TRACE_SYNC1            0xA5
+#define TRACE_SYNC2            0x5A
+#define TRACE_REC_START        0x01
+#define TRACE_REC_NAME         0x02
+#define TRACE_REC_BEGIN        0x03
+#define TRACE_REC_END          0x04
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Take over LVGL's profiler and start a trace. Call after lv_init(). Does nothing
+// without DASH_TRACE.
+void trace_begin(void);
+
+// Write the markers collected since the last call. Call from loop().
+void trace_poll(void);
+
+#ifdef __cplusplus
+}
+#endif
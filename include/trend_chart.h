@@ -0,0 +1,38 @@
+#pragma once
+// trend_chart.h - scrolling trend chart backed by a retained RGB565 strip
+
+#include "shared.h"
+#include "history.h"
+
+// How a new column reaches the screen
+typedef enum {
+  // The plot scrolls left. The strip is a ring and is blitted in two parts, so a
+  // push costs one rasterised column, but the whole plot area is re-flushed.
+  TREND_CHART_SCROLL = 0,
+  // A cursor sweeps left to right over a fixed plot, erasing a small gap ahead of
+  // it. Only the new column and the gap are invalidated and flushed.
+  TREND_CHART_SWEEP,
+} trend_chart_mode_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The w x h strip (2 bytes per pixel) is allocated outside the LVGL heap.
+// Returns NULL if it does not fit.
+lv_obj_t *trend_chart_create(lv_obj_t *parent, int32_t w, int32_t h, trend_chart_mode_t mode);
+
+// Value range mapped to the bottom and top pixel rows (applies to new columns)
+void trend_chart_set_range(lv_obj_t *chart, int16_t min, int16_t max);
+
+void trend_chart_set_colors(lv_obj_t *chart, lv_color_t bg, lv_color_t band, lv_color_t line);
+
+// Rasterise one column (min..max band plus the average) and invalidate only what changed
+void trend_chart_push(lv_obj_t *chart, const hist_point_t *p);
+
+// Refill the whole strip from the history store, one column per pixel
+void trend_chart_load_history(lv_obj_t *chart, hist_signal_t sig, uint32_t span_ms);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,25 @@
+#pragma once
+// trend_screen.h - trend chart of one history signal
+
+#include "shared.h"
+#include "screen_mgr.h"
+
+// ===== Trend screen configuration (override with build_flags) =====
+// The chart strip takes w x h x 2 bytes of system heap while the screen is built
+#ifndef TREND_SCREEN_CHART_W
+#define TREND_SCREEN_CHART_W  320
+#endif
+#ifndef TREND_SCREEN_CHART_H
+#define TREND_SCREEN_CHART_H  140
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// SCREEN_TRENDS: span and drawing mode come from ui_settings
+extern const screen_desc_t trend_screen_desc;
+
+#ifdef __cplusplus
+}
+#endif
@@ -5,14 +5,28 @@
 #include <FS.h>
 #include <SD.h>
 
+// Text opacity of a field whose value is out of date
+#define UI_STALE_OPA  LV_OPA_40
+
+// Containers of the dashboard's field widgets (see the table in ui.cpp)
+enum ui_parent_t {
+  UI_PARENT_SCREEN = 0,
+  UI_PARENT_MODE_BOX,
+  UI_PARENT_BOTTOM_BAR,
+  UI_PARENT_COUNT
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 // void create_ev_dashboard_ui(void);
+// Create every field widget of the dashboard from the table, with its current value
+void ui_create_fields(lv_obj_t *const parents[UI_PARENT_COUNT]);
 void update_ui_element(uint8_t id);
 void update_time_display(void);
-bool load_image_to_ram(const char *path);
+// Grey out (or restore) the object showing field `id`
+void ui_set_stale(uint8_t id, bool stale);
 
 #ifdef __cplusplus
 }
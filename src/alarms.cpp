@@ -0,0 +1,271 @@
+#include "alarms.h"
+#include "metrics.h"
+
+// A rule set keeps one list of rules per field: heads[] holds the first rule of
+// each field ID - FIELD_FIRST, and each rule's state the next one of the same field,
+// in table order. Evaluating a field walks its list and nothing else.
+
+#define FIELD_FIRST  ID_TEMP
+#define FIELD_CNT    (ID_HEADING - FIELD_FIRST + 1)
+#define NONE         0xFFFF
+
+#define PENDING      0x01            // past the threshold, debounce running
+#define ACTIVE       0x02
+
+#define RAISED       1               // eval_rule() results
+#define CLEARED      2
+
+#define BADGE_W      260
+#define BADGE_H      40
+
+typedef struct {
+  uint32_t since;        // ms when the value went past the threshold
+  uint16_t next;         // next rule of the same field
+  uint8_t flags;
+} rule_state_t;
+
+typedef struct {
+  uint32_t evals;        // rules evaluated
+  uint16_t raised;
+  uint16_t cleared;
+  bool critical;         // a critical rule was raised
+} eval_result_t;
+
+typedef struct {
+  const alarm_rule_t *rules;
+  rule_state_t *state;
+  uint16_t count;
+  uint16_t heads[FIELD_CNT];
+} rule_set_t;
+
+static const alarm_rule_t default_rules[] = {
+  // field           cmp          severity        debounce  threshold                       hysteresis  text
+  { ID_TEMP,         ALARM_ABOVE, ALARM_CRITICAL, 1000,     ALARM_BATT_TEMP_CRIT_C,         2,          LV_SYMBOL_WARNING " Battery overheating" },
+  { ID_AMBIENT_TEMP, ALARM_ABOVE, ALARM_CRITICAL, 1000,     ALARM_MOTOR_TEMP_CRIT_C,        5,          LV_SYMBOL_WARNING " Motor overheating" },
+  { ID_CURRENT,      ALARM_ABOVE, ALARM_CRITICAL, 200,      ALARM_CURRENT_CRIT_A * 100,     2000,       LV_SYMBOL_WARNING " Over-current" },
+  { ID_SOC,          ALARM_BELOW, ALARM_CRITICAL, 5000,     ALARM_SOC_CRIT_PCT,             2,          LV_SYMBOL_BATTERY_EMPTY " Battery critical" },
+  { ID_TEMP,         ALARM_ABOVE, ALARM_WARNING,  3000,     ALARM_BATT_TEMP_WARN_C,         3,          LV_SYMBOL_WARNING " Battery hot" },
+  { ID_AMBIENT_TEMP, ALARM_ABOVE, ALARM_WARNING,  3000,     ALARM_MOTOR_TEMP_WARN_C,        5,          LV_SYMBOL_WARNING " Motor hot" },
+  { ID_CURRENT,      ALARM_ABOVE, ALARM_WARNING,  1000,     ALARM_CURRENT_WARN_A * 100,     2000,       LV_SYMBOL_WARNING " High current" },
+  { ID_SOC,          ALARM_BELOW, ALARM_WARNING,  5000,     ALARM_SOC_WARN_PCT,             2,          LV_SYMBOL_BATTERY_1 " Battery low" },
+};
+
+#define DEFAULT_CNT  (sizeof(default_rules) / sizeof(default_rules[0]))
+
+static rule_state_t default_state[DEFAULT_CNT];
+static rule_set_t alarms;
+static uint16_t active_cnt;
+static uint16_t shown = NONE;        // rule in the badge
+static lv_obj_t *badge = NULL;
+
+static int32_t field_value(uint8_t id) {
+  switch (id) {
+    case ID_SOC:          return dashData.soc;
+    case ID_VOLTAGE:      return (int32_t)lroundf(dashData.voltage * 100.0f);
+    case ID_CURRENT:      return (int32_t)lroundf(dashData.current * 100.0f);
+    case ID_TEMP:         return dashData.battery_temp;
+    case ID_SPEED:        return dashData.speed;
+    case ID_RANGE:        return dashData.range;
+    case ID_CONSUMPTION:  return dashData.avg_wkm;
+    case ID_AMBIENT_TEMP: return dashData.motor_temp;
+    case ID_TRIP:         return dashData.trip;
+    case ID_ODOMETER:     return dashData.odo;
+    case ID_AVG_SPEED:    return dashData.avg_kmh;
+    case ID_HEADING:      return dashData.heading;
+    default:              return 0;
+  }
+}
+
+// ===== Rule sets =====
+static void set_link(rule_set_t *set, const alarm_rule_t *rules, rule_state_t *state, uint16_t count) {
+  set->rules = rules;
+  set->state = state;
+  set->count = count;
+  memset(state, 0, count * sizeof(*state));
+  for (uint8_t f = 0; f < FIELD_CNT; f++) set->heads[f] = NONE;
+
+  // Backwards, so every list comes out in table order
+  for (uint16_t i = count; i-- > 0;) {
+    uint8_t field = rules[i].field;
+    if (field < FIELD_FIRST || field >= FIELD_FIRST + FIELD_CNT) {
+      LV_LOG_WARN("alarm rule %u: unknown field 0x%02X", i, field);
+      state[i].next = NONE;
+      continue;
+    }
+    state[i].next = set->heads[field - FIELD_FIRST];
+    set->heads[field - FIELD_FIRST] = i;
+  }
+}
+
+// RAISED, CLEARED or 0 if the rule's alarm didn't change
+static uint8_t eval_rule(const alarm_rule_t *r, rule_state_t *s, int32_t v, uint32_t now) {
+  if (s->flags & ACTIVE) {
+    bool back = r->cmp == ALARM_ABOVE ? v <= r->threshold - r->hysteresis : v >= r->threshold + r->hysteresis;
+    if (!back) return 0;
+    s->flags = 0;
+    return CLEARED;
+  }
+
+  bool past = r->cmp == ALARM_ABOVE ? v > r->threshold : v < r->threshold;
+  if (!past) {
+    s->flags = 0;
+    return 0;
+  }
+  if (!(s->flags & PENDING)) {
+    s->flags = PENDING;
+    s->since = now;
+  }
+  if (now - s->since < r->debounce_ms) return 0;
+  s->flags = ACTIVE;
+  return RAISED;
+}
+
+// Evaluate the rules of one field, adding to *res
+static void eval_field(rule_set_t *set, uint8_t field, int32_t v, uint32_t now, eval_result_t *res) {
+  if (field < FIELD_FIRST || field >= FIELD_FIRST + FIELD_CNT) return;
+  for (uint16_t i = set->heads[field - FIELD_FIRST]; i != NONE; i = set->state[i].next) {
+    const alarm_rule_t *r = &set->rules[i];
+    uint8_t c = eval_rule(r, &set->state[i], v, now);
+    res->evals++;
+    if (c == RAISED) {
+      res->raised++;
+      if (r->severity == ALARM_CRITICAL) res->critical = true;
+    } else if (c == CLEARED) {
+      res->cleared++;
+    }
+  }
+}
+
+// ===== Badge =====
+static void badge_update(void) {
+  uint16_t top = NONE;
+  active_cnt = 0;
+  for (uint16_t i = 0; i < alarms.count; i++) {
+    if (!(alarms.state[i].flags & ACTIVE)) continue;
+    active_cnt++;
+    if (top == NONE || alarms.rules[i].severity > alarms.rules[top].severity) top = i;
+  }
+  metrics_set(MET_ALARMS_ACTIVE, active_cnt);
+  if (top == shown || !badge) return;
+
+  // Fixed size: a new text or colour only invalidates the badge itself
+  if (top == NONE) {
+    lv_obj_add_flag(badge, LV_OBJ_FLAG_HIDDEN);
+  } else {
+    const alarm_rule_t *r = &alarms.rules[top];
+    if (shown == NONE || r->severity != alarms.rules[shown].severity) {
+      bool critical = r->severity == ALARM_CRITICAL;
+      lv_obj_set_style_bg_color(badge, lv_color_hex(critical ? 0xd00000 : 0xffa000), 0);
+      lv_obj_set_style_text_color(badge, critical ? lv_color_white() : lv_color_black(), 0);
+    }
+    lv_label_set_text_static(badge, r->text);
+    lv_obj_remove_flag(badge, LV_OBJ_FLAG_HIDDEN);
+  }
+  shown = top;
+}
+
+// ===== API =====
+void alarms_begin(void) {
+  set_link(&alarms, default_rules, default_state, DEFAULT_CNT);
+  active_cnt = 0;
+  shown = NONE;
+  metrics_set(MET_ALARMS_ACTIVE, 0);
+
+  if (badge) return;
+  badge = lv_label_create(lv_layer_top());
+  lv_obj_set_size(badge, BADGE_W, BADGE_H);
+  lv_obj_align(badge, LV_ALIGN_TOP_MID, 0, 7);
+  lv_obj_set_style_bg_opa(badge, LV_OPA_COVER, 0);
+  lv_obj_set_style_radius(badge, 8, 0);
+  lv_obj_set_style_text_font(badge, &lv_font_montserrat_18, 0);
+  lv_obj_set_style_text_align(badge, LV_TEXT_ALIGN_CENTER, 0);
+  lv_obj_set_style_pad_top(badge, (BADGE_H - lv_font_get_line_height(&lv_font_montserrat_18)) / 2, 0);
+  lv_label_set_long_mode(badge, LV_LABEL_LONG_MODE_CLIP);
+  lv_obj_add_flag(badge, LV_OBJ_FLAG_HIDDEN);
+}
+
+bool alarms_frame(const uint8_t *ids, uint8_t count) {
+  if (!alarms.count) return false;
+  uint32_t now = millis();
+  eval_result_t res = {};
+  for (uint8_t k = 0; k < count; k++) {
+    eval_field(&alarms, ids[k], field_value(ids[k]), now, &res);
+  }
+  metrics_add(MET_ALARM_RULE_EVALS, res.evals);
+  if (!res.raised && !res.cleared) return false;
+
+  metrics_add(MET_ALARM_RAISES, res.raised);
+  badge_update();
+  return res.critical;
+}
+
+uint32_t alarms_bench(uint16_t rule_cnt, uint16_t frames) {
+  // The fields a controller frame carries, a few at a time
+  static const uint8_t fields[] = {
+    ID_SOC, ID_VOLTAGE, ID_CURRENT, ID_TEMP, ID_SPEED, ID_RANGE,
+    ID_CONSUMPTION, ID_AMBIENT_TEMP, ID_TRIP, ID_ODOMETER, ID_AVG_SPEED,
+  };
+  const uint8_t field_cnt = sizeof(fields);
+  const uint8_t per_frame = 4;
+
+  alarm_rule_t *rules = (alarm_rule_t *)malloc(rule_cnt * sizeof(alarm_rule_t));
+  rule_state_t *state = (rule_state_t *)malloc(rule_cnt * sizeof(rule_state_t));
+  if (!rules || !state) {
+    free(rules);
+    free(state);
+    Serial.println("alarm bench: out of memory");
+    return 0;
+  }
+  // Thresholds spread over the 0..99 values below, so rules keep raising and clearing
+  for (uint16_t i = 0; i < rule_cnt; i++) {
+    rules[i] = { fields[i % field_cnt], (uint8_t)(i & 1 ? ALARM_BELOW : ALARM_ABOVE),
+                 (uint8_t)(i % 5 == 0 ? ALARM_CRITICAL : ALARM_WARNING), (uint16_t)(i % 4 * 100),
+                 (int32_t)(i * 37 % 100), 5, "bench" };
+  }
+
+  rule_set_t set;
+  int32_t last[FIELD_CNT] = { 0 };
+  uint32_t evals = 0, changes = 0;
+
+  lv_lock();
+  // Only the fields each frame carried
+  set_link(&set, rules, state, rule_cnt);
+  uint32_t start = micros();
+  for (uint16_t f = 0; f < frames; f++) {
+    uint32_t now = f * 50;
+    eval_result_t res = {};
+    for (uint8_t k = 0; k < per_frame; k++) {
+      uint8_t id = fields[(f + k * 3) % field_cnt];
+      eval_field(&set, id, (f * 7 + k * 13) % 100, now, &res);
+    }
+    evals += res.evals;
+    changes += res.raised || res.cleared;
+  }
+  uint32_t changed_us = micros() - start;
+
+  // Every rule against the latest value of its field
+  set_link(&set, rules, state, rule_cnt);
+  start = micros();
+  for (uint16_t f = 0; f < frames; f++) {
+    uint32_t now = f * 50;
+    for (uint8_t k = 0; k < per_frame; k++) {
+      last[fields[(f + k * 3) % field_cnt] - FIELD_FIRST] = (f * 7 + k * 13) % 100;
+    }
+    for (uint16_t i = 0; i < rule_cnt; i++) {
+      eval_rule(&rules[i], &state[i], last[rules[i].field - FIELD_FIRST], now);
+    }
+  }
+  uint32_t all_us = micros() - start;
+  lv_unlock();
+
+  free(rules);
+  free(state);
+
+  uint32_t changed_ns = frames ? (uint64_t)changed_us * 1000 / frames : 0;
+  Serial.printf("alarm bench: %u rules, %u frames of %u fields\n", rule_cnt, frames, per_frame);
+  Serial.printf("  changed fields: %lu ns/frame, %lu rule evals/frame, %lu frames changed an alarm\n",
+                (unsigned long)changed_ns, (unsigned long)(frames ? evals / frames : 0), (unsigned long)changes);
+  Serial.printf("  every rule:     %lu ns/frame\n",
+                (unsigned long)(frames ? (uint64_t)all_us * 1000 / frames : 0));
+  return changed_ns;
+}
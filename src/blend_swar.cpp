@@ -0,0 +1,246 @@
+#include <lvgl.h>
+#include <src/draw/sw/blend/lv_draw_sw_blend_private.h>
+#include "blend_swar.h"
+
+#if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_CUSTOM
+
+// lv_color_16_16_mix() spreads one pixel over a 32-bit word as G:R:B at bits
+// 21-26, 11-15 and 0-4, so that (fg - bg) * mix / 32 cannot carry between the
+// channels. A word holding two packed pixels already has that layout twice:
+//   pair & SPLIT               -> B,R of pixel 0 and G of pixel 1
+//   rotate16(pair) & SPLIT     -> B,R of pixel 1 and G of pixel 0
+// so a pixel pair costs two multiplies with no per-pixel spread/pack, and the
+// two halves recombine with a single OR. Every channel is computed exactly as
+// in lv_color_16_16_mix(), including mix 0 (-> bg) and 255 (-> fg).
+
+#define SPLIT  0x07E0F81Fu
+
+static inline uint32_t rotate16(uint32_t v) {
+  return (v >> 16) | (v << 16);
+}
+
+// 8-bit opacity to the 0..32 weight used by lv_color_16_16_mix()
+static inline uint32_t mix32(uint32_t opa) {
+  return (opa + 4) >> 3;
+}
+
+static inline uint32_t blend_split(uint32_t fg, uint32_t bg, uint32_t mix) {
+  return ((((fg - bg) * mix) >> 5) + bg) & SPLIT;
+}
+
+// Two pixels, same weight
+static inline uint32_t blend_pair(uint32_t fg, uint32_t bg, uint32_t mix) {
+  uint32_t even = blend_split(fg & SPLIT, bg & SPLIT, mix);
+  uint32_t odd = blend_split(rotate16(fg) & SPLIT, rotate16(bg) & SPLIT, mix);
+  return even | rotate16(odd);
+}
+
+// One pixel; `fg` is already spread
+static inline uint16_t blend_one(uint32_t fg, uint16_t bg, uint32_t mix) {
+  uint32_t r = blend_split(fg, ((uint32_t)bg | ((uint32_t)bg << 16)) & SPLIT, mix);
+  return (uint16_t)((r >> 16) | r);
+}
+
+static inline uint32_t spread(uint16_t c) {
+  return ((uint32_t)c | ((uint32_t)c << 16)) & SPLIT;
+}
+
+static inline uint32_t load_pair(const uint16_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 16);
+}
+
+static inline bool odd_address(const void *p) {
+  return ((lv_uintptr_t)p & 0x3) != 0;
+}
+
+static inline void *next_row(const void *buf, int32_t stride) {
+  return (uint8_t *)buf + stride;
+}
+
+// ===== Solid color =====
+lv_result_t LV_ATTRIBUTE_FAST_MEM blend_swar_color_to_rgb565(lv_draw_sw_blend_fill_dsc_t *dsc) {
+  uint16_t c16 = lv_color_to_u16(dsc->color);
+  uint32_t c32 = (uint32_t)c16 | ((uint32_t)c16 << 16);
+  uint16_t *row = (uint16_t *)dsc->dest_buf;
+
+  for (int32_t y = 0; y < dsc->dest_h; y++, row = (uint16_t *)next_row(row, dsc->dest_stride)) {
+    int32_t x = 0;
+    if (dsc->dest_w > 0 && odd_address(row)) row[x++] = c16;
+
+    uint32_t *d32 = (uint32_t *)&row[x];
+    int32_t pairs = (dsc->dest_w - x) >> 1;
+    for (; pairs >= 4; pairs -= 4, d32 += 4) {
+      d32[0] = c32;
+      d32[1] = c32;
+      d32[2] = c32;
+      d32[3] = c32;
+    }
+    while (pairs--) *d32++ = c32;
+
+    x = dsc->dest_w - ((dsc->dest_w - x) & 1);
+    if (x < dsc->dest_w) row[x] = c16;
+  }
+  return LV_RESULT_OK;
+}
+
+lv_result_t LV_ATTRIBUTE_FAST_MEM blend_swar_color_to_rgb565_with_opa(lv_draw_sw_blend_fill_dsc_t *dsc) {
+  // The color is constant, so fg * mix is folded once and every channel
+  // becomes (bg * (32 - mix) + fg * mix) / 32: one multiply per half-word pair.
+  uint32_t mix = mix32(dsc->opa);
+  uint32_t inv = 32 - mix;
+  uint32_t fg_mix = spread(lv_color_to_u16(dsc->color)) * mix;
+  uint16_t *row = (uint16_t *)dsc->dest_buf;
+
+  for (int32_t y = 0; y < dsc->dest_h; y++, row = (uint16_t *)next_row(row, dsc->dest_stride)) {
+    int32_t x = 0;
+    if (dsc->dest_w > 0 && odd_address(row)) {
+      uint32_t r = ((spread(row[0]) * inv + fg_mix) >> 5) & SPLIT;
+      row[x++] = (uint16_t)((r >> 16) | r);
+    }
+
+    uint32_t *d32 = (uint32_t *)&row[x];
+    for (; x + 1 < dsc->dest_w; x += 2, d32++) {
+      uint32_t bg = *d32;
+      uint32_t even = (((bg & SPLIT) * inv + fg_mix) >> 5) & SPLIT;
+      uint32_t odd = (((rotate16(bg) & SPLIT) * inv + fg_mix) >> 5) & SPLIT;
+      *d32 = even | rotate16(odd);
+    }
+
+    if (x < dsc->dest_w) {
+      uint32_t r = ((spread(row[x]) * inv + fg_mix) >> 5) & SPLIT;
+      row[x] = (uint16_t)((r >> 16) | r);
+    }
+  }
+  return LV_RESULT_OK;
+}
+
+// Serves both the full-opacity and the mask x opacity hooks
+lv_result_t LV_ATTRIBUTE_FAST_MEM blend_swar_color_to_rgb565_with_mask(lv_draw_sw_blend_fill_dsc_t *dsc) {
+  uint16_t c16 = lv_color_to_u16(dsc->color);
+  uint32_t c32 = (uint32_t)c16 | ((uint32_t)c16 << 16);
+  uint32_t fg = spread(c16);
+  lv_opa_t opa = dsc->opa;
+  bool full = opa >= LV_OPA_MAX;
+  uint16_t *row = (uint16_t *)dsc->dest_buf;
+  const lv_opa_t *mask = dsc->mask_buf;
+
+  for (int32_t y = 0; y < dsc->dest_h; y++, row = (uint16_t *)next_row(row, dsc->dest_stride),
+       mask += dsc->mask_stride) {
+    int32_t x = 0;
+    if (dsc->dest_w > 0 && odd_address(row)) {
+      lv_opa_t m = full ? mask[0] : LV_OPA_MIX2(mask[0], opa);
+      row[0] = blend_one(fg, row[0], mix32(m));
+      x = 1;
+    }
+
+    uint32_t *d32 = (uint32_t *)&row[x];
+    for (; x + 1 < dsc->dest_w; x += 2, d32++) {
+      lv_opa_t m0 = mask[x];
+      lv_opa_t m1 = mask[x + 1];
+      if ((m0 | m1) == 0) continue;
+      if (full && (m0 & m1) == 0xFF) {
+        *d32 = c32;
+        continue;
+      }
+      if (!full) {
+        m0 = LV_OPA_MIX2(m0, opa);
+        m1 = LV_OPA_MIX2(m1, opa);
+      }
+
+      uint32_t mix0 = mix32(m0);
+      uint32_t mix1 = mix32(m1);
+      uint32_t bg = *d32;
+      if (mix0 == mix1) {
+        *d32 = blend_pair(c32, bg, mix0);
+      } else {
+        *d32 = (uint32_t)blend_one(fg, (uint16_t)bg, mix0) |
+               ((uint32_t)blend_one(fg, (uint16_t)(bg >> 16), mix1) << 16);
+      }
+    }
+
+    if (x < dsc->dest_w) {
+      lv_opa_t m = full ? mask[x] : LV_OPA_MIX2(mask[x], opa);
+      row[x] = blend_one(fg, row[x], mix32(m));
+    }
+  }
+  return LV_RESULT_OK;
+}
+
+// ===== RGB565 image =====
+// The source may have the other word alignment than the destination, so it is
+// read as two half-words; the destination is always read and written as words.
+
+lv_result_t LV_ATTRIBUTE_FAST_MEM blend_swar_rgb565_to_rgb565_with_opa(lv_draw_sw_blend_image_dsc_t *dsc) {
+  uint32_t mix = mix32(dsc->opa);
+  uint16_t *row = (uint16_t *)dsc->dest_buf;
+  const uint16_t *src = (const uint16_t *)dsc->src_buf;
+
+  for (int32_t y = 0; y < dsc->dest_h; y++, row = (uint16_t *)next_row(row, dsc->dest_stride),
+       src = (const uint16_t *)next_row(src, dsc->src_stride)) {
+    int32_t x = 0;
+    if (dsc->dest_w > 0 && odd_address(row)) {
+      row[0] = blend_one(spread(src[0]), row[0], mix);
+      x = 1;
+    }
+
+    uint32_t *d32 = (uint32_t *)&row[x];
+    for (; x + 1 < dsc->dest_w; x += 2, d32++) {
+      *d32 = blend_pair(load_pair(&src[x]), *d32, mix);
+    }
+
+    if (x < dsc->dest_w) row[x] = blend_one(spread(src[x]), row[x], mix);
+  }
+  return LV_RESULT_OK;
+}
+
+// Serves both the full-opacity and the mask x opacity hooks
+lv_result_t LV_ATTRIBUTE_FAST_MEM blend_swar_rgb565_to_rgb565_with_mask(lv_draw_sw_blend_image_dsc_t *dsc) {
+  lv_opa_t opa = dsc->opa;
+  bool full = opa >= LV_OPA_MAX;
+  uint16_t *row = (uint16_t *)dsc->dest_buf;
+  const uint16_t *src = (const uint16_t *)dsc->src_buf;
+  const lv_opa_t *mask = dsc->mask_buf;
+
+  for (int32_t y = 0; y < dsc->dest_h; y++, row = (uint16_t *)next_row(row, dsc->dest_stride),
+       src = (const uint16_t *)next_row(src, dsc->src_stride), mask += dsc->mask_stride) {
+    int32_t x = 0;
+    if (dsc->dest_w > 0 && odd_address(row)) {
+      lv_opa_t m = full ? mask[0] : LV_OPA_MIX2(mask[0], opa);
+      row[0] = blend_one(spread(src[0]), row[0], mix32(m));
+      x = 1;
+    }
+
+    uint32_t *d32 = (uint32_t *)&row[x];
+    for (; x + 1 < dsc->dest_w; x += 2, d32++) {
+      lv_opa_t m0 = mask[x];
+      lv_opa_t m1 = mask[x + 1];
+      if ((m0 | m1) == 0) continue;
+      if (full && (m0 & m1) == 0xFF) {
+        *d32 = load_pair(&src[x]);
+        continue;
+      }
+      if (!full) {
+        m0 = LV_OPA_MIX2(m0, opa);
+        m1 = LV_OPA_MIX2(m1, opa);
+      }
+
+      uint32_t mix0 = mix32(m0);
+      uint32_t mix1 = mix32(m1);
+      uint32_t bg = *d32;
+      if (mix0 == mix1) {
+        *d32 = blend_pair(load_pair(&src[x]), bg, mix0);
+      } else {
+        *d32 = (uint32_t)blend_one(spread(src[x]), (uint16_t)bg, mix0) |
+               ((uint32_t)blend_one(spread(src[x + 1]), (uint16_t)(bg >> 16), mix1) << 16);
+      }
+    }
+
+    if (x < dsc->dest_w) {
+      lv_opa_t m = full ? mask[x] : LV_OPA_MIX2(mask[x], opa);
+      row[x] = blend_one(spread(src[x]), row[x], mix32(m));
+    }
+  }
+  return LV_RESULT_OK;
+}
+
+#endif
@@ -0,0 +1,79 @@
+#include "diag_screen.h"
+#include "metrics.h"
+
+// Two labels hold all rows (names and values, one per line) to keep the object
+// count, and with it the LVGL heap cost, independent of the number of metrics.
+
+static lv_obj_t *values_label;
+static lv_timer_t *refresh_timer;
+
+static void refresh_cb(lv_timer_t *t) {
+  static char text[METRICS_ROWS * 48];
+  size_t len = 0;
+  for (uint16_t row = 0; row < METRICS_ROWS && len + 2 < sizeof(text); row++) {
+    if (row) text[len++] = '\n';
+    metrics_row_value(row, &text[len], sizeof(text) - len);
+    len += strlen(&text[len]);
+  }
+  // The label keeps pointing at `text`: no copy on the LVGL heap per refresh. It
+  // only redraws on its own when its size changes, so invalidate it here.
+  lv_label_set_text_static(values_label, text);
+  lv_obj_invalidate(values_label);
+}
+
+static void deleted_cb(lv_event_t *e) {
+  lv_timer_delete(refresh_timer);
+  refresh_timer = NULL;
+  values_label = NULL;
+}
+
+static lv_obj_t *build(void) {
+  lv_obj_t *diag_scr = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(diag_scr, lv_color_hex(0xe5e5e5), 0);
+  lv_obj_add_event_cb(diag_scr, deleted_cb, LV_EVENT_DELETE, NULL);
+
+  screen_mgr_top_bar(diag_scr, "Diagnostics");
+
+  /* Metrics, scrolled when they don't fit */
+  lv_obj_t *list = lv_obj_create(diag_scr);
+  lv_obj_set_size(list, lv_pct(100), lv_pct(100));
+  lv_obj_set_style_pad_top(list, 60, 0);
+  lv_obj_set_style_bg_opa(list, LV_OPA_TRANSP, 0);
+  lv_obj_set_style_border_width(list, 0, 0);
+  lv_obj_set_scroll_dir(list, LV_DIR_VER);
+  lv_obj_move_background(list);
+
+  lv_obj_t *names_label = lv_label_create(list);
+  lv_obj_set_style_text_color(names_label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(names_label, &lv_font_montserrat_14, 0);
+  char names[METRICS_ROWS * 24];
+  size_t len = 0;
+  for (uint16_t row = 0; row < METRICS_ROWS && len < sizeof(names); row++) {
+    len += snprintf(&names[len], sizeof(names) - len, "%s%s", row ? "\n" : "", metrics_row_name(row));
+  }
+  lv_label_set_text(names_label, names);
+
+  values_label = lv_label_create(list);
+  lv_obj_set_style_text_color(values_label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(values_label, &lv_font_montserrat_14, 0);
+  lv_obj_set_pos(values_label, 150, 0);
+
+  refresh_timer = lv_timer_create(refresh_cb, METRICS_SAMPLE_INTERVAL_MS, NULL);
+  lv_timer_pause(refresh_timer);
+  return diag_scr;
+}
+
+static void on_show(lv_obj_t *scr) {
+  refresh_cb(refresh_timer);
+  lv_timer_resume(refresh_timer);
+}
+
+static void on_hide(lv_obj_t *scr) {
+  lv_timer_pause(refresh_timer);
+}
+
+const screen_desc_t diag_screen_desc = {
+  "diag", build, on_show, on_hide,
+  6 * 1024, 0,            // rough cost until the first build
+  SCREEN_MENU, false,
+};
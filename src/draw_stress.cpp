@@ -0,0 +1,92 @@
+#include "draw_stress.h"
+
+// The tiles aren't widgets: one object adds their draw tasks itself, so the test costs
+// no LVGL heap beyond the tasks of the band being drawn.
+
+static void draw_tiles_cb(lv_event_t *e) {
+  lv_layer_t *layer = lv_event_get_layer(e);
+  lv_obj_t *obj = lv_event_get_target_obj(e);
+  lv_area_t coords;
+  lv_obj_get_coords(obj, &coords);
+
+  int32_t w = lv_area_get_width(&coords) / DRAW_STRESS_COLS;
+  int32_t h = lv_area_get_height(&coords) / DRAW_STRESS_ROWS;
+  int32_t text_y = (h - lv_font_get_line_height(&lv_font_montserrat_14)) / 2;
+  const lv_area_t *clip = &layer->_clip_area;
+  char text[8];
+
+  lv_draw_rect_dsc_t rect_dsc;
+  lv_draw_rect_dsc_init(&rect_dsc);
+  rect_dsc.radius = 3;
+  rect_dsc.border_width = 1;
+  rect_dsc.border_color = lv_color_hex(0x333333);
+
+  lv_draw_label_dsc_t label_dsc;
+  lv_draw_label_dsc_init(&label_dsc);
+  label_dsc.font = &lv_font_montserrat_14;
+  label_dsc.color = lv_color_black();
+  label_dsc.align = LV_TEXT_ALIGN_CENTER;
+  label_dsc.text = text;
+  label_dsc.text_local = 1;   // copied into the task
+
+  for (uint16_t r = 0; r < DRAW_STRESS_ROWS; r++) {
+    for (uint16_t c = 0; c < DRAW_STRESS_COLS; c++) {
+      lv_area_t tile;
+      tile.x1 = coords.x1 + c * w;
+      tile.y1 = coords.y1 + r * h;
+      tile.x2 = tile.x1 + w - 1;
+      tile.y2 = tile.y1 + h - 1;
+      if (tile.x2 < clip->x1 || tile.x1 > clip->x2 || tile.y2 < clip->y1 || tile.y1 > clip->y2) continue;
+
+      uint16_t n = r * DRAW_STRESS_COLS + c;
+      rect_dsc.bg_color = lv_color_hsv_to_rgb((n * 7) % 360, 30, 95);
+      lv_draw_rect(layer, &rect_dsc, &tile);
+
+      snprintf(text, sizeof(text), "%u", n);
+      tile.y1 += text_y;
+      lv_draw_label(layer, &label_dsc, &tile);
+    }
+  }
+}
+
+static lv_obj_t *build(void) {
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(scr, lv_color_hex(0xe5e5e5), 0);
+
+  lv_obj_t *tiles = lv_obj_create(scr);
+  lv_obj_remove_style_all(tiles);
+  lv_obj_set_size(tiles, lv_pct(100), lv_pct(100));
+  lv_obj_add_event_cb(tiles, draw_tiles_cb, LV_EVENT_DRAW_MAIN, NULL);
+  return scr;
+}
+
+uint32_t draw_stress_run(uint16_t frames) {
+  if (frames == 0) return 0;
+
+  lv_lock();
+  lv_obj_t *prev = lv_screen_active();
+  lv_obj_t *scr = build();
+  lv_screen_load(scr);
+  lv_refr_now(disp);
+
+  uint32_t total = 0, min_us = UINT32_MAX, max_us = 0;
+  for (uint16_t f = 0; f < frames; f++) {
+    lv_obj_invalidate(scr);
+    uint32_t start = micros();
+    lv_refr_now(disp);
+    uint32_t us = micros() - start;
+    total += us;
+    if (us < min_us) min_us = us;
+    if (us > max_us) max_us = us;
+  }
+
+  lv_screen_load(prev);
+  lv_obj_delete(scr);
+  lv_unlock();
+
+  uint32_t avg = total / frames;
+  Serial.printf("stress: %u tiles, %u frames, avg %lu us min %lu max %lu\n",
+                DRAW_STRESS_COLS * DRAW_STRESS_ROWS, frames, (unsigned long)avg,
+                (unsigned long)min_us, (unsigned long)max_us);
+  return avg;
+}
@@ -0,0 +1,149 @@
+#include "history.h"
+
+// Each signal has one ring per level. A ring slot is addressed directly by its
+// absolute bucket number (millis() / period) modulo the ring size, so samples and
+// queries never search. Every level accumulates raw samples into an open bucket
+// which is written to its slot when the first sample of a later bucket arrives;
+// slots skipped during bus silence are cleared to "empty".
+
+#define HIST_LEVELS  3
+
+typedef struct {
+  uint32_t period_ms;
+  uint16_t buckets;
+} hist_level_t;
+
+static const hist_level_t levels[HIST_LEVELS] = {
+  { 1000,  HIST_L0_BUCKETS },
+  { 10000, HIST_L1_BUCKETS },
+  { 60000, HIST_L2_BUCKETS },
+};
+
+// Open (still accumulating) bucket of one signal/level
+typedef struct {
+  uint32_t idx;      // absolute bucket number
+  int32_t sum;
+  uint16_t n;        // 0 = nothing recorded yet for this signal/level
+  int16_t min;
+  int16_t max;
+} hist_acc_t;
+
+static hist_point_t ring_l0[HIST_SIGNAL_COUNT][HIST_L0_BUCKETS];
+static hist_point_t ring_l1[HIST_SIGNAL_COUNT][HIST_L1_BUCKETS];
+static hist_point_t ring_l2[HIST_SIGNAL_COUNT][HIST_L2_BUCKETS];
+static hist_acc_t acc[HIST_SIGNAL_COUNT][HIST_LEVELS];
+
+static_assert(sizeof(ring_l0) + sizeof(ring_l1) + sizeof(ring_l2) + sizeof(acc) <= HIST_BUDGET_BYTES,
+              "history rings exceed HIST_BUDGET_BYTES");
+
+static const hist_point_t EMPTY_POINT = { INT16_MAX, INT16_MIN, 0 };
+
+static hist_point_t *ring(uint8_t sig, uint8_t lvl) {
+  if (lvl == 0) return ring_l0[sig];
+  if (lvl == 1) return ring_l1[sig];
+  return ring_l2[sig];
+}
+
+static hist_point_t acc_point(const hist_acc_t *a) {
+  hist_point_t p = { a->min, a->max, (int16_t)(a->sum / a->n) };
+  return p;
+}
+
+static void add_sample(uint8_t sig, int16_t v, uint32_t now) {
+  for (uint8_t lvl = 0; lvl < HIST_LEVELS; lvl++) {
+    hist_acc_t *a = &acc[sig][lvl];
+    hist_point_t *r = ring(sig, lvl);
+    uint16_t size = levels[lvl].buckets;
+    uint32_t idx = now / levels[lvl].period_ms;
+
+    if (a->n == 0) {
+      // First sample ever: nothing in this ring is valid yet
+      for (uint16_t i = 0; i < size; i++) r[i] = EMPTY_POINT;
+    } else if (idx != a->idx) {
+      r[a->idx % size] = acc_point(a);
+      uint32_t gap = idx - a->idx - 1;
+      if (gap > size) gap = size;
+      for (uint32_t b = a->idx + 1; b <= a->idx + gap; b++) r[b % size] = EMPTY_POINT;
+    } else {
+      a->sum += v;
+      a->n++;
+      if (v < a->min) a->min = v;
+      if (v > a->max) a->max = v;
+      continue;
+    }
+
+    a->idx = idx;
+    a->sum = v;
+    a->n = 1;
+    a->min = v;
+    a->max = v;
+  }
+}
+
+static int16_t clamp16(float v) {
+  if (v > INT16_MAX) return INT16_MAX;
+  if (v < -INT16_MAX) return -INT16_MAX;
+  return (int16_t)lroundf(v);
+}
+
+void history_record(uint8_t id) {
+  uint32_t now = millis();
+
+  switch (id) {
+    case ID_SPEED:        add_sample(HIST_SPEED, clamp16(dashData.speed), now); break;
+    case ID_CURRENT:      add_sample(HIST_POWER, clamp16(dashData.voltage * dashData.current * 0.1f), now); break;
+    case ID_SOC:          add_sample(HIST_SOC, clamp16(dashData.soc), now); break;
+    case ID_TEMP:         add_sample(HIST_BATTERY_TEMP, clamp16(dashData.battery_temp), now); break;
+    case ID_AMBIENT_TEMP: add_sample(HIST_MOTOR_TEMP, clamp16(dashData.motor_temp), now); break;
+  }
+}
+
+// Bucket `b` of a level: the open bucket, a closed one from the ring, or empty
+static hist_point_t get_bucket(uint8_t sig, uint8_t lvl, int32_t b) {
+  const hist_acc_t *a = &acc[sig][lvl];
+  int32_t open = (int32_t)a->idx;
+
+  if (a->n == 0 || b < 0 || b > open) return EMPTY_POINT;
+  if (b == open) return acc_point(a);
+  if (open - b >= levels[lvl].buckets) return EMPTY_POINT;
+  return ring(sig, lvl)[b % levels[lvl].buckets];
+}
+
+uint16_t history_query(hist_signal_t sig, uint32_t span_ms, hist_point_t *out, uint16_t columns) {
+  if (sig >= HIST_SIGNAL_COUNT || columns == 0 || span_ms == 0) return 0;
+
+  // Finest level whose bucket is no wider than a column and which covers the span
+  uint32_t col_ms = span_ms / columns;
+  uint8_t lvl = 0;
+  while (lvl + 1 < HIST_LEVELS &&
+         (levels[lvl + 1].period_ms <= col_ms ||
+          span_ms > levels[lvl].period_ms * levels[lvl].buckets)) {
+    lvl++;
+  }
+
+  uint32_t period = levels[lvl].period_ms;
+  int32_t nb = (span_ms + period - 1) / period;
+  if (nb > levels[lvl].buckets) nb = levels[lvl].buckets;
+  int32_t b_start = (int32_t)(millis() / period) - nb + 1;
+
+  for (uint16_t c = 0; c < columns; c++) {
+    int32_t first = (int32_t)c * nb / columns;
+    int32_t last = (int32_t)(c + 1) * nb / columns;
+    if (last <= first) last = first + 1;
+
+    hist_point_t col = EMPTY_POINT;
+    int32_t sum = 0;
+    uint16_t n = 0;
+    for (int32_t b = first; b < last; b++) {
+      hist_point_t p = get_bucket(sig, lvl, b_start + b);
+      if (p.min > p.max) continue;
+      if (p.min < col.min) col.min = p.min;
+      if (p.max > col.max) col.max = p.max;
+      sum += p.avg;
+      n++;
+    }
+    if (n) col.avg = sum / n;
+    out[c] = col;
+  }
+  return columns;
+}
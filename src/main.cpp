@@ -1,7 +1,19 @@
 #include "shared.h"
 #include "rs485.h"
 #include "ui.h"
-#include "fonts/lv_font_montserrat_78.h"
+#include "odometer.h"
+#include "telemetry_log.h"
+#include "trace.h"
+#include "metrics.h"
+#include "screen_mgr.h"
+#include "menu_screen.h"
+#include "settings_screen.h"
+#include "diag_screen.h"
+#include "trend_screen.h"
+#include "map_screen.h"
+#include "staleness.h"
+#include "alarms.h"
+#include "draw_stress.h"
 
 #include <SPI.h>
 #include <lvgl.h>
@@ -11,6 +23,7 @@
 
 #include <hardwareserial.h>
 #define SD_CS 5
+#define SPLASH_IMAGE "S:/lvgl/logo1.bin"  // read row by row through LVGL's SD driver
 #define TFT_HOR_RES 480  // LANDSCAPE: Width first
 #define TFT_VER_RES 320  // LANDSCAPE: Height second
 
@@ -45,9 +58,17 @@ lv_obj_t *current;
 lv_obj_t *time_label;              // update in time
 lv_obj_t *menu_btn = NULL;
 
+bool rs485_in_task = false;        // RS485 parsed by its own task (DASH_DUAL_CORE)
+
 /* Touch callback */
 void my_touch_read(lv_indev_t *indev, lv_indev_data_t *data) {
+  LV_PROFILER_BEGIN;
+  static bool was_pressed = false;
+  uint32_t start = micros();
   uint8_t touches = ts.touched(GT911_MODE_POLLING);
+  metrics_observe_us(MET_H_TOUCH_READ, micros() - start);
+  if (touches && !was_pressed) metrics_add(MET_TOUCH_PRESSES, 1);
+  was_pressed = touches;
   if (touches) {
     GTPoint *p = ts.getPoints();
     data->point.x = TFT_HOR_RES - p->y;
@@ -56,14 +77,22 @@ void my_touch_read(lv_indev_t *indev, lv_indev_data_t *data) {
   } else { 
     data->state = LV_INDEV_STATE_RELEASED;
   }
+  LV_PROFILER_END;
+}
+
+static void menu_btn_cb(lv_event_t *e) {
+  screen_mgr_show(SCREEN_MENU);
+}
+
+static void map_btn_cb(lv_event_t *e) {
+  screen_mgr_show(SCREEN_MAP);
 }
 
-/* Create EV Dashboard UI */
-void create_ev_dashboard_ui() {
+/* Create EV Dashboard UI on a new screen (SCREEN_DASHBOARD, built once) */
+lv_obj_t *create_ev_dashboard_ui() {
   Serial.println("Creating EV dashboard UI...");
 
-  lv_obj_t *scr = lv_scr_act();
-  lv_obj_clean(scr);
+  lv_obj_t *scr = lv_obj_create(NULL);
   lv_obj_set_style_bg_color(scr, lv_color_hex(0xe5e5e5), 0);
 
   /* Top bar */
@@ -88,6 +117,7 @@ void create_ev_dashboard_ui() {
   lv_obj_add_flag(menu_btn, LV_OBJ_FLAG_CLICKABLE);
   lv_obj_clear_flag(menu_btn, LV_OBJ_FLAG_SCROLL_ON_FOCUS);
   lv_obj_set_style_bg_color(menu_btn, lv_color_hex(0x333333), 0);
+  lv_obj_add_event_cb(menu_btn, menu_btn_cb, LV_EVENT_CLICKED, NULL);
 
   // Create menu symbol
   lv_obj_t *menu_label = lv_label_create(menu_btn);
@@ -99,6 +129,9 @@ void create_ev_dashboard_ui() {
   lv_label_set_text(map_btn, "Map");
   lv_obj_set_style_text_font(map_btn, &lv_font_montserrat_16, 0);
   lv_obj_align(map_btn, LV_ALIGN_RIGHT_MID, -10, 0);
+  lv_obj_add_flag(map_btn, LV_OBJ_FLAG_CLICKABLE);
+  lv_obj_set_ext_click_area(map_btn, 12);
+  lv_obj_add_event_cb(map_btn, map_btn_cb, LV_EVENT_CLICKED, NULL);
 
   /* Status badge */
   // lv_obj_t *status_badge = lv_obj_create(scr);
@@ -114,21 +147,6 @@ void create_ev_dashboard_ui() {
   // lv_obj_set_style_text_font(status_label, &lv_font_montserrat_16, 0);
   // lv_obj_center(status_label);
 
-  /* Main speed display */
-  speed_label = lv_label_create(scr);
-  char buf[32];
-  snprintf(buf, sizeof(buf), "%d", dashData.speed);
-  lv_label_set_text(speed_label, buf);
-  lv_obj_set_style_text_color(speed_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(speed_label, &lv_font_montserrat_78, 0);
-  lv_obj_align(speed_label, LV_ALIGN_CENTER, 0, -40);
-
-  lv_obj_t *kmh_label = lv_label_create(scr);
-  lv_label_set_text(kmh_label, "Km/h");
-  lv_obj_set_style_text_color(kmh_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(kmh_label, &lv_font_montserrat_16, 0);
-  lv_obj_align(kmh_label, LV_ALIGN_CENTER, 66, -34);
-
   /* Mode selector */
   lv_obj_t *mode_container = lv_obj_create(scr);
   lv_obj_set_size(mode_container, 100, 60);
@@ -143,63 +161,6 @@ void create_ev_dashboard_ui() {
   // lv_obj_set_style_text_font(mode_text, &lv_font_montserrat_16, 0);
   // lv_obj_align(mode_text, LV_ALIGN_TOP_MID, 0, 3);
 
-  mode_label = lv_label_create(mode_container);
-  lv_label_set_text(mode_label, dashData.mode.c_str());
-  lv_obj_set_style_text_color(mode_label, lv_color_hex(0x00cc00), 0);
-  lv_obj_set_style_text_font(mode_label, &lv_font_montserrat_20, 0);
-  lv_obj_align(mode_label, LV_ALIGN_CENTER, 0, 0);
-
-  /* Left side info */
-  range_label = lv_label_create(scr);
-  snprintf(buf, sizeof(buf), "Range: %d km", dashData.range);
-  lv_label_set_text(range_label, buf);
-  lv_obj_set_style_text_color(range_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(range_label, &lv_font_montserrat_16, 0);
-  lv_obj_align(range_label, LV_ALIGN_LEFT_MID, 10, -60);
-
-  avg_wkm_label = lv_label_create(scr);
-  snprintf(buf, sizeof(buf), "Avg. con: %d W/km", dashData.avg_wkm);
-  lv_label_set_text(avg_wkm_label, buf);
-  lv_obj_set_style_text_color(avg_wkm_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(avg_wkm_label, &lv_font_montserrat_16, 0);
-  lv_obj_align(avg_wkm_label, LV_ALIGN_LEFT_MID, 10, -20);
-
-  voltage = lv_label_create(scr);
-  snprintf(buf, sizeof(buf), "Volt: %.2f V", dashData.voltage);
-  lv_label_set_text(voltage, buf);
-  lv_obj_set_style_text_color(voltage, lv_color_black(), 0);
-  lv_obj_set_style_text_font(voltage, &lv_font_montserrat_16, 0);
-  lv_obj_align(voltage, LV_ALIGN_LEFT_MID, 10, 60);
-
-  current = lv_label_create(scr);
-  snprintf(buf, sizeof(buf), "Current: %.2f A", dashData.current); 
-  lv_label_set_text(current, buf);
-  lv_obj_set_style_text_color(current, lv_color_black(), 0);
-  lv_obj_set_style_text_font(current, &lv_font_montserrat_16, 0);
-  lv_obj_align(current, LV_ALIGN_LEFT_MID, 10, 90);
-
-  /* Right side info */
-  motor_temp_label = lv_label_create(scr);
-  snprintf(buf, sizeof(buf), "Motor: %d°C", dashData.motor_temp);
-  lv_label_set_text(motor_temp_label, buf);
-  lv_obj_set_style_text_color(motor_temp_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(motor_temp_label, &lv_font_montserrat_16, 0);
-  lv_obj_align(motor_temp_label, LV_ALIGN_RIGHT_MID, -10, -60);
-
-  battery_temp_label = lv_label_create(scr);
-  snprintf(buf, sizeof(buf), "Battery: %d°C", dashData.battery_temp);
-  lv_label_set_text(battery_temp_label, buf);
-  lv_obj_set_style_text_color(battery_temp_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(battery_temp_label, &lv_font_montserrat_16, 0);
-  lv_obj_align(battery_temp_label, LV_ALIGN_RIGHT_MID, -10, -20);
-
-  soc =lv_label_create(scr);
-  snprintf(buf, sizeof(buf), "SoC: %d%%", dashData.soc);
-  lv_label_set_text(soc, buf);
-  lv_obj_set_style_text_color(soc, lv_color_black(), 0);
-  lv_obj_set_style_text_font(soc, &lv_font_montserrat_16, 0);
-  lv_obj_align(soc, LV_ALIGN_RIGHT_MID, -10, 60);
-
   /* Bottom bar */
   lv_obj_t *bottom_bar = lv_obj_create(scr);
   lv_obj_set_size(bottom_bar, TFT_HOR_RES, 50);
@@ -208,30 +169,27 @@ void create_ev_dashboard_ui() {
   lv_obj_set_style_border_width(bottom_bar, 0, 0);
   lv_obj_set_style_radius(bottom_bar, 0, 0);
 
-  trip_label = lv_label_create(bottom_bar);
-  snprintf(buf, sizeof(buf), "TRIP: %d km", dashData.trip);
-  lv_label_set_text(trip_label, buf);
-  lv_obj_set_style_text_color(trip_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(trip_label, &lv_font_montserrat_14, 0);
-  lv_obj_align(trip_label, LV_ALIGN_LEFT_MID, 5, 0);
-
-  odo_label = lv_label_create(bottom_bar);
-  snprintf(buf, sizeof(buf), "ODO: %d km", dashData.odo);
-  lv_label_set_text(odo_label, buf);
-  lv_obj_set_style_text_color(odo_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(odo_label, &lv_font_montserrat_14, 0);
-  lv_obj_align(odo_label, LV_ALIGN_CENTER, 0, 0);
-
-  avg_kmh_label = lv_label_create(bottom_bar);
-  snprintf(buf, sizeof(buf), "Avg. SPEED: %d km/h", dashData.avg_kmh);
-  lv_label_set_text(avg_kmh_label, buf);
-  lv_obj_set_style_text_color(avg_kmh_label, lv_color_black(), 0);
-  lv_obj_set_style_text_font(avg_kmh_label, &lv_font_montserrat_14, 0);
-  lv_obj_align(avg_kmh_label, LV_ALIGN_RIGHT_MID, -2, 0);
+  /* Readouts: the field table in ui.cpp */
+  lv_obj_t *const parents[UI_PARENT_COUNT] = { scr, mode_container, bottom_bar };
+  ui_create_fields(parents);
+
+  // The speed box is reserved for "199", so keep the unit clear of it
+  lv_obj_t *kmh_label = lv_label_create(scr);
+  lv_label_set_text(kmh_label, "Km/h");
+  lv_obj_set_style_text_color(kmh_label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(kmh_label, &lv_font_montserrat_16, 0);
+  lv_obj_align_to(kmh_label, speed_label, LV_ALIGN_OUT_RIGHT_MID, 4, 6);
 
   Serial.println("EV dashboard UI created!");
+  return scr;
 }
 
+static const screen_desc_t dashboard_screen_desc = {
+  "dashboard", create_ev_dashboard_ui, NULL, NULL,
+  16 * 1024, 0,
+  SCREEN_MENU, true,
+};
+
 void init_dashboard_data() {
   dashData.speed = 0;
   dashData.range = 10;
@@ -246,11 +204,19 @@ void init_dashboard_data() {
   dashData.soc = 25;
   dashData.voltage = 23.0;
   dashData.current = 0.0;
+  dashData.latitude = 0;
+  dashData.longitude = 0;
+  dashData.heading = -1;
 }
 
 
 void setup() {
+#ifdef DASH_TRACE
+  Serial.setTxBufferSize(TRACE_SERIAL_TX_BUF);
+  Serial.begin(TRACE_SERIAL_BAUD);
+#else
   Serial.begin(115200);
+#endif
   delay(100);
 
 
@@ -270,26 +236,36 @@ void setup() {
   // Initialize data structure
   init_dashboard_data();
 
+  // Restore odometer/trip saved before the last power-off
+  if (!odometer_init(odometer_partition_flash())) {
+    Serial.println("No saved odometer, waiting for controller");
+  }
+
   /* Initialize SD Card */
+  // The card stays mounted: LVGL reads images from it through the 'S:' drive.
+  // TFT_eSPI owns VSPI, so the SD card gets the HSPI peripheral.
   Serial.println("Initializing SD Card...");
-  SPIClass spi = SPIClass(VSPI);
-  spi.begin(18, 19, 23, SD_CS);
+  static SPIClass sd_spi = SPIClass(HSPI);
+  sd_spi.begin(18, 19, 23, SD_CS);
 
-  if (!SD.begin(SD_CS, spi)) {
+  if (!SD.begin(SD_CS, sd_spi)) {
     Serial.println("ERROR: SD Card mount failed!");
     while (1) delay(1000);
   }
 
-  /* Load splash image */
-  if (!load_image_to_ram("/lvgl/logo1.bin")) {
-    Serial.println("ERROR: Failed to load image!");
-    while (1) delay(1000);
-  }
-
-  SD.end();
+  /* Start the trip log (the dashboard works without it) */
+  telemetry_log_begin();
 
   /* Initialize LVGL */
   lv_init();
+  trace_begin();
+
+  /* Check the splash image header (the pixels are only read while drawing) */
+  lv_image_header_t splash_header;
+  if (lv_image_decoder_get_info(SPLASH_IMAGE, &splash_header) != LV_RESULT_OK) {
+    Serial.println("ERROR: Failed to load image!");
+    while (1) delay(1000);
+  }
 
   /* Initialize touch */
   Wire.begin(TOUCH_SDA, TOUCH_SCL);
@@ -311,6 +287,7 @@ void setup() {
       TFT_HOR_RES * 40 * (LV_COLOR_DEPTH / 8));
 
   TFT_eSPI().setRotation(3);
+  metrics_attach_display(disp);
 
   /* Setup touch input */
   lv_indev_t *indev = lv_indev_create();
@@ -326,49 +303,96 @@ void setup() {
   lv_obj_set_style_text_color(label, lv_color_black(), 0);
   lv_obj_align(label, LV_ALIGN_BOTTOM_MID, 0, -64);
 
-  static lv_image_dsc_t img_dsc;
-  img_dsc.header.cf = LV_COLOR_FORMAT_RGB565;
-  img_dsc.header.w = 148;
-  img_dsc.header.h = 148;
-  img_dsc.data_size = image_size;
-  img_dsc.data = image_data;
-
   lv_obj_t *img = lv_image_create(scr);
-  lv_image_set_src(img, &img_dsc);
+  lv_image_set_src(img, SPLASH_IMAGE);
   lv_obj_align(img, LV_ALIGN_CENTER, 0, 4);
 
   lv_refr_now(disp);
   delay(3000);
 
-  /* Cleanup splash */
-  lv_obj_delete(img);
-  lv_obj_delete(label);
-  if (image_data) {
-    free(image_data);
-    image_data = NULL;
+  /* Create dashboard with initial values, then drop the splash screen */
+  screen_mgr_register(SCREEN_DASHBOARD, &dashboard_screen_desc);
+  screen_mgr_register(SCREEN_MENU, &menu_screen_desc);
+  screen_mgr_register(SCREEN_SETTINGS, &settings_screen_desc);
+  screen_mgr_register(SCREEN_DIAG, &diag_screen_desc);
+  screen_mgr_register(SCREEN_TRENDS, &trend_screen_desc);
+  screen_mgr_register(SCREEN_MAP, &map_screen_desc);
+  if (!screen_mgr_show(SCREEN_DASHBOARD)) {
+    Serial.println("ERROR: Dashboard creation failed!");
+    while (1) delay(1000);
   }
-
-  /* Create dashboard with initial values */
-  create_ev_dashboard_ui();
+  lv_obj_delete(scr);
+  screen_mgr_begin();
   lv_refr_now(disp);
 
+  /* Grey out fields the controller stops sending */
+  staleness_begin();
+
+  /* Threshold alarms, shown over every screen */
+  alarms_begin();
+
+  /* Parse RS485 on the other core when LVGL runs on an OS */
+  rs485_in_task = rs485_start_task();
+
   Serial.println("\n=== Setup Complete ===");
   Serial.println("Waiting for RS485 data...");
 }
 
 unsigned long last_time_update = 0;
 
+// Line commands on the USB serial port: "metrics" prints all runtime metrics,
+// "screens" the screen manager state, "stress" times the draw stress screen,
+// "map" opens the map (tools/map_replay.py), "alarmbench" times the alarm rules
+static void poll_serial_commands() {
+  static char line[32];
+  static uint8_t len = 0;
+  while (Serial.available()) {
+    char c = Serial.read();
+    if (c != '\n' && c != '\r') {
+      if (len < sizeof(line) - 1) line[len++] = c;
+      continue;
+    }
+    line[len] = '\0';
+    if (strcmp(line, "metrics") == 0) metrics_dump();
+    else if (strcmp(line, "screens") == 0) {
+      lv_lock();
+      screen_mgr_dump();
+      lv_unlock();
+    }
+    else if (strcmp(line, "stress") == 0) draw_stress_run(DRAW_STRESS_FRAMES);
+    else if (strcmp(line, "alarmbench") == 0) alarms_bench(ALARM_BENCH_RULES, ALARM_BENCH_FRAMES);
+    else if (strcmp(line, "map") == 0) {
+      lv_lock();
+      screen_mgr_show(SCREEN_MAP);
+      lv_unlock();
+    }
+    len = 0;
+  }
+}
+
 void loop() {
-  lv_timer_handler();
+  uint32_t idle_ms = lv_timer_handler();
 
   // Update time every second
   if (millis() - last_time_update > 1000) {
+    lv_lock();  // dashData/UI may be shared with the RS485 task
     update_time_display();
+    odometer_update();
+    telemetry_log_poll();
+    lv_unlock();
     last_time_update = millis();
   }
 
   // Process RS485 frames and auto-update UI
-  read_rs485_frames();
+  if (!rs485_in_task) {
+    read_rs485_frames();
+  }
+
+  // Map tiles: missing ones now, prefetches only while LVGL has nothing due
+  map_screen_poll(idle_ms);
 
+  metrics_poll();
+  poll_serial_commands();
+  trace_poll();
   delay(5);
 }
\ No newline at end of file
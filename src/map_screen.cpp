@@ -0,0 +1,304 @@
+#include "map_screen.h"
+#include "map_tiles.h"
+#include <src/misc/lv_area_private.h>
+
+// Positions are kept as normalised web mercator (0..1 across the world) so a zoom
+// change only rescales them. The pane draws every tile of the view as an image
+// straight from the cache; tiles not read yet are filled with a placeholder and the
+// pane is redrawn when they arrive.
+
+// Tiles one pane can touch at the worst offset
+#define VIEW_TILES_X   ((MAP_SCREEN_VIEW_W + MAP_TILE_SIZE - 2) / MAP_TILE_SIZE + 1)
+#define VIEW_TILES_Y   ((MAP_SCREEN_VIEW_H + MAP_TILE_SIZE - 2) / MAP_TILE_SIZE + 1)
+#define VIEW_TILES     (VIEW_TILES_X * VIEW_TILES_Y)
+#define MAX_LAT_E7     850511287          // web mercator stops here
+#define DIR_MIN_PX     8                  // movement needed before it sets the direction
+#define DIR_SECTOR     0.38f              // sin(22.5 deg): diagonal beyond this
+
+static_assert(VIEW_TILES <= MAP_TILE_CACHE_TILES, "the tile cache can't hold the map pane");
+
+static const char *const zoom_map[] = { LV_SYMBOL_MINUS, LV_SYMBOL_PLUS, "" };
+static const char *const compass[] = { "N", "NE", "E", "SE", "S", "SW", "W", "NW" };
+
+static lv_obj_t *pane;
+static lv_obj_t *map_status;     // over the pane: no map / no position yet
+static lv_obj_t *map_speed;
+static lv_obj_t *map_info;
+static uint8_t zoom = MAP_SCREEN_ZOOM, zoom_min, zoom_max;
+static bool has_fix;
+static double merc_x, merc_y;
+static int32_t center_x, center_y;    // vehicle in world pixels at `zoom`
+static lv_area_t view;                // tiles in the pane
+static int32_t dir_ref_x, dir_ref_y;  // where the movement direction was last taken
+static bool dir_ref_set;
+static float dir_x, dir_y;            // direction of travel in screen axes, 0 if unknown
+
+static int32_t world_px(double m) {
+  return (int32_t)(m * (256.0 * (1UL << zoom)));
+}
+
+static void project(void) {
+  int32_t lat_e7 = LV_CLAMP(-MAX_LAT_E7, dashData.latitude, MAX_LAT_E7);
+  double lat = lat_e7 * 1e-7 * M_PI / 180.0;
+  merc_x = (dashData.longitude * 1e-7 + 180.0) / 360.0;
+  merc_y = (1.0 - log(tan(lat) + 1.0 / cos(lat)) / M_PI) / 2.0;
+}
+
+static void update_direction(void) {
+  if (dashData.heading >= 0) {
+    float h = dashData.heading * (float)M_PI / 180.0f;
+    dir_x = sinf(h);
+    dir_y = -cosf(h);
+    return;
+  }
+  if (!dir_ref_set) {
+    dir_ref_x = center_x;
+    dir_ref_y = center_y;
+    dir_ref_set = true;
+    return;
+  }
+  int32_t dx = center_x - dir_ref_x, dy = center_y - dir_ref_y;
+  if (LV_ABS(dx) + LV_ABS(dy) < DIR_MIN_PX) return;
+  float len = sqrtf((float)dx * dx + (float)dy * dy);
+  dir_x = dx / len;
+  dir_y = dy / len;
+  dir_ref_x = center_x;
+  dir_ref_y = center_y;
+}
+
+// The columns/rows just outside the view on the side(s) the vehicle is heading to,
+// farthest first: the prefetch queue reads the newest request first
+static void request_prefetch(void) {
+  int8_t sx = dir_x > DIR_SECTOR ? 1 : dir_x < -DIR_SECTOR ? -1 : 0;
+  int8_t sy = dir_y > DIR_SECTOR ? 1 : dir_y < -DIR_SECTOR ? -1 : 0;
+  for (int32_t d = MAP_SCREEN_PREFETCH_DEPTH; d >= 1; d--) {
+    int32_t y1 = view.y1 - (sy < 0 ? d : 0), y2 = view.y2 + (sy > 0 ? d : 0);
+    if (sx) {
+      int32_t x = sx > 0 ? view.x2 + d : view.x1 - d;
+      for (int32_t y = y1; y <= y2; y++) map_tiles_prefetch(zoom, x, y);
+    }
+    if (sy) {
+      int32_t y = sy > 0 ? view.y2 + d : view.y1 - d;
+      for (int32_t x = view.x1; x <= view.x2; x++) map_tiles_prefetch(zoom, x, y);
+    }
+  }
+}
+
+static void update_labels(void) {
+  lv_label_set_text_fmt(map_speed, "%d km/h", dashData.speed);
+
+  char heading[16] = "-";
+  if (dashData.heading >= 0) {
+    snprintf(heading, sizeof(heading), "%s %d°", compass[((dashData.heading + 22) / 45) % 8], dashData.heading);
+  }
+  uint32_t lat = LV_ABS(dashData.latitude), lon = LV_ABS(dashData.longitude);
+  lv_label_set_text_fmt(map_info, "Heading %s\n%lu.%05lu° %c\n%lu.%05lu° %c\nZoom %u", heading,
+                        (unsigned long)(lat / 10000000), (unsigned long)(lat % 10000000 / 100),
+                        dashData.latitude < 0 ? 'S' : 'N',
+                        (unsigned long)(lon / 10000000), (unsigned long)(lon % 10000000 / 100),
+                        dashData.longitude < 0 ? 'W' : 'E', zoom);
+}
+
+// Pan to the current position: new view, prefetch requests, redraw
+static void update_view(void) {
+  if (!has_fix || !zoom_max) return;
+  int32_t x = world_px(merc_x), y = world_px(merc_y);
+  if (x == center_x && y == center_y && view.x2 >= view.x1) return;
+  center_x = x;
+  center_y = y;
+
+  int32_t ox = center_x - MAP_SCREEN_VIEW_W / 2, oy = center_y - MAP_SCREEN_VIEW_H / 2;
+  lv_area_t tiles;
+  tiles.x1 = ox >> 6;
+  tiles.y1 = oy >> 6;
+  tiles.x2 = (ox + MAP_SCREEN_VIEW_W - 1) >> 6;
+  tiles.y2 = (oy + MAP_SCREEN_VIEW_H - 1) >> 6;
+  static_assert(MAP_TILE_SIZE == 64, "tile coordinates are pixels >> 6");
+  map_tiles_set_view(zoom, &tiles);
+  view = tiles;
+
+  update_direction();
+  request_prefetch();
+  lv_obj_invalidate(pane);
+}
+
+static void set_zoom(int8_t step) {
+  uint8_t z = LV_CLAMP(zoom_min, zoom + step, zoom_max);
+  if (z == zoom) return;
+  zoom = z;
+  dir_ref_set = false;           // pixels of the old zoom
+  view.x2 = view.x1 - 1;         // force a new view
+  update_view();
+  update_labels();
+}
+
+static void zoom_cb(lv_event_t *e) {
+  uint32_t i = lv_buttonmatrix_get_selected_button(lv_event_get_target_obj(e));
+  if (i < 2) set_zoom(i == 0 ? -1 : 1);
+}
+
+static void draw_cb(lv_event_t *e) {
+  if (!has_fix || !zoom_max) return;
+  lv_layer_t *layer = lv_event_get_layer(e);
+  lv_area_t coords;
+  lv_obj_get_coords(pane, &coords);
+  int32_t ox = center_x - MAP_SCREEN_VIEW_W / 2, oy = center_y - MAP_SCREEN_VIEW_H / 2;
+
+  lv_draw_image_dsc_t img_dsc;
+  lv_draw_image_dsc_init(&img_dsc);
+  lv_draw_rect_dsc_t fill_dsc;
+  lv_draw_rect_dsc_init(&fill_dsc);
+
+  for (int32_t ty = view.y1; ty <= view.y2; ty++) {
+    for (int32_t tx = view.x1; tx <= view.x2; tx++) {
+      lv_area_t a;
+      a.x1 = coords.x1 + tx * MAP_TILE_SIZE - ox;
+      a.y1 = coords.y1 + ty * MAP_TILE_SIZE - oy;
+      a.x2 = a.x1 + MAP_TILE_SIZE - 1;
+      a.y2 = a.y1 + MAP_TILE_SIZE - 1;
+      if (!lv_area_is_on(&a, &layer->_clip_area)) continue;
+
+      uint32_t index = map_tiles_index(zoom, tx, ty);
+      img_dsc.src = index != MAP_TILE_NONE ? map_tiles_get(index) : NULL;
+      if (img_dsc.src) {
+        lv_draw_image(layer, &img_dsc, &a);
+      } else {
+        // Outside the pack, or not read yet
+        fill_dsc.bg_color = lv_color_hex(index == MAP_TILE_NONE ? 0xd8d8d8 : 0xeeeeee);
+        lv_draw_rect(layer, &fill_dsc, &a);
+      }
+    }
+  }
+
+  // Vehicle: a dot, with a tick towards the direction of travel
+  int32_t cx = coords.x1 + MAP_SCREEN_VIEW_W / 2, cy = coords.y1 + MAP_SCREEN_VIEW_H / 2;
+  if (dir_x != 0 || dir_y != 0) {
+    lv_draw_line_dsc_t line_dsc;
+    lv_draw_line_dsc_init(&line_dsc);
+    line_dsc.color = lv_color_hex(0x0060ff);
+    line_dsc.width = 3;
+    line_dsc.round_end = 1;
+    line_dsc.p1.x = cx;
+    line_dsc.p1.y = cy;
+    line_dsc.p2.x = cx + (int32_t)(dir_x * 16);
+    line_dsc.p2.y = cy + (int32_t)(dir_y * 16);
+    lv_draw_line(layer, &line_dsc);
+  }
+  lv_area_t dot = { cx - 6, cy - 6, cx + 6, cy + 6 };
+  fill_dsc.bg_color = lv_color_hex(0x0060ff);
+  fill_dsc.radius = LV_RADIUS_CIRCLE;
+  fill_dsc.border_width = 2;
+  fill_dsc.border_color = lv_color_white();
+  lv_draw_rect(layer, &fill_dsc, &dot);
+}
+
+static void update_status(void) {
+  if (!zoom_max) lv_label_set_text(map_status, "Map unavailable");
+  else if (!has_fix) lv_label_set_text(map_status, "Waiting for position");
+  if (zoom_max && has_fix) lv_obj_add_flag(map_status, LV_OBJ_FLAG_HIDDEN);
+  else lv_obj_remove_flag(map_status, LV_OBJ_FLAG_HIDDEN);
+}
+
+static void deleted_cb(lv_event_t *e) {
+  map_tiles_end();
+  pane = NULL;
+  map_status = NULL;
+  map_speed = NULL;
+  map_info = NULL;
+  zoom_max = 0;
+}
+
+static lv_obj_t *build(void) {
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(scr, lv_color_hex(0xe5e5e5), 0);
+  lv_obj_add_event_cb(scr, deleted_cb, LV_EVENT_DELETE, NULL);
+
+  // Without the cache there's nothing to show; with the pack missing say so
+  if (map_tiles_begin(VIEW_TILES)) {
+    map_tiles_zoom_range(&zoom_min, &zoom_max);
+    zoom = LV_CLAMP(zoom_min, zoom, zoom_max);
+  } else {
+    zoom_min = zoom_max = 0;
+  }
+
+  screen_mgr_top_bar(scr, "Map");
+
+  pane = lv_obj_create(scr);
+  lv_obj_remove_style_all(pane);
+  lv_obj_set_size(pane, MAP_SCREEN_VIEW_W, MAP_SCREEN_VIEW_H);
+  lv_obj_align(pane, LV_ALIGN_LEFT_MID, 12, 27);
+  lv_obj_set_style_bg_color(pane, lv_color_hex(0xd8d8d8), 0);
+  lv_obj_set_style_bg_opa(pane, LV_OPA_COVER, 0);
+  lv_obj_add_event_cb(pane, draw_cb, LV_EVENT_DRAW_MAIN, NULL);
+
+  map_status = lv_label_create(pane);
+  lv_obj_set_style_text_color(map_status, lv_color_hex(0x555555), 0);
+  lv_obj_center(map_status);
+
+  map_speed = lv_label_create(scr);
+  lv_obj_set_style_text_color(map_speed, lv_color_black(), 0);
+  lv_obj_set_style_text_font(map_speed, &lv_font_montserrat_20, 0);
+  lv_obj_align(map_speed, LV_ALIGN_TOP_LEFT, MAP_SCREEN_VIEW_W + 32, 80);
+
+  map_info = lv_label_create(scr);
+  lv_obj_set_style_text_color(map_info, lv_color_black(), 0);
+  lv_obj_set_style_text_font(map_info, &lv_font_montserrat_16, 0);
+  lv_obj_align(map_info, LV_ALIGN_TOP_LEFT, MAP_SCREEN_VIEW_W + 32, 120);
+
+  lv_obj_t *zoom_btnm = lv_buttonmatrix_create(scr);
+  lv_buttonmatrix_set_map(zoom_btnm, zoom_map);
+  lv_obj_set_size(zoom_btnm, 140, 55);
+  lv_obj_align(zoom_btnm, LV_ALIGN_BOTTOM_LEFT, MAP_SCREEN_VIEW_W + 28, -16);
+  lv_obj_set_style_bg_opa(zoom_btnm, LV_OPA_TRANSP, 0);
+  lv_obj_set_style_border_width(zoom_btnm, 0, 0);
+  lv_obj_add_event_cb(zoom_btnm, zoom_cb, LV_EVENT_VALUE_CHANGED, NULL);
+  return scr;
+}
+
+static void on_show(lv_obj_t *scr) {
+  has_fix = dashData.latitude != 0 || dashData.longitude != 0;
+  if (has_fix) project();
+  dir_ref_set = false;
+  view.x2 = view.x1 - 1;
+  update_view();
+  update_labels();
+  update_status();
+}
+
+const screen_desc_t map_screen_desc = {
+  "map", build, on_show, NULL,
+  4 * 1024, VIEW_TILES * MAP_TILE_BYTES,
+  SCREEN_COUNT, false,
+};
+
+void map_screen_position_changed(void) {
+  if (!pane || screen_mgr_active() != SCREEN_MAP) return;
+  bool had_fix = has_fix;
+  has_fix = dashData.latitude != 0 || dashData.longitude != 0;
+  if (has_fix) project();
+  update_view();
+  update_labels();
+  if (had_fix != has_fix) update_status();
+}
+
+void map_screen_poll(uint32_t idle_ms) {
+  if (!pane || screen_mgr_active() != SCREEN_MAP) return;
+
+  // Tiles in view first, within the budget; then one prefetch if LVGL is idle
+  uint32_t start = micros();
+  bool redraw = false;
+  map_tiles_result_t r;
+  while ((r = map_tiles_load_next(false)) == MAP_TILES_LOADED) {
+    redraw = true;
+    if (micros() - start >= MAP_SCREEN_LOAD_BUDGET_US) break;
+  }
+  if (r == MAP_TILES_IDLE && idle_ms >= MAP_SCREEN_LOAD_MS) {
+    redraw |= map_tiles_load_next(true) == MAP_TILES_LOADED;
+  }
+
+  if (redraw) {
+    lv_lock();
+    if (pane) lv_obj_invalidate(pane);
+    lv_unlock();
+  }
+}
@@ -0,0 +1,355 @@
+#include "map_tiles.h"
+#include "metrics.h"
+#include <SD.h>
+
+// A slot whose tile is being read keeps its key but is skipped by lookups, so the
+// draw code never sees half-decoded pixels and eviction never picks it. The read
+// itself runs without lv_lock(): the slot is out of the view and unreachable.
+
+#define PACK_VERSION   1
+#define PACK_HEADER    8
+#define MAX_ZOOMS      8
+#define READ_CHUNK     512              // RLE tokens are at most 1 + 2 * 128 bytes
+#define BAD_TILE_COLOR 0xC618           // light grey in RGB565
+
+typedef struct __attribute__((packed)) {
+  uint8_t zoom;
+  uint8_t pad[3];
+  int32_t x0;
+  int32_t y0;
+  uint16_t cols;
+  uint16_t rows;
+  uint32_t first;
+} pack_zoom_t;
+
+typedef struct __attribute__((packed)) {
+  uint32_t offset;
+  uint16_t size;
+  uint8_t encoding;
+  uint8_t pad;
+} pack_entry_t;
+
+static_assert(sizeof(pack_zoom_t) == 20 && sizeof(pack_entry_t) == 8, "pack layout");
+static_assert(MAP_TILE_CACHE_TILES < 256, "slot counts are uint8_t");
+
+typedef struct {
+  uint32_t index;          // directory entry, MAP_TILE_NONE: free
+  int32_t x;
+  int32_t y;
+  uint8_t zoom;
+  bool loading;
+  bool prefetched;         // read ahead and not in view since
+  uint32_t used;           // lv_tick_get() of the last draw, for the LRU choice
+  lv_image_dsc_t img;      // img.data is NULL until the slot got a buffer
+} tile_slot_t;
+
+typedef struct {
+  uint8_t zoom;
+  int32_t x;
+  int32_t y;
+} tile_ref_t;
+
+static File pack;
+static pack_zoom_t zooms[MAX_ZOOMS];
+static uint8_t zoom_cnt;
+static tile_slot_t slots[MAP_TILE_CACHE_TILES];
+static uint8_t buf_cnt;                  // slots with a buffer
+static bool has_view;
+static uint8_t view_zoom;
+static lv_area_t view;
+static tile_ref_t requests[MAP_TILE_PREFETCH_QUEUE];   // newest last
+static uint8_t request_cnt;
+static uint8_t read_buf[READ_CHUNK];
+
+// ===== Directory =====
+static const pack_zoom_t *find_zoom(uint8_t zoom) {
+  for (uint8_t i = 0; i < zoom_cnt; i++) {
+    if (zooms[i].zoom == zoom) return &zooms[i];
+  }
+  return NULL;
+}
+
+static bool read_entry(uint32_t index, pack_entry_t *e) {
+  uint32_t pos = PACK_HEADER + zoom_cnt * sizeof(pack_zoom_t) + index * sizeof(pack_entry_t);
+  return pack.seek(pos) && pack.read((uint8_t *)e, sizeof(*e)) == sizeof(*e);
+}
+
+static bool decode_rle(uint32_t size, uint16_t *px) {
+  uint32_t left = size, have = 0, pos = 0, out = 0;
+  const uint32_t pixels = MAP_TILE_SIZE * MAP_TILE_SIZE;
+  while (out < pixels) {
+    if (have - pos < 1 + 2 * 128 && left) {
+      memmove(read_buf, read_buf + pos, have - pos);
+      have -= pos;
+      pos = 0;
+      uint32_t n = LV_MIN(left, sizeof(read_buf) - have);
+      if (pack.read(read_buf + have, n) != n) return false;
+      have += n;
+      left -= n;
+    }
+    if (pos >= have) return false;
+
+    uint8_t c = read_buf[pos++];
+    uint32_t n = (c & 0x7F) + 1;
+    if (out + n > pixels) return false;
+    if (c & 0x80) {
+      if (have - pos < 2) return false;
+      uint16_t color = read_buf[pos] | (read_buf[pos + 1] << 8);
+      pos += 2;
+      while (n--) px[out++] = color;
+    } else {
+      if (have - pos < 2 * n) return false;
+      memcpy(px + out, read_buf + pos, 2 * n);
+      pos += 2 * n;
+      out += n;
+    }
+  }
+  return true;
+}
+
+static bool read_tile(uint32_t index, uint16_t *px) {
+  pack_entry_t e;
+  if (!read_entry(index, &e) || !pack.seek(e.offset)) return false;
+  if (e.encoding == MAP_TILE_RAW) {
+    return e.size == MAP_TILE_BYTES && pack.read((uint8_t *)px, MAP_TILE_BYTES) == MAP_TILE_BYTES;
+  }
+  if (e.encoding == MAP_TILE_RLE) return decode_rle(e.size, px);
+  return false;
+}
+
+// ===== Cache =====
+static bool in_view(uint8_t zoom, int32_t x, int32_t y) {
+  return has_view && zoom == view_zoom && x >= view.x1 && x <= view.x2 && y >= view.y1 && y <= view.y2;
+}
+
+static tile_slot_t *find_slot(uint32_t index) {
+  for (uint8_t i = 0; i < buf_cnt; i++) {
+    if (slots[i].index == index && !slots[i].loading) return &slots[i];
+  }
+  return NULL;
+}
+
+static bool is_pending(uint32_t index) {
+  for (uint8_t i = 0; i < buf_cnt; i++) {
+    if (slots[i].index == index) return true;
+  }
+  return false;
+}
+
+static void update_cached_gauge(void) {
+  uint32_t n = 0;
+  for (uint8_t i = 0; i < buf_cnt; i++) {
+    if (slots[i].index != MAP_TILE_NONE && !slots[i].loading) n++;
+  }
+  metrics_set(MET_MAP_TILES_CACHED, n);
+}
+
+static bool add_buffer(void) {
+  if (buf_cnt == MAP_TILE_CACHE_TILES) return false;
+  // PSRAM if the board has it, else internal RAM while the reserve holds
+  void *px = heap_caps_malloc(MAP_TILE_BYTES, MALLOC_CAP_SPIRAM);
+  if (!px && ESP.getFreeHeap() >= MAP_TILE_BYTES + MAP_TILE_HEAP_RESERVE) px = malloc(MAP_TILE_BYTES);
+  if (!px) return false;
+
+  tile_slot_t *s = &slots[buf_cnt++];
+  memset(s, 0, sizeof(*s));
+  s->index = MAP_TILE_NONE;
+  s->img.header.magic = LV_IMAGE_HEADER_MAGIC;
+  s->img.header.cf = LV_COLOR_FORMAT_RGB565;
+  s->img.header.w = MAP_TILE_SIZE;
+  s->img.header.h = MAP_TILE_SIZE;
+  s->img.header.stride = MAP_TILE_SIZE * 2;
+  s->img.data_size = MAP_TILE_BYTES;
+  s->img.data = (const uint8_t *)px;
+  return true;
+}
+
+// A free slot, a new buffer, or the least recently drawn tile outside the view. A
+// prefetch doesn't take the slot of another one not shown yet, or requests that
+// outnumber the spare slots would keep evicting each other.
+static tile_slot_t *take_slot(bool prefetch) {
+  for (uint8_t i = 0; i < buf_cnt; i++) {
+    if (slots[i].index == MAP_TILE_NONE) return &slots[i];
+  }
+  if (add_buffer()) return &slots[buf_cnt - 1];
+
+  tile_slot_t *lru = NULL;
+  for (uint8_t i = 0; i < buf_cnt; i++) {
+    tile_slot_t *s = &slots[i];
+    if (s->loading || (prefetch && s->prefetched) || in_view(s->zoom, s->x, s->y)) continue;
+    if (!lru || (int32_t)(s->used - lru->used) < 0) lru = s;
+  }
+  return lru;
+}
+
+// The uncached tile of the view closest to its centre
+static bool next_visible(tile_ref_t *t) {
+  if (!has_view) return false;
+  int32_t cx = (view.x1 + view.x2) / 2, cy = (view.y1 + view.y2) / 2;
+  int32_t best_d = INT32_MAX;
+  for (int32_t y = view.y1; y <= view.y2; y++) {
+    for (int32_t x = view.x1; x <= view.x2; x++) {
+      uint32_t index = map_tiles_index(view_zoom, x, y);
+      if (index == MAP_TILE_NONE || is_pending(index)) continue;
+      int32_t d = LV_ABS(x - cx) + LV_ABS(y - cy);
+      if (d < best_d) {
+        best_d = d;
+        *t = { view_zoom, x, y };
+      }
+    }
+  }
+  return best_d != INT32_MAX;
+}
+
+static bool next_request(tile_ref_t *t) {
+  while (request_cnt) {
+    *t = requests[--request_cnt];
+    uint32_t index = map_tiles_index(t->zoom, t->x, t->y);
+    if (index != MAP_TILE_NONE && !is_pending(index)) return true;
+  }
+  return false;
+}
+
+// ===== API =====
+bool map_tiles_begin(uint8_t min_tiles) {
+  if (pack) return true;
+  pack = SD.open(MAP_TILE_PACK, FILE_READ);
+  if (!pack) {
+    LV_LOG_WARN("no map pack %s", MAP_TILE_PACK);
+    return false;
+  }
+
+  uint8_t header[PACK_HEADER];
+  bool ok = pack.read(header, sizeof(header)) == sizeof(header) && memcmp(header, "DMAP", 4) == 0 &&
+            header[4] == PACK_VERSION && header[5] > 0 && header[5] <= MAX_ZOOMS &&
+            (header[6] | (header[7] << 8)) == MAP_TILE_SIZE;
+  if (ok) {
+    zoom_cnt = header[5];
+    uint32_t n = zoom_cnt * sizeof(pack_zoom_t);
+    ok = pack.read((uint8_t *)zooms, n) == n;
+  }
+  while (ok && buf_cnt < min_tiles) ok = add_buffer();
+  if (!ok) {
+    LV_LOG_WARN("can't use map pack %s", MAP_TILE_PACK);
+    map_tiles_end();
+    return false;
+  }
+  return true;
+}
+
+void map_tiles_end(void) {
+  for (uint8_t i = 0; i < buf_cnt; i++) free((void *)slots[i].img.data);
+  buf_cnt = 0;
+  zoom_cnt = 0;
+  has_view = false;
+  request_cnt = 0;
+  if (pack) pack.close();
+  metrics_set(MET_MAP_TILES_CACHED, 0);
+}
+
+bool map_tiles_zoom_range(uint8_t *min, uint8_t *max) {
+  if (!zoom_cnt) return false;
+  *min = UINT8_MAX;
+  *max = 0;
+  for (uint8_t i = 0; i < zoom_cnt; i++) {
+    *min = LV_MIN(*min, zooms[i].zoom);
+    *max = LV_MAX(*max, zooms[i].zoom);
+  }
+  return true;
+}
+
+uint32_t map_tiles_index(uint8_t zoom, int32_t x, int32_t y) {
+  const pack_zoom_t *z = find_zoom(zoom);
+  if (!z) return MAP_TILE_NONE;
+  int32_t col = x - z->x0, row = y - z->y0;
+  if (col < 0 || row < 0 || col >= z->cols || row >= z->rows) return MAP_TILE_NONE;
+  return z->first + (uint32_t)row * z->cols + col;
+}
+
+const lv_image_dsc_t *map_tiles_get(uint32_t index) {
+  tile_slot_t *s = find_slot(index);
+  if (!s) return NULL;
+  s->used = lv_tick_get();
+  return &s->img;
+}
+
+void map_tiles_set_view(uint8_t zoom, const lv_area_t *tiles) {
+  for (int32_t y = tiles->y1; y <= tiles->y2; y++) {
+    for (int32_t x = tiles->x1; x <= tiles->x2; x++) {
+      if (in_view(zoom, x, y)) continue;
+      uint32_t index = map_tiles_index(zoom, x, y);
+      if (index == MAP_TILE_NONE) continue;
+
+      tile_slot_t *s = find_slot(index);
+      if (!s) {
+        metrics_add(MET_MAP_TILE_MISSES, 1);
+        continue;
+      }
+      metrics_add(MET_MAP_TILE_HITS, 1);
+      if (s->prefetched) metrics_add(MET_MAP_PREFETCH_HITS, 1);
+      s->prefetched = false;
+      s->used = lv_tick_get();
+    }
+  }
+  has_view = true;
+  view_zoom = zoom;
+  view = *tiles;
+}
+
+void map_tiles_prefetch(uint8_t zoom, int32_t x, int32_t y) {
+  uint32_t index = map_tiles_index(zoom, x, y);
+  if (index == MAP_TILE_NONE || is_pending(index)) return;
+  for (uint8_t i = 0; i < request_cnt; i++) {
+    if (requests[i].zoom == zoom && requests[i].x == x && requests[i].y == y) return;
+  }
+  if (request_cnt == MAP_TILE_PREFETCH_QUEUE) {
+    memmove(requests, requests + 1, (MAP_TILE_PREFETCH_QUEUE - 1) * sizeof(requests[0]));
+    request_cnt--;
+  }
+  requests[request_cnt++] = { zoom, x, y };
+}
+
+map_tiles_result_t map_tiles_load_next(bool prefetch) {
+  if (!pack) return MAP_TILES_IDLE;
+
+  lv_lock();
+  tile_ref_t t;
+  bool visible = next_visible(&t);
+  if (!visible && !(prefetch && next_request(&t))) {
+    lv_unlock();
+    return MAP_TILES_IDLE;
+  }
+  tile_slot_t *s = take_slot(!visible);
+  if (!s) {
+    lv_unlock();
+    return MAP_TILES_NO_BUFFER;
+  }
+  s->index = map_tiles_index(t.zoom, t.x, t.y);
+  s->zoom = t.zoom;
+  s->x = t.x;
+  s->y = t.y;
+  s->loading = true;
+  lv_unlock();
+
+  uint32_t start = micros();
+  bool ok = read_tile(s->index, (uint16_t *)s->img.data);
+  metrics_observe_us(MET_H_MAP_TILE_LOAD, micros() - start);
+  metrics_add(MET_MAP_TILE_LOADS, 1);
+
+  if (!ok) {
+    // Keep it as a blank tile so a damaged pack isn't read again on every poll
+    LV_LOG_WARN("bad map tile %lu", (unsigned long)s->index);
+    uint16_t *px = (uint16_t *)s->img.data;
+    for (uint32_t i = 0; i < MAP_TILE_SIZE * MAP_TILE_SIZE; i++) px[i] = BAD_TILE_COLOR;
+  }
+
+  lv_lock();
+  s->loading = false;
+  s->used = lv_tick_get();
+  // Counted as a miss if it came into view while being read
+  bool shown = in_view(s->zoom, s->x, s->y);
+  s->prefetched = !shown;
+  update_cached_gauge();
+  lv_unlock();
+  return shown ? MAP_TILES_LOADED : MAP_TILES_PREFETCHED;
+}
@@ -0,0 +1,37 @@
+#include "menu_screen.h"
+
+// One button matrix instead of a button and label per entry keeps the screen at a
+// handful of objects.
+
+static const char *const entries[] = { "Trends", "\n", "Diagnostics", "\n", "Settings", "" };
+static const screen_id_t targets[] = { SCREEN_TRENDS, SCREEN_DIAG, SCREEN_SETTINGS };
+
+static void clicked_cb(lv_event_t *e) {
+  lv_obj_t *btnm = lv_event_get_target_obj(e);
+  uint32_t i = lv_buttonmatrix_get_selected_button(btnm);
+  if (i < sizeof(targets) / sizeof(targets[0])) screen_mgr_show(targets[i]);
+}
+
+static lv_obj_t *build(void) {
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(scr, lv_color_hex(0xe5e5e5), 0);
+
+  screen_mgr_top_bar(scr, "Menu");
+
+  lv_obj_t *btnm = lv_buttonmatrix_create(scr);
+  lv_buttonmatrix_set_map(btnm, entries);
+  lv_obj_set_size(btnm, 300, 230);
+  lv_obj_align(btnm, LV_ALIGN_CENTER, 0, 25);
+  lv_obj_set_style_bg_opa(btnm, LV_OPA_TRANSP, 0);
+  lv_obj_set_style_border_width(btnm, 0, 0);
+  lv_obj_set_style_pad_row(btnm, 12, 0);
+  lv_obj_set_style_text_font(btnm, &lv_font_montserrat_20, 0);
+  lv_obj_add_event_cb(btnm, clicked_cb, LV_EVENT_VALUE_CHANGED, NULL);
+  return scr;
+}
+
+const screen_desc_t menu_screen_desc = {
+  "menu", build, NULL, NULL,
+  2 * 1024, 0,
+  SCREEN_DIAG, false,
+};
@@ -0,0 +1,193 @@
+#include "metrics.h"
+
+typedef enum { COUNTER, GAUGE } metric_kind_t;
+
+typedef struct {
+  const char *name;
+  metric_kind_t kind;
+} metric_info_t;
+
+static const metric_info_t infos[METRIC_COUNT] = {
+  { "rs485.bytes",           COUNTER },
+  { "rs485.frames",          COUNTER },
+  { "rs485.bad_frames",      COUNTER },
+  { "rs485.resyncs",         COUNTER },
+  { "rs485.silences",        COUNTER },
+  { "rs485.stale_fields",    GAUGE },
+  { "rs485.stack_free",      GAUGE },
+  { "lv.renders",            COUNTER },
+  { "lv.flush_px",           COUNTER },
+  { "touch.presses",         COUNTER },
+  { "screen.builds",         COUNTER },
+  { "screen.preloads",       COUNTER },
+  { "screen.evictions",      COUNTER },
+  { "screen.resident",       GAUGE },
+  { "map.tile_hits",         COUNTER },
+  { "map.tile_misses",       COUNTER },
+  { "map.tile_loads",        COUNTER },
+  { "map.prefetch_hits",     COUNTER },
+  { "map.tiles_cached",      GAUGE },
+  { "alarm.rule_evals",      COUNTER },
+  { "alarm.raises",          COUNTER },
+  { "alarm.active",          GAUGE },
+  { "tlog.dropped",          COUNTER },
+  { "tlog.write_errors",     COUNTER },
+  { "lv.heap_used",          GAUGE },
+  { "lv.heap_peak_alloc",    GAUGE },
+  { "lv.heap_free_block",    GAUGE },
+  { "lv.heap_frag_pct",      GAUGE },
+  { "sys.heap_free",         GAUGE },
+  { "sys.heap_min_free",     GAUGE },
+  { "sys.heap_largest",      GAUGE },
+};
+
+static const char *const hist_names[METRIC_HIST_COUNT] = {
+  "rs485.frame_us",
+  "lv.render_us",
+  "lv.flush_us",
+  "touch.read_us",
+  "screen.build_us",
+  "screen.show_us",
+  "map.tile_load_us",
+};
+
+static const uint32_t bucket_us[METRICS_BUCKETS - 1] = METRICS_BUCKET_US;
+
+typedef struct {
+  uint32_t buckets[METRICS_BUCKETS];
+  uint32_t max;
+} metric_hist_data_t;
+
+static uint32_t values[METRIC_COUNT];
+static metric_hist_data_t hists[METRIC_HIST_COUNT];
+
+// ===== Updates =====
+void metrics_add(metric_t m, uint32_t n) {
+  __atomic_fetch_add(&values[m], n, __ATOMIC_RELAXED);
+}
+
+void metrics_set(metric_t m, uint32_t v) {
+  __atomic_store_n(&values[m], v, __ATOMIC_RELAXED);
+}
+
+uint32_t metrics_get(metric_t m) {
+  return __atomic_load_n(&values[m], __ATOMIC_RELAXED);
+}
+
+void metrics_observe_us(metric_hist_t h, uint32_t us) {
+  metric_hist_data_t *d = &hists[h];
+  uint8_t b = 0;
+  while (b < METRICS_BUCKETS - 1 && us > bucket_us[b]) b++;
+  __atomic_fetch_add(&d->buckets[b], 1, __ATOMIC_RELAXED);
+
+  uint32_t max = __atomic_load_n(&d->max, __ATOMIC_RELAXED);
+  while (us > max &&
+         !__atomic_compare_exchange_n(&d->max, &max, us, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+}
+
+// ===== Display events =====
+static void display_event_cb(lv_event_t *e) {
+  static uint32_t render_start;
+  static uint32_t flush_start;
+
+  switch (lv_event_get_code(e)) {
+    case LV_EVENT_RENDER_START:
+      render_start = micros();
+      break;
+    case LV_EVENT_RENDER_READY:
+      metrics_add(MET_RENDERS, 1);
+      metrics_observe_us(MET_H_RENDER, micros() - render_start);
+      break;
+    case LV_EVENT_FLUSH_START:
+      flush_start = micros();
+      break;
+    case LV_EVENT_FLUSH_FINISH: {
+      metrics_observe_us(MET_H_FLUSH, micros() - flush_start);
+      const lv_area_t *a = (const lv_area_t *)lv_event_get_param(e);
+      metrics_add(MET_FLUSH_PIXELS, lv_area_get_size(a));
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void metrics_attach_display(lv_display_t *disp) {
+  lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_RENDER_START, NULL);
+  lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_RENDER_READY, NULL);
+  lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_FLUSH_START, NULL);
+  lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_FLUSH_FINISH, NULL);
+}
+
+void metrics_poll(void) {
+  static uint32_t last_sample;
+  if (millis() - last_sample < METRICS_SAMPLE_INTERVAL_MS) return;
+  last_sample = millis();
+
+  lv_mem_monitor_t mon;
+  lv_lock();
+  lv_mem_monitor(&mon);
+  lv_unlock();
+  metrics_set(MET_LV_HEAP_USED, mon.total_size - mon.free_size);
+  metrics_set(MET_LV_HEAP_PEAK_ALLOC, mon.max_used);
+  metrics_set(MET_LV_HEAP_BIGGEST_FREE, mon.free_biggest_size);
+  metrics_set(MET_LV_HEAP_FRAG, mon.frag_pct);
+  metrics_set(MET_SYS_HEAP_FREE, ESP.getFreeHeap());
+  metrics_set(MET_SYS_HEAP_MIN_FREE, ESP.getMinFreeHeap());
+  metrics_set(MET_SYS_HEAP_LARGEST, heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+}
+
+// ===== Printing =====
+const char *metrics_row_name(uint16_t row) {
+  if (row < METRIC_COUNT) return infos[row].name;
+  return hist_names[row - METRIC_COUNT];
+}
+
+// Upper bound of the bucket holding the sample of rank `rank` (0-based); the
+// open-ended last bucket reports the maximum
+static uint32_t percentile(const uint32_t *buckets, uint32_t max, uint32_t rank) {
+  for (uint8_t b = 0; b < METRICS_BUCKETS - 1; b++) {
+    if (rank < buckets[b]) return LV_MIN(bucket_us[b], max);
+    rank -= buckets[b];
+  }
+  return max;
+}
+
+void metrics_row_value(uint16_t row, char *buf, size_t size) {
+  if (row < METRIC_COUNT) {
+    snprintf(buf, size, "%lu", (unsigned long)metrics_get((metric_t)row));
+    return;
+  }
+
+  // A snapshot; samples landing meanwhile may be half counted, which is fine here
+  const metric_hist_data_t *d = &hists[row - METRIC_COUNT];
+  uint32_t buckets[METRICS_BUCKETS];
+  uint32_t n = 0;
+  for (uint8_t b = 0; b < METRICS_BUCKETS; b++) {
+    buckets[b] = __atomic_load_n(&d->buckets[b], __ATOMIC_RELAXED);
+    n += buckets[b];
+  }
+  uint32_t max = __atomic_load_n(&d->max, __ATOMIC_RELAXED);
+  if (n == 0) {
+    snprintf(buf, size, "n=0");
+    return;
+  }
+  snprintf(buf, size, "n=%lu p50<=%lu p99<=%lu max=%lu", (unsigned long)n,
+           (unsigned long)percentile(buckets, max, n / 2),
+           (unsigned long)percentile(buckets, max, n - 1 - n / 100),
+           (unsigned long)max);
+}
+
+static const char *row_kind(uint16_t row) {
+  if (row >= METRIC_COUNT) return "hist";
+  return infos[row].kind == COUNTER ? "counter" : "gauge";
+}
+
+void metrics_dump(void) {
+  char value[64];
+  for (uint16_t row = 0; row < METRICS_ROWS; row++) {
+    metrics_row_value(row, value, sizeof(value));
+    Serial.printf("%s %s %s\n", metrics_row_name(row), row_kind(row), value);
+  }
+}
@@ -0,0 +1,258 @@
+#include "num_label.h"
+
+// The number is a row of cells holding ' ', '0'-'9', '-' or '.'. Digit cells are all
+// as wide as the widest digit and the glyph is centered in its cell; the sign takes
+// the cell left of the first digit, right-aligned in it. Only the decimal point cell
+// is narrower, and it never moves because the number of decimals is fixed.
+
+static const char NUM_CHARS[] = "0123456789-.";
+
+typedef struct {
+  char *prefix;
+  char *suffix;
+  int32_t min;
+  int32_t max;
+  int32_t value;
+  uint8_t decimals;
+  uint8_t cell_cnt;
+  char cells[NUM_LABEL_MAX_CELLS];
+  // From the font, see update_geometry()
+  const lv_font_t *font;
+  int32_t letter_space;
+  int32_t prefix_w;
+  lv_point_t size;           // reported as the content size
+  int32_t digit_w;
+  int32_t point_w;
+  int32_t ink_pad;           // how far glyphs can reach out of their cell
+} num_label_t;
+
+static num_label_t *get_num_label(lv_obj_t *obj) {
+  return (num_label_t *)lv_obj_get_user_data(obj);
+}
+
+static uint8_t count_digits(uint32_t v) {
+  uint8_t n = 1;
+  while (v >= 10) {
+    v /= 10;
+    n++;
+  }
+  return n;
+}
+
+static uint32_t abs_u32(int32_t v) {
+  return v < 0 ? 0u - (uint32_t)v : (uint32_t)v;
+}
+
+static bool is_point_cell(const num_label_t *nl, uint8_t i) {
+  return nl->decimals && i == nl->cell_cnt - nl->decimals - 1;
+}
+
+static int32_t cell_x(const num_label_t *nl, uint8_t i) {
+  int32_t x = nl->prefix_w;
+  for (uint8_t c = 0; c < i; c++) x += is_point_cell(nl, c) ? nl->point_w : nl->digit_w;
+  return x;
+}
+
+static void format_cells(const num_label_t *nl, int32_t v, char *out) {
+  uint32_t a = abs_u32(v);
+  int8_t i = nl->cell_cnt - 1;
+
+  for (uint8_t d = 0; d < nl->decimals; d++, a /= 10) out[i--] = '0' + a % 10;
+  if (nl->decimals) out[i--] = '.';
+  do {
+    out[i--] = '0' + a % 10;
+    a /= 10;
+  } while (a && i >= 0);
+  if (v < 0 && i >= 0) out[i--] = '-';
+  while (i >= 0) out[i--] = ' ';
+}
+
+static int32_t text_width(const char *txt, const lv_font_t *font, int32_t letter_space) {
+  if (!txt || !txt[0]) return 0;
+  lv_point_t size;
+  lv_text_get_size(&size, txt, font, letter_space, 0, LV_COORD_MAX, LV_TEXT_FLAG_NONE);
+  return size.x + letter_space;
+}
+
+// Size for the widest value; only when the font or the texts change
+static void update_geometry(lv_obj_t *obj) {
+  num_label_t *nl = get_num_label(obj);
+  const lv_font_t *font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+  int32_t letter_space = lv_obj_get_style_text_letter_space(obj, LV_PART_MAIN);
+  nl->font = font;
+  nl->letter_space = letter_space;
+
+  nl->digit_w = 0;
+  nl->point_w = 0;
+  nl->ink_pad = 0;
+  for (const char *c = NUM_CHARS; *c; c++) {
+    lv_font_glyph_dsc_t g;
+    lv_font_get_glyph_dsc(font, &g, *c, 0);
+    if (*c == '.') nl->point_w = g.adv_w;
+    else nl->digit_w = LV_MAX(nl->digit_w, (int32_t)g.adv_w);
+    nl->ink_pad = LV_MAX(nl->ink_pad, LV_MAX(-g.ofs_x, g.ofs_x + g.box_w - g.adv_w));
+  }
+  nl->digit_w += letter_space;
+  nl->point_w += letter_space;
+  nl->prefix_w = text_width(nl->prefix, font, letter_space);
+
+  nl->size.x = cell_x(nl, nl->cell_cnt) + text_width(nl->suffix, font, letter_space);
+  nl->size.y = lv_font_get_line_height(font);
+  lv_obj_refresh_self_size(obj);
+  lv_obj_refresh_ext_draw_size(obj);
+  lv_obj_invalidate(obj);
+}
+
+static void get_cell_area(lv_obj_t *obj, const num_label_t *nl, uint8_t i, lv_area_t *a) {
+  lv_obj_get_coords(obj, a);
+  a->x1 += cell_x(nl, i);
+  a->x2 = a->x1 + (is_point_cell(nl, i) ? nl->point_w : nl->digit_w) - 1;
+  lv_area_increase(a, nl->ink_pad, nl->ink_pad);
+}
+
+static void draw_cb(lv_event_t *e) {
+  lv_obj_t *obj = (lv_obj_t *)lv_event_get_target(e);
+  num_label_t *nl = get_num_label(obj);
+  lv_layer_t *layer = lv_event_get_layer(e);
+
+  lv_draw_label_dsc_t dsc;
+  lv_draw_label_dsc_init(&dsc);
+  lv_obj_init_draw_label_dsc(obj, LV_PART_MAIN, &dsc);
+  dsc.align = LV_TEXT_ALIGN_LEFT;
+
+  lv_area_t coords;
+  lv_obj_get_coords(obj, &coords);
+
+  // The texts live as long as the object, so the draw tasks needn't copy them
+  dsc.text_static = 1;
+  if (nl->prefix) {
+    dsc.text = nl->prefix;
+    lv_draw_label(layer, &dsc, &coords);
+  }
+  if (nl->suffix) {
+    lv_area_t a = coords;
+    a.x1 += cell_x(nl, nl->cell_cnt);
+    dsc.text = nl->suffix;
+    lv_draw_label(layer, &dsc, &a);
+  }
+  dsc.text_static = 0;
+
+  int32_t letter_space = lv_obj_get_style_text_letter_space(obj, LV_PART_MAIN);
+  for (uint8_t i = 0; i < nl->cell_cnt; i++) {
+    char c = nl->cells[i];
+    if (c == ' ') continue;
+
+    // Skip the cells outside of the area being redrawn without creating a task
+    lv_area_t a;
+    get_cell_area(obj, nl, i, &a);
+    const lv_area_t *clip = &layer->_clip_area;
+    if (a.x2 < clip->x1 || a.x1 > clip->x2 || a.y2 < clip->y1 || a.y1 > clip->y2) continue;
+
+    // Digits are centered; the sign hugs the first digit
+    int32_t w = (is_point_cell(nl, i) ? nl->point_w : nl->digit_w) - letter_space;
+    int32_t space = w - lv_font_get_glyph_width(dsc.font, c, 0);
+    lv_point_t pos;
+    pos.x = coords.x1 + cell_x(nl, i) + (c == '-' ? space : space / 2);
+    pos.y = coords.y1;
+    lv_draw_character(layer, &dsc, &pos, c);
+  }
+}
+
+// Other style changes (e.g. the text opacity of ui_set_stale()) keep the geometry,
+// and LVGL already redraws the object for them
+static void style_changed_cb(lv_event_t *e) {
+  lv_obj_t *obj = (lv_obj_t *)lv_event_get_target(e);
+  num_label_t *nl = get_num_label(obj);
+  if (lv_obj_get_style_text_font(obj, LV_PART_MAIN) == nl->font &&
+      lv_obj_get_style_text_letter_space(obj, LV_PART_MAIN) == nl->letter_space) return;
+  update_geometry(obj);
+}
+
+static void self_size_cb(lv_event_t *e) {
+  num_label_t *nl = get_num_label((lv_obj_t *)lv_event_get_target(e));
+  lv_point_t *p = (lv_point_t *)lv_event_get_param(e);
+  p->x = LV_MAX(p->x, nl->size.x);
+  p->y = LV_MAX(p->y, nl->size.y);
+}
+
+static void ext_draw_size_cb(lv_event_t *e) {
+  num_label_t *nl = get_num_label((lv_obj_t *)lv_event_get_target(e));
+  lv_event_set_ext_draw_size(e, nl->ink_pad);
+}
+
+static void delete_cb(lv_event_t *e) {
+  num_label_t *nl = get_num_label((lv_obj_t *)lv_event_get_target(e));
+  lv_free(nl->prefix);
+  lv_free(nl->suffix);
+  lv_free(nl);
+}
+
+lv_obj_t *num_label_create(lv_obj_t *parent, int32_t min, int32_t max, uint8_t decimals) {
+  num_label_t *nl = (num_label_t *)lv_zalloc(sizeof(num_label_t));
+  if (!nl) return NULL;
+
+  uint32_t scale = 1;
+  for (uint8_t d = 0; d < decimals; d++) scale *= 10;
+  uint8_t int_digits = count_digits(LV_MAX(abs_u32(min), abs_u32(max)) / scale);
+  uint8_t cells = int_digits + (min < 0 ? 1 : 0) + (decimals ? decimals + 1 : 0);
+  if (cells > NUM_LABEL_MAX_CELLS) {
+    LV_LOG_WARN("num_label: %u cells needed, max. %u", cells, NUM_LABEL_MAX_CELLS);
+    lv_free(nl);
+    return NULL;
+  }
+
+  nl->min = min;
+  nl->max = max > min ? max : min;
+  nl->decimals = decimals;
+  nl->cell_cnt = cells;
+  nl->value = LV_CLAMP(nl->min, 0, nl->max);
+  format_cells(nl, nl->value, nl->cells);
+
+  lv_obj_t *obj = lv_obj_create(parent);
+  lv_obj_remove_style_all(obj);
+  lv_obj_remove_flag(obj, LV_OBJ_FLAG_CLICKABLE);
+  lv_obj_remove_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_set_size(obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+  lv_obj_set_user_data(obj, nl);
+  lv_obj_add_event_cb(obj, draw_cb, LV_EVENT_DRAW_MAIN, NULL);
+  lv_obj_add_event_cb(obj, style_changed_cb, LV_EVENT_STYLE_CHANGED, NULL);
+  lv_obj_add_event_cb(obj, self_size_cb, LV_EVENT_GET_SELF_SIZE, NULL);
+  lv_obj_add_event_cb(obj, ext_draw_size_cb, LV_EVENT_REFR_EXT_DRAW_SIZE, NULL);
+  lv_obj_add_event_cb(obj, delete_cb, LV_EVENT_DELETE, NULL);
+  update_geometry(obj);
+  return obj;
+}
+
+static char *dup_text(const char *txt) {
+  return txt && txt[0] ? lv_strdup(txt) : NULL;
+}
+
+void num_label_set_text(lv_obj_t *obj, const char *prefix, const char *suffix) {
+  num_label_t *nl = get_num_label(obj);
+  lv_free(nl->prefix);
+  lv_free(nl->suffix);
+  nl->prefix = dup_text(prefix);
+  nl->suffix = dup_text(suffix);
+  update_geometry(obj);
+}
+
+void num_label_set_value(lv_obj_t *obj, int32_t value) {
+  num_label_t *nl = get_num_label(obj);
+  value = LV_CLAMP(nl->min, value, nl->max);
+  if (value == nl->value) return;
+  nl->value = value;
+
+  char cells[NUM_LABEL_MAX_CELLS];
+  format_cells(nl, value, cells);
+  for (uint8_t i = 0; i < nl->cell_cnt; i++) {
+    if (cells[i] == nl->cells[i]) continue;
+    nl->cells[i] = cells[i];
+    lv_area_t a;
+    get_cell_area(obj, nl, i, &a);
+    lv_obj_invalidate_area(obj, &a);
+  }
+}
+
+int32_t num_label_get_value(lv_obj_t *obj) {
+  return get_num_label(obj)->value;
+}
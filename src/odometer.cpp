@@ -0,0 +1,200 @@
+#include "odometer.h"
+#include "rs485.h"
+#ifdef ARDUINO
+#include <esp_partition.h>
+#endif
+
+// The store is an append-only log of fixed-size records spread round-robin over
+// all sectors, so every sector is erased equally often. The first slot of each
+// sector holds the oldest record in it: comparing those sequence numbers finds the
+// newest sector in O(sectors), and a binary search for the first erased slot finds
+// the end of the log inside it. A write torn by a power cut fails its CRC and is
+// skipped; the record before it is restored instead.
+
+#define ODO_RECORD_MAGIC  0x0D0Du
+#define ODO_SECTOR_SIZE   4096     // ESP32 flash erase unit
+
+typedef struct {
+  uint32_t seq;      // increases by one per record
+  int32_t odo;
+  int32_t trip;
+  uint16_t magic;
+  uint16_t crc;      // CRC-16 over the fields above
+} odo_record_t;
+
+static const odo_flash_t *flash = NULL;
+static uint16_t cur_sector = 0;
+static uint32_t next_slot = 0;     // first free slot in cur_sector
+static uint32_t last_seq = 0;
+static bool have_record = false;
+
+static int32_t saved_odo = 0;
+static int32_t saved_trip = 0;
+static unsigned long last_save_ms = 0;
+static uint32_t write_count = 0;
+
+static uint32_t slots_per_sector() {
+  return flash->sector_size / sizeof(odo_record_t);
+}
+
+static uint32_t slot_addr(uint16_t sector, uint32_t slot) {
+  return sector * flash->sector_size + slot * sizeof(odo_record_t);
+}
+
+static uint16_t record_crc(const odo_record_t *r) {
+  return calculateChecksum((const uint8_t *)r, offsetof(odo_record_t, crc));
+}
+
+static bool read_record(uint16_t sector, uint32_t slot, odo_record_t *r) {
+  if (!flash->read(slot_addr(sector, slot), r, sizeof(*r))) return false;
+  return r->magic == ODO_RECORD_MAGIC && r->crc == record_crc(r);
+}
+
+static bool slot_erased(uint16_t sector, uint32_t slot) {
+  odo_record_t r;
+  if (!flash->read(slot_addr(sector, slot), &r, sizeof(r))) return false;
+  const uint8_t *p = (const uint8_t *)&r;
+  for (uint8_t i = 0; i < sizeof(r); i++) {
+    if (p[i] != 0xFF) return false;
+  }
+  return true;
+}
+
+// ===== ESP32 partition backend =====
+#ifdef ARDUINO
+static const esp_partition_t *odo_part = NULL;
+
+static bool part_read(uint32_t addr, void *buf, uint32_t len) {
+  return esp_partition_read(odo_part, addr, buf, len) == ESP_OK;
+}
+
+static bool part_write(uint32_t addr, const void *buf, uint32_t len) {
+  return esp_partition_write(odo_part, addr, buf, len) == ESP_OK;
+}
+
+static bool part_erase(uint32_t sector) {
+  return esp_partition_erase_range(odo_part, sector * ODO_SECTOR_SIZE, ODO_SECTOR_SIZE) == ESP_OK;
+}
+
+const odo_flash_t *odometer_partition_flash() {
+  static odo_flash_t part_flash = { part_read, part_write, part_erase, ODO_SECTOR_SIZE, 0 };
+
+  odo_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                      (esp_partition_subtype_t)ODO_PARTITION_SUBTYPE,
+                                      ODO_PARTITION_LABEL);
+  if (!odo_part) return NULL;
+
+  part_flash.sector_count = odo_part->size / part_flash.sector_size;
+  return &part_flash;
+}
+#else
+// Host builds (test/test_odometer) bring their own backend
+const odo_flash_t *odometer_partition_flash() {
+  return NULL;
+}
+#endif
+
+// ===== Log =====
+bool odometer_init(const odo_flash_t *f) {
+  flash = f;
+  have_record = false;
+  if (!flash || flash->sector_count < 2 || slots_per_sector() < 2) {
+    flash = NULL;
+    return false;
+  }
+
+  // Newest sector = highest sequence number in slot 0
+  odo_record_t r;
+  int32_t newest = -1;
+  for (uint16_t s = 0; s < flash->sector_count; s++) {
+    if (read_record(s, 0, &r) && (newest < 0 || r.seq > last_seq)) {
+      newest = s;
+      last_seq = r.seq;
+    }
+  }
+
+  if (newest < 0) {
+    // Empty (or never formatted) store: start over in sector 0 once the
+    // controller reports real values, not the boot placeholders
+    cur_sector = 0;
+    next_slot = 0;
+    last_seq = 0;
+    saved_odo = dashData.odo;
+    saved_trip = dashData.trip;
+    last_save_ms = millis();
+    return false;
+  }
+  cur_sector = newest;
+
+  // Written slots form a prefix of the sector; find its end
+  uint32_t lo = 1, hi = slots_per_sector();
+  while (lo < hi) {
+    uint32_t mid = (lo + hi) / 2;
+    if (slot_erased(cur_sector, mid)) hi = mid;
+    else lo = mid + 1;
+  }
+  next_slot = lo;
+
+  // Step back over torn writes; slot 0 is known to be valid
+  for (uint32_t slot = next_slot; slot-- > 0;) {
+    if (read_record(cur_sector, slot, &r)) break;
+  }
+
+  last_seq = r.seq;
+  have_record = true;
+  saved_odo = dashData.odo = r.odo;
+  saved_trip = dashData.trip = r.trip;
+  last_save_ms = millis();
+
+  Serial.printf("Odometer restored: %d km, trip %d km (seq %u)\n",
+                (int)r.odo, (int)r.trip, (unsigned)r.seq);
+  return true;
+}
+
+static bool append_record(int32_t odo, int32_t trip) {
+  if (!have_record || next_slot >= slots_per_sector()) {
+    // First write ever, or the sector is full: move on to the next (oldest) sector
+    if (have_record) cur_sector = (cur_sector + 1) % flash->sector_count;
+    if (!flash->erase_sector(cur_sector)) return false;
+    next_slot = 0;
+  }
+
+  odo_record_t r;
+  r.seq = have_record ? last_seq + 1 : 0;
+  r.odo = odo;
+  r.trip = trip;
+  r.magic = ODO_RECORD_MAGIC;
+  r.crc = record_crc(&r);
+
+  // The slot is consumed even if the write fails, so it is never programmed twice
+  uint32_t slot = next_slot++;
+  if (!flash->write(slot_addr(cur_sector, slot), &r, sizeof(r))) return false;
+
+  last_seq = r.seq;
+  have_record = true;
+  write_count++;
+  return true;
+}
+
+void odometer_update() {
+  if (!flash) return;
+
+  int32_t odo = dashData.odo;
+  int32_t trip = dashData.trip;
+  if (odo == saved_odo && trip == saved_trip) return;
+
+  bool distance = !have_record || odo - saved_odo >= ODO_SAVE_DISTANCE_KM ||
+                  odo < saved_odo || trip < saved_trip;  // rollback or trip reset
+  bool interval = millis() - last_save_ms >= ODO_SAVE_INTERVAL_MS;
+  if (!distance && !interval) return;
+
+  if (append_record(odo, trip)) {
+    saved_odo = odo;
+    saved_trip = trip;
+  }
+  last_save_ms = millis();
+}
+
+uint32_t odometer_write_count() {
+  return write_count;
+}
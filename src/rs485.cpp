@@ -1,5 +1,12 @@
 #include "rs485.h"
 #include "ui.h"
+#include "telemetry_log.h"
+#include "history.h"
+#include "metrics.h"
+#include "staleness.h"
+#include "alarms.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 uint8_t serialBuffer[332];
 uint16_t bufferPos = 0;
 
@@ -51,9 +58,13 @@ bool validateFrame(uint8_t* frame, uint16_t len) {
 void read_rs485_frames() {
   static uint16_t expectedFrameLength = 0;
   static bool frameStarted = false;
-  
+
+  if (!Serial1.available()) return;  // polled every loop(), keep idle polls out of the trace
+  LV_PROFILER_BEGIN;
+  uint32_t byteCount = 0;
   while (Serial1.available()) {
     uint8_t incomingByte = Serial1.read();
+    byteCount++;
     
     // ===== STATE 1: Looking for STX1 (0x5D) =====
     if (!frameStarted && bufferPos == 0) {
@@ -91,6 +102,7 @@ void read_rs485_frames() {
           // Sanity check
           if (expectedFrameLength > sizeof(serialBuffer) || expectedFrameLength < 15) {
             // Invalid length, reset
+            metrics_add(MET_RS485_RESYNCS, 1);
             bufferPos = 0;
             frameStarted = false;
             expectedFrameLength = 0;
@@ -103,7 +115,12 @@ void read_rs485_frames() {
           
           // Quick validation and process
           if (quickValidateFrame(serialBuffer, expectedFrameLength)) {
+            metrics_add(MET_RS485_FRAMES, 1);
+            uint32_t start = micros();
             processCompleteFrame();
+            metrics_observe_us(MET_H_RS485_FRAME, micros() - start);
+          } else {
+            metrics_add(MET_RS485_BAD_FRAMES, 1);
           }
           
           // Reset for next frame
@@ -113,18 +130,22 @@ void read_rs485_frames() {
         }
         // Safety: exceeded expected length
         else if (expectedFrameLength > 0 && bufferPos > expectedFrameLength) {
+          metrics_add(MET_RS485_RESYNCS, 1);
           bufferPos = 0;
           frameStarted = false;
           expectedFrameLength = 0;
         }
       } else {
         // Buffer overflow
+        metrics_add(MET_RS485_RESYNCS, 1);
         bufferPos = 0;
         frameStarted = false;
         expectedFrameLength = 0;
       }
     }
   }
+  metrics_add(MET_RS485_BYTES, byteCount);
+  LV_PROFILER_END;
 }
 
 /* Fast frame validation - No debug prints */
@@ -155,8 +176,23 @@ bool quickValidateFrame(uint8_t* frame, uint16_t len) {
   return (calculatedCRC == receivedCRC);
 }
 
+// Set in the RS485 task: frames only update dashData and the widgets there, and
+// LVGL's own refresh timer on core 1 renders them
+static bool parse_only = false;
+
+#define MAX_FRAME_UPDATES  20
+
+// Drops IDs past MAX_FRAME_UPDATES: a corrupt frame that still passes the CRC
+// can repeat a field any number of times
+static void note_update(uint8_t *ids, uint8_t &count, uint8_t id) {
+  if (count < MAX_FRAME_UPDATES) ids[count++] = id;
+}
+
 /* Process validated frame - Fast, no prints */
+// Holds lv_lock() while touching dashData and the UI, so it may run from the
+// RS485 task while LVGL renders on the other core.
 void processCompleteFrame() {
+  LV_PROFILER_BEGIN;
   uint16_t declaredLength = (serialBuffer[2] << 8) | serialBuffer[3];
   uint16_t expectedFrameLength = declaredLength + 6;
   uint8_t etxPos = expectedFrameLength - 3;
@@ -167,8 +203,11 @@ void processCompleteFrame() {
   uint8_t dataEnd = etxPos;
   
   // Track which UI elements to update
-  uint8_t updatedIDs[20];
+  uint8_t updatedIDs[MAX_FRAME_UPDATES];
   uint8_t updateCount = 0;
+
+  lv_lock();
+  staleness_frame();
   
   // Parse data fields
   for (uint8_t j = dataStart; j < dataEnd;) {
@@ -180,7 +219,7 @@ void processCompleteFrame() {
       case ID_SOC:
         if (j < dataEnd) {
           dashData.soc = serialBuffer[j++];
-          updatedIDs[updateCount++] = id;
+          note_update(updatedIDs, updateCount, id);
         }
         break;
         
@@ -189,7 +228,7 @@ void processCompleteFrame() {
           uint16_t v = (serialBuffer[j] << 8) | serialBuffer[j + 1];
           dashData.voltage = v * 0.01f;
           j += 2;
-          updatedIDs[updateCount++] = id;
+          note_update(updatedIDs, updateCount, id);
         }
         break;
       
@@ -198,7 +237,7 @@ void processCompleteFrame() {
           uint16_t c = (serialBuffer[j] << 8) | serialBuffer[j + 1];
           dashData.current = (c & 0x8000) ? -(c & 0x7FFF) * 0.01f : c * 0.01f;
           j += 2;
-          updatedIDs[updateCount++] = id;
+          note_update(updatedIDs, updateCount, id);
         }
         break;
       
@@ -207,7 +246,7 @@ void processCompleteFrame() {
           uint16_t t = (serialBuffer[j] << 8) | serialBuffer[j + 1];
           dashData.battery_temp = (int)(t * 0.1f);
           j += 2;
-          updatedIDs[updateCount++] = id;
+          note_update(updatedIDs, updateCount, id);
         }
         break;
       
@@ -216,7 +255,7 @@ void processCompleteFrame() {
           uint16_t s = (serialBuffer[j] << 8) | serialBuffer[j + 1];
           dashData.speed = (int)(s * 0.1f);
           j += 2;
-          updatedIDs[updateCount++] = id;
+          note_update(updatedIDs, updateCount, id);
         }
         break;
       
@@ -226,7 +265,7 @@ void processCompleteFrame() {
           if (m == MODE_ECO) dashData.mode = "Eco";
           else if (m == MODE_CITY) dashData.mode = "City";
           else if (m == MODE_SPORT) dashData.mode = "Sport";
-          updatedIDs[updateCount++] = id;
+          note_update(updatedIDs, updateCount, id);
         }
         break;
       
@@ -234,7 +273,7 @@ void processCompleteFrame() {
         if (j < dataEnd) {
           uint8_t a = serialBuffer[j++];
           dashData.status = a ? "ARMED" : "DISARMED";
-          updatedIDs[updateCount++] = id;
+          note_update(updatedIDs, updateCount, id);
         }
         break;
       
@@ -243,7 +282,7 @@ void processCompleteFrame() {
           uint16_t r = (serialBuffer[j] << 8) | serialBuffer[j + 1];
           dashData.range = (int)(r * 0.1f);
           j += 2;
-          updatedIDs[updateCount++] = id;
+          note_update(updatedIDs, updateCount, id);
         }
         break;
       
@@ -252,7 +291,7 @@ void processCompleteFrame() {
           uint16_t c = (serialBuffer[j] << 8) | serialBuffer[j + 1];
           dashData.avg_wkm = (int)(c * 0.1f);
           j += 2;
-          updatedIDs[updateCount++] = id;
+          note_update(updatedIDs, updateCount, id);
         }
         break;
       
@@ -261,7 +300,7 @@ void processCompleteFrame() {
           uint16_t t = (serialBuffer[j] << 8) | serialBuffer[j + 1];
           dashData.motor_temp = (int)(t * 0.1f);
           j += 2;
-          updatedIDs[updateCount++] = id;
+          note_update(updatedIDs, updateCount, id);
         }
         break;
       
@@ -270,7 +309,7 @@ void processCompleteFrame() {
           uint16_t t = (serialBuffer[j] << 8) | serialBuffer[j + 1];
           dashData.trip = (int)(t * 0.1f);
           j += 2;
-          updatedIDs[updateCount++] = id;
+          note_update(updatedIDs, updateCount, id);
         }
         break;
       
@@ -280,7 +319,7 @@ void processCompleteFrame() {
                       (serialBuffer[j + 2] << 8) | serialBuffer[j + 3];
           dashData.odo = (int)(o * 0.1f);
           j += 4;
-          updatedIDs[updateCount++] = id;
+          note_update(updatedIDs, updateCount, id);
         }
         break;
       
@@ -289,15 +328,36 @@ void processCompleteFrame() {
           uint16_t as = (serialBuffer[j] << 8) | serialBuffer[j + 1];
           dashData.avg_kmh = (int)(as * 0.1f);
           j += 2;
-          updatedIDs[updateCount++] = id;
+          note_update(updatedIDs, updateCount, id);
+        }
+        break;
+
+      case ID_LATITUDE:
+      case ID_LONGITUDE:
+        if (j + 3 < dataEnd) {
+          int32_t deg = (int32_t)(((uint32_t)serialBuffer[j] << 24) | (serialBuffer[j + 1] << 16) |
+                                  (serialBuffer[j + 2] << 8) | serialBuffer[j + 3]);
+          if (id == ID_LATITUDE) dashData.latitude = deg;
+          else dashData.longitude = deg;
+          j += 4;
+          note_update(updatedIDs, updateCount, id);
+        }
+        break;
+
+      case ID_HEADING:
+        if (j + 1 < dataEnd) {
+          uint16_t h = (serialBuffer[j] << 8) | serialBuffer[j + 1];
+          dashData.heading = (int)(h * 0.1f) % 360;
+          j += 2;
+          note_update(updatedIDs, updateCount, id);
         }
         break;
 
       default:
-        // Unknown ID - skip safely
-        if (id == ID_ODOMETER) {
+        // Unknown ID - skip by its block's length (shared.h)
+        if (id >= 0x90 && id <= 0x97) {
           j += 4;
-        } else if (id >= 0x80 && id <= 0x8F) {
+        } else if (id >= 0x80 && id <= 0x9F) {
           j += 2;
         } else {
           j++;
@@ -306,11 +366,45 @@ void processCompleteFrame() {
     }
   }
   
+  // Alarms first: a critical one is drawn before the rest of the frame. In the RS485
+  // task (parse_only) this task can't render, so it only makes the refresh due: the
+  // badge is then drawn together with the rest of the frame once the lock is
+  // released, rather than at the end of the refresh period.
+  if (alarms_frame(updatedIDs, updateCount)) {
+    if (parse_only) lv_timer_ready(lv_display_get_refr_timer(disp));
+    else lv_refr_now(disp);
+  }
+
   // Update only changed UI elements
   for (uint8_t k = 0; k < updateCount; k++) {
     update_ui_element(updatedIDs[k]);
+    staleness_touch(updatedIDs[k]);
+    telemetry_log_field(updatedIDs[k]);
+    history_record(updatedIDs[k]);
   }
   
   // Single display refresh
-  lv_refr_now(disp);
-}
\ No newline at end of file
+  if (!parse_only) lv_refr_now(disp);
+  lv_unlock();
+  LV_PROFILER_END;
+}
+
+#if LV_USE_OS != LV_OS_NONE
+static void rs485_task(void *arg) {
+  parse_only = true;
+  for (;;) {
+    read_rs485_frames();
+    metrics_set(MET_RS485_STACK_FREE, uxTaskGetStackHighWaterMark(NULL));
+    vTaskDelay(pdMS_TO_TICKS(2));
+  }
+}
+
+bool rs485_start_task() {
+  // Core 0: loop() and LVGL's timer handler run on core 1
+  return xTaskCreatePinnedToCore(rs485_task, "rs485", RS485_TASK_STACK, NULL, 2, NULL, 0) == pdPASS;
+}
+#else
+bool rs485_start_task() {
+  return false;  // single-threaded build: loop() polls read_rs485_frames()
+}
+#endif
\ No newline at end of file
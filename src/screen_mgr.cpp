@@ -0,0 +1,257 @@
+#include "screen_mgr.h"
+#include "metrics.h"
+
+typedef struct {
+  const screen_desc_t *desc;
+  lv_obj_t *scr;              // NULL while not built
+  uint32_t lv_cost;           // measured by the last build (hint before)
+  uint32_t sys_cost;
+  uint32_t last_shown;        // lv_tick_get(), for the LRU choice
+} screen_t;
+
+static screen_t screens[SCREEN_COUNT];
+static screen_id_t active = SCREEN_COUNT;
+static screen_id_t back_stack[SCREEN_MGR_BACK_DEPTH];
+static uint8_t back_len;
+// Switches seen from each screen to each other one; a row is halved when a count saturates
+static uint8_t switches[SCREEN_COUNT][SCREEN_COUNT];
+
+// Free LVGL heap. TLSF counts the whole slab region as used, so add its free slots and pages.
+static uint32_t lv_heap_free_bytes(void) {
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  uint32_t free = mon.free_size;
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN && LV_MEM_SLAB_SIZE
+  lv_mem_slab_stats_t slab;
+  lv_mem_slab_get_stats(&slab);
+  free += slab.free_size + (slab.page_cnt - slab.page_used) * LV_MEM_SLAB_PAGE_SIZE;
+#endif
+  return free;
+}
+
+static uint8_t resident_count(void) {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < SCREEN_COUNT; i++) {
+    if (screens[i].scr) n++;
+  }
+  return n;
+}
+
+static void screen_deleted_cb(lv_event_t *e) {
+  screen_t *s = (screen_t *)lv_event_get_user_data(e);
+  s->scr = NULL;
+  metrics_set(MET_SCREENS_RESIDENT, resident_count());
+}
+
+// Delete the least recently shown screen that may go. `keep` is the one being built.
+static bool evict_lru(screen_id_t keep) {
+  screen_t *lru = NULL;
+  for (uint8_t i = 0; i < SCREEN_COUNT; i++) {
+    screen_t *s = &screens[i];
+    if (!s->scr || s->desc->pinned || i == active || i == keep) continue;
+    if (!lru || (int32_t)(s->last_shown - lru->last_shown) < 0) lru = s;
+  }
+  if (!lru) return false;
+
+  lv_obj_delete(lru->scr);   // screen_deleted_cb() clears lru->scr
+  metrics_add(MET_SCREEN_EVICTIONS, 1);
+  return true;
+}
+
+static bool fits(const screen_t *s) {
+  return resident_count() < SCREEN_MGR_MAX_RESIDENT &&
+         lv_heap_free_bytes() >= s->lv_cost + SCREEN_MGR_LV_RESERVE &&
+         ESP.getFreeHeap() >= s->sys_cost + SCREEN_MGR_SYS_RESERVE;
+}
+
+// Make room by evicting (if allowed), then build. The cost is measured as the drop
+// in free heap, which other allocations during the build may blur a little.
+static bool build(screen_id_t id, bool may_evict) {
+  screen_t *s = &screens[id];
+  while (!fits(s)) {
+    if (!may_evict || !evict_lru(id)) {
+      // Nothing left to delete: still try if the screen itself fits without the reserves
+      if (!may_evict || lv_heap_free_bytes() < s->lv_cost || ESP.getFreeHeap() < s->sys_cost) return false;
+      break;
+    }
+  }
+
+  uint32_t lv_before = lv_heap_free_bytes();
+  uint32_t sys_before = ESP.getFreeHeap();
+  uint32_t start = micros();
+  s->scr = s->desc->build();
+  metrics_observe_us(MET_H_SCREEN_BUILD, micros() - start);
+  if (!s->scr) return false;
+
+  uint32_t lv_after = lv_heap_free_bytes();
+  uint32_t sys_after = ESP.getFreeHeap();
+  s->lv_cost = lv_before > lv_after ? lv_before - lv_after : 0;
+  s->sys_cost = sys_before > sys_after ? sys_before - sys_after : 0;
+  lv_obj_add_event_cb(s->scr, screen_deleted_cb, LV_EVENT_DELETE, s);
+  metrics_add(MET_SCREEN_BUILDS, 1);
+  metrics_set(MET_SCREENS_RESIDENT, resident_count());
+  return true;
+}
+
+static void count_switch(screen_id_t from, screen_id_t to) {
+  if (from == SCREEN_COUNT) return;
+  uint8_t *row = switches[from];
+  if (row[to] == UINT8_MAX) {
+    for (uint8_t i = 0; i < SCREEN_COUNT; i++) row[i] /= 2;
+  }
+  row[to]++;
+}
+
+static screen_id_t likely_next(screen_id_t from) {
+  screen_id_t best = screens[from].desc->likely_next;
+  uint8_t best_n = 0;
+  for (uint8_t i = 0; i < SCREEN_COUNT; i++) {
+    if (switches[from][i] > best_n) {
+      best_n = switches[from][i];
+      best = (screen_id_t)i;
+    }
+  }
+  return best;
+}
+
+// Load a built screen without touching the back stack
+static void load(screen_id_t id) {
+  screen_t *s = &screens[id];
+  screen_id_t prev = active;
+  if (s->desc->on_show) s->desc->on_show(s->scr);
+  lv_screen_load(s->scr);
+  s->last_shown = lv_tick_get();
+  active = id;
+  count_switch(prev, id);
+  if (prev != SCREEN_COUNT && prev != id && screens[prev].desc->on_hide) {
+    screens[prev].desc->on_hide(screens[prev].scr);
+  }
+}
+
+static bool show(screen_id_t id) {
+  screen_t *s = &screens[id];
+  if (!s->desc) return false;
+  if (id == active) return true;
+
+  uint32_t start = micros();
+  if (!s->scr && !build(id, true)) {
+    LV_LOG_WARN("no memory for screen %s", s->desc->name);
+    return false;
+  }
+  load(id);
+  metrics_observe_us(MET_H_SCREEN_SHOW, micros() - start);
+  return true;
+}
+
+static void poll_cb(lv_timer_t *t) {
+  // Something else grew (texts, draw tasks): give the heap back
+  while (lv_heap_free_bytes() < SCREEN_MGR_LV_RESERVE && evict_lru(SCREEN_COUNT)) {
+  }
+
+  if (active == SCREEN_COUNT || lv_display_get_inactive_time(NULL) < SCREEN_MGR_IDLE_MS) return;
+  screen_id_t next = likely_next(active);
+  if (next != SCREEN_COUNT && !screens[next].scr) screen_mgr_preload(next);
+}
+
+// ===== API =====
+void screen_mgr_register(screen_id_t id, const screen_desc_t *desc) {
+  screen_t *s = &screens[id];
+  s->desc = desc;
+  s->lv_cost = desc->lv_cost_hint;
+  s->sys_cost = desc->sys_cost_hint;
+}
+
+void screen_mgr_begin(void) {
+  lv_timer_create(poll_cb, SCREEN_MGR_POLL_MS, NULL);
+}
+
+bool screen_mgr_show(screen_id_t id) {
+  screen_id_t prev = active;
+  if (!show(id)) return false;
+  if (prev == SCREEN_COUNT || prev == id) return true;
+
+  if (back_len == SCREEN_MGR_BACK_DEPTH) {
+    memmove(back_stack, back_stack + 1, (SCREEN_MGR_BACK_DEPTH - 1) * sizeof(back_stack[0]));
+    back_len--;
+  }
+  back_stack[back_len++] = prev;
+  return true;
+}
+
+void screen_mgr_back(void) {
+  while (back_len > 0) {
+    if (show(back_stack[--back_len])) return;
+  }
+  show(SCREEN_DASHBOARD);
+}
+
+bool screen_mgr_preload(screen_id_t id) {
+  screen_t *s = &screens[id];
+  if (!s->desc) return false;
+  if (s->scr) return true;
+  if (!build(id, false)) return false;
+  s->last_shown = lv_tick_get();
+  metrics_add(MET_SCREEN_PRELOADS, 1);
+  return true;
+}
+
+void screen_mgr_drop(screen_id_t id) {
+  if (id == active || !screens[id].scr) return;
+  lv_obj_delete(screens[id].scr);
+}
+
+lv_obj_t *screen_mgr_get(screen_id_t id) {
+  return screens[id].scr;
+}
+
+screen_id_t screen_mgr_active(void) {
+  return active;
+}
+
+static void back_cb(lv_event_t *e) {
+  screen_mgr_back();
+}
+
+lv_obj_t *screen_mgr_top_bar(lv_obj_t *scr, const char *title) {
+  lv_obj_t *top_bar = lv_obj_create(scr);
+  lv_obj_set_size(top_bar, lv_pct(100), 55);
+  lv_obj_align(top_bar, LV_ALIGN_TOP_MID, 0, 0);
+  lv_obj_set_style_bg_color(top_bar, lv_color_white(), 0);
+  lv_obj_set_style_border_width(top_bar, 0, 0);
+  lv_obj_set_style_radius(top_bar, 0, 0);
+  lv_obj_set_style_pad_all(top_bar, 0, 0);
+
+  lv_obj_t *back_btn = lv_btn_create(top_bar);
+  lv_obj_set_size(back_btn, 50, 45);
+  lv_obj_align(back_btn, LV_ALIGN_LEFT_MID, 0, 0);
+  lv_obj_set_style_bg_color(back_btn, lv_color_hex(0x333333), 0);
+  lv_obj_add_event_cb(back_btn, back_cb, LV_EVENT_CLICKED, NULL);
+
+  lv_obj_t *back_label = lv_label_create(back_btn);
+  lv_label_set_text(back_label, LV_SYMBOL_LEFT);
+  lv_obj_set_style_text_font(back_label, &lv_font_montserrat_20, 0);
+  lv_obj_center(back_label);
+
+  lv_obj_t *title_label = lv_label_create(top_bar);
+  lv_label_set_text(title_label, title);
+  lv_obj_set_style_text_color(title_label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(title_label, &lv_font_montserrat_18, 0);
+  lv_obj_align(title_label, LV_ALIGN_CENTER, 0, 0);
+  return top_bar;
+}
+
+void screen_mgr_dump(void) {
+  uint32_t now = lv_tick_get();
+  for (uint8_t i = 0; i < SCREEN_COUNT; i++) {
+    const screen_t *s = &screens[i];
+    if (!s->desc) continue;
+    Serial.printf("%-10s %-8s lv %5lu B sys %6lu B shown %lus ago%s\n", s->desc->name,
+                  s->scr ? (i == active ? "active" : "built") : "-",
+                  (unsigned long)s->lv_cost, (unsigned long)s->sys_cost,
+                  (unsigned long)((now - s->last_shown) / 1000),
+                  s->desc->pinned ? " pinned" : "");
+  }
+  Serial.printf("lv heap free %lu B, sys heap free %lu B (largest block %lu B)\n",
+                (unsigned long)lv_heap_free_bytes(), (unsigned long)ESP.getFreeHeap(),
+                (unsigned long)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+}
@@ -0,0 +1,109 @@
+#include "settings_screen.h"
+#include "staleness.h"
+
+ui_settings_t ui_settings = {
+  10 * 60 * 1000UL,
+  TREND_CHART_SCROLL,
+  STALE_FAST_MS,
+};
+
+// Each setting is a row of checkable buttons in one button matrix
+typedef struct {
+  const char *title;
+  const char *const *map;
+  uint8_t (*get)(void);         // index of the current value, or the count if none matches
+  void (*set)(uint8_t index);
+} choice_t;
+
+static const uint32_t spans_ms[] = { 10 * 60 * 1000UL, 60 * 60 * 1000UL, 4 * 60 * 60 * 1000UL };
+static const char *const span_map[] = { "10 min", "1 h", "4 h", "" };
+
+static const char *const mode_map[] = { "Scroll", "Sweep", "" };
+
+// The bus-silence deadline follows the shortest of these (staleness.h)
+static const uint32_t stale_ms[] = { 500, 1000, 2000 };
+static const char *const stale_map[] = { "0.5 s", "1 s", "2 s", "" };
+
+static uint8_t index_of(const uint32_t *values, uint8_t count, uint32_t v) {
+  uint8_t i = 0;
+  while (i < count && values[i] != v) i++;
+  return i;
+}
+
+static uint8_t get_span(void) {
+  return index_of(spans_ms, 3, ui_settings.trend_span_ms);
+}
+
+static void set_span(uint8_t i) {
+  ui_settings.trend_span_ms = spans_ms[i];
+}
+
+static uint8_t get_mode(void) {
+  return ui_settings.trend_mode;
+}
+
+static void set_mode(uint8_t i) {
+  if (ui_settings.trend_mode == (trend_chart_mode_t)i) return;
+  ui_settings.trend_mode = (trend_chart_mode_t)i;
+  screen_mgr_drop(SCREEN_TRENDS);   // the chart is created in its mode
+}
+
+static uint8_t get_stale(void) {
+  return index_of(stale_ms, 3, ui_settings.stale_fast_ms);
+}
+
+static void set_stale(uint8_t i) {
+  ui_settings.stale_fast_ms = stale_ms[i];
+  staleness_set_period(ID_SPEED, stale_ms[i]);
+  staleness_set_period(ID_VOLTAGE, stale_ms[i]);
+  staleness_set_period(ID_CURRENT, stale_ms[i]);
+}
+
+static const choice_t choices[] = {
+  { "Trend span", span_map, get_span, set_span },
+  { "Trend drawing", mode_map, get_mode, set_mode },
+  { "Speed, V, A stale after", stale_map, get_stale, set_stale },
+};
+
+static void changed_cb(lv_event_t *e) {
+  lv_obj_t *btnm = lv_event_get_target_obj(e);
+  const choice_t *c = (const choice_t *)lv_event_get_user_data(e);
+  uint32_t i = lv_buttonmatrix_get_selected_button(btnm);
+  if (i != LV_BUTTONMATRIX_BUTTON_NONE) c->set(i);
+}
+
+static lv_obj_t *build(void) {
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(scr, lv_color_hex(0xe5e5e5), 0);
+
+  screen_mgr_top_bar(scr, "Settings");
+
+  int32_t y = 70;
+  for (uint8_t n = 0; n < sizeof(choices) / sizeof(choices[0]); n++, y += 80) {
+    const choice_t *c = &choices[n];
+
+    lv_obj_t *title = lv_label_create(scr);
+    lv_label_set_text(title, c->title);
+    lv_obj_set_style_text_color(title, lv_color_black(), 0);
+    lv_obj_set_style_text_font(title, &lv_font_montserrat_16, 0);
+    lv_obj_set_pos(title, 20, y);
+
+    lv_obj_t *btnm = lv_buttonmatrix_create(scr);
+    lv_buttonmatrix_set_map(btnm, c->map);
+    lv_buttonmatrix_set_button_ctrl_all(btnm, LV_BUTTONMATRIX_CTRL_CHECKABLE);
+    lv_buttonmatrix_set_one_checked(btnm, true);
+    lv_buttonmatrix_set_button_ctrl(btnm, c->get(), LV_BUTTONMATRIX_CTRL_CHECKED);
+    lv_obj_set_size(btnm, 440, 50);
+    lv_obj_set_pos(btnm, 20, y + 22);
+    lv_obj_set_style_pad_all(btnm, 4, 0);
+    lv_obj_set_style_text_font(btnm, &lv_font_montserrat_16, 0);
+    lv_obj_add_event_cb(btnm, changed_cb, LV_EVENT_VALUE_CHANGED, (void *)c);
+  }
+  return scr;
+}
+
+const screen_desc_t settings_screen_desc = {
+  "settings", build, NULL, NULL,
+  4 * 1024, 0,
+  SCREEN_TRENDS, false,
+};
@@ -0,0 +1,184 @@
+#include "staleness.h"
+#include "ui.h"
+#include "metrics.h"
+
+// Field IDs are 0x80..ID_HEADING, so a field's node is its ID - FIELD_FIRST (IDs
+// nobody sends keep a zero period and are never armed); the node after the fields
+// is the bus. Nodes are linked into the slot of their deadline
+// (in ticks, modulo the wheel size) and unlinked when re-armed or expired. The bus
+// node's period follows the shortest field period.
+
+#define FIELD_FIRST  ID_TEMP
+#define FIELD_CNT    (ID_HEADING - FIELD_FIRST + 1)
+#define BUS_NODE     FIELD_CNT
+#define NODE_CNT     (FIELD_CNT + 1)
+#define NONE         0xFF
+#define MAX_PERIOD_MS ((uint32_t)STALE_TICK_MS * (STALE_WHEEL_SLOTS - 2))
+
+static_assert(STALE_FAST_MS <= MAX_PERIOD_MS && STALE_SLOW_MS <= MAX_PERIOD_MS &&
+              STALE_BUS_MS <= MAX_PERIOD_MS, "a staleness period is longer than the wheel");
+static_assert(STALE_WHEEL_SLOTS < 256 && NODE_CNT < NONE, "the wheel links are uint8_t");
+
+typedef struct {
+  uint32_t deadline;    // tick at which the node expires
+  uint32_t period_ms;   // 0: not a tracked field
+  uint8_t next;
+  uint8_t prev;
+  bool armed;           // linked into the wheel
+  bool stale;
+} stale_node_t;
+
+static const struct {
+  uint8_t id;
+  uint32_t period_ms;
+} default_periods[] = {
+  { ID_SPEED,        STALE_FAST_MS },
+  { ID_VOLTAGE,      STALE_FAST_MS },
+  { ID_CURRENT,      STALE_FAST_MS },
+  { ID_TEMP,         STALE_SLOW_MS },
+  { ID_SOC,          STALE_SLOW_MS },
+  { ID_MODE,         STALE_SLOW_MS },
+  { ID_ARMED,        STALE_SLOW_MS },
+  { ID_RANGE,        STALE_SLOW_MS },
+  { ID_CONSUMPTION,  STALE_SLOW_MS },
+  { ID_AMBIENT_TEMP, STALE_SLOW_MS },
+  { ID_TRIP,         STALE_SLOW_MS },
+  { ID_ODOMETER,     STALE_SLOW_MS },
+  { ID_AVG_SPEED,    STALE_SLOW_MS },
+  { ID_LATITUDE,     STALE_SLOW_MS },
+  { ID_LONGITUDE,    STALE_SLOW_MS },
+  { ID_HEADING,      STALE_SLOW_MS },
+};
+
+static stale_node_t nodes[NODE_CNT];
+static uint8_t slots[STALE_WHEEL_SLOTS];
+static uint32_t cur_tick;            // last tick whose slot was visited
+static uint32_t stale_cnt;
+static lv_timer_t *timer = NULL;
+
+static int node_of(uint8_t id) {
+  if (id < FIELD_FIRST || id >= FIELD_FIRST + FIELD_CNT) return -1;
+  if (nodes[id - FIELD_FIRST].period_ms == 0) return -1;
+  return id - FIELD_FIRST;
+}
+
+// ===== Wheel =====
+static void unlink(uint8_t i) {
+  stale_node_t *n = &nodes[i];
+  if (!n->armed) return;
+  if (n->prev != NONE) nodes[n->prev].next = n->next;
+  else slots[n->deadline % STALE_WHEEL_SLOTS] = n->next;
+  if (n->next != NONE) nodes[n->next].prev = n->prev;
+  n->armed = false;
+}
+
+// Expire between one period and one period + one tick from now
+static void arm(uint8_t i) {
+  stale_node_t *n = &nodes[i];
+  unlink(i);
+  n->deadline = millis() / STALE_TICK_MS + (n->period_ms + STALE_TICK_MS - 1) / STALE_TICK_MS + 1;
+
+  uint8_t *head = &slots[n->deadline % STALE_WHEEL_SLOTS];
+  n->prev = NONE;
+  n->next = *head;
+  if (*head != NONE) nodes[*head].prev = i;
+  *head = i;
+  n->armed = true;
+}
+
+// Bus silence only after the fastest field has missed its own period
+static void update_bus_period(void) {
+  uint32_t shortest = MAX_PERIOD_MS;
+  for (uint8_t f = 0; f < FIELD_CNT; f++) {
+    if (nodes[f].period_ms) shortest = LV_MIN(shortest, nodes[f].period_ms);
+  }
+  nodes[BUS_NODE].period_ms = LV_MAX(shortest, (uint32_t)STALE_BUS_MS);
+}
+
+static void set_stale(uint8_t i, bool stale) {
+  if (nodes[i].stale == stale) return;
+  nodes[i].stale = stale;
+  stale_cnt += stale ? 1 : -1;
+  metrics_set(MET_STALE_FIELDS, stale_cnt);
+  ui_set_stale(FIELD_FIRST + i, stale);
+}
+
+static void expire(uint8_t i) {
+  unlink(i);
+  if (i != BUS_NODE) {
+    set_stale(i, true);
+    return;
+  }
+
+  // Bus silence: don't wait for the slower fields' own deadlines
+  metrics_add(MET_RS485_SILENCES, 1);
+  for (uint8_t f = 0; f < FIELD_CNT; f++) {
+    if (!nodes[f].armed) continue;
+    unlink(f);
+    set_stale(f, true);
+  }
+}
+
+static void timer_cb(lv_timer_t *t) {
+  uint32_t now_tick = millis() / STALE_TICK_MS;
+
+  // After a long stall every slot is due once
+  if (now_tick - cur_tick > STALE_WHEEL_SLOTS) cur_tick = now_tick - STALE_WHEEL_SLOTS;
+
+  while (cur_tick != now_tick) {
+    cur_tick++;
+    uint8_t *head = &slots[cur_tick % STALE_WHEEL_SLOTS];
+    uint8_t i = *head;
+    while (i != NONE) {
+      uint8_t next = nodes[i].next;
+      // A node can be a full turn ahead when it was armed during a stall
+      if ((int32_t)(nodes[i].deadline - cur_tick) <= 0) {
+        expire(i);
+        if (i == BUS_NODE) next = *head;  // the fields were unlinked
+      }
+      i = next;
+    }
+  }
+}
+
+// ===== API =====
+void staleness_begin(void) {
+  memset(slots, NONE, sizeof(slots));
+  memset(nodes, 0, sizeof(nodes));
+  for (size_t k = 0; k < sizeof(default_periods) / sizeof(default_periods[0]); k++) {
+    nodes[default_periods[k].id - FIELD_FIRST].period_ms = default_periods[k].period_ms;
+  }
+  update_bus_period();
+  stale_cnt = 0;
+  cur_tick = millis() / STALE_TICK_MS;
+
+  // Values shown before the first frame are placeholders: let them go stale too
+  for (uint8_t i = 0; i < NODE_CNT; i++) {
+    if (nodes[i].period_ms) arm(i);
+  }
+  if (!timer) timer = lv_timer_create(timer_cb, STALE_TICK_MS, NULL);
+}
+
+void staleness_frame(void) {
+  if (!timer) return;
+  arm(BUS_NODE);
+}
+
+void staleness_touch(uint8_t id) {
+  int i = node_of(id);
+  if (i < 0 || !timer) return;
+  arm(i);
+  set_stale(i, false);
+}
+
+bool staleness_is_stale(uint8_t id) {
+  int i = node_of(id);
+  return i >= 0 && nodes[i].stale;
+}
+
+void staleness_set_period(uint8_t id, uint32_t period_ms) {
+  int i = node_of(id);
+  if (i < 0) return;
+  nodes[i].period_ms = LV_CLAMP(STALE_TICK_MS, period_ms, MAX_PERIOD_MS);
+  update_bus_period();
+}
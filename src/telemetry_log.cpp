@@ -0,0 +1,222 @@
+#include "telemetry_log.h"
+#include "metrics.h"
+#include <SD.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+
+// Samples are appended per signal as (dt, dv) varints into a small column
+// buffer. A full column is closed into a block and copied into the active
+// write buffer; a full write buffer is handed to a low-priority task on core 0
+// which does the (slow) SD write while loop() keeps filling the other buffer.
+
+#define TLOG_SIGNALS       (sizeof(signal_ids) / sizeof(signal_ids[0]))
+#define TLOG_BLOCK_HEADER  12
+#define TLOG_VARINT_MAX    5                       // bytes for a 32-bit varint
+
+typedef struct {
+  uint8_t payload[TLOG_COLUMN_BYTES];
+  uint16_t len;
+  uint8_t count;      // 0 = no open block
+  uint32_t t0;
+  int32_t v0;
+  uint32_t t_prev;
+  int32_t v_prev;
+} tlog_column_t;
+
+// Logged IDs, in column order
+static const uint8_t signal_ids[] = {
+  ID_TEMP, ID_SPEED, ID_VOLTAGE, ID_CURRENT, ID_SOC, ID_MODE, ID_ARMED,
+  ID_RANGE, ID_CONSUMPTION, ID_AMBIENT_TEMP, ID_TRIP, ID_ODOMETER, ID_AVG_SPEED,
+  ID_LATITUDE, ID_LONGITUDE, ID_HEADING
+};
+
+static tlog_column_t columns[TLOG_SIGNALS];
+
+static uint8_t write_buf[2][TLOG_WRITE_BUF_BYTES];
+static volatile uint16_t write_len[2];  // filled by loop() while active, cleared by the writer once written
+static volatile bool write_busy[2];     // owned by the writer task while set
+static uint8_t active = 0;
+
+static File log_file;
+static QueueHandle_t write_queue = NULL;
+static unsigned long last_flush = 0;
+static uint32_t dropped = 0;
+static volatile uint32_t write_errors = 0;
+
+// ===== Writer task =====
+static void writer_task(void *arg) {
+  uint8_t idx;
+  for (;;) {
+    if (xQueueReceive(write_queue, &idx, portMAX_DELAY) != pdTRUE) continue;
+    uint16_t len = write_len[idx];
+    if (log_file.write(write_buf[idx], len) != len) {
+      // Card full or gone: the buffer is lost, but loop() must not stall on it
+      write_errors++;
+      metrics_add(MET_TLOG_WRITE_ERRORS, 1);
+    }
+    log_file.flush();
+    write_len[idx] = 0;
+    write_busy[idx] = false;
+  }
+}
+
+// Hand the active buffer to the writer and switch to the other one. Fails while
+// the other one is still being written, so the active buffer is never busy.
+static bool submit_active() {
+  if (write_len[active] == 0) return true;
+  if (write_busy[active ^ 1]) return false;
+  write_busy[active] = true;
+  xQueueSend(write_queue, &active, 0);  // queue holds both indices, never full
+  active ^= 1;
+  return true;
+}
+
+// ===== Encoding =====
+static uint16_t put_varint(uint8_t *p, uint32_t v) {
+  uint16_t n = 0;
+  while (v >= 0x80) {
+    p[n++] = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  p[n++] = (uint8_t)v;
+  return n;
+}
+
+static void put_le(uint8_t *p, uint32_t v, uint8_t bytes) {
+  for (uint8_t i = 0; i < bytes; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void close_column(uint8_t sig) {
+  tlog_column_t *col = &columns[sig];
+  if (col->count == 0) return;
+
+  uint16_t need = TLOG_BLOCK_HEADER + col->len;
+  if (write_len[active] + need > TLOG_WRITE_BUF_BYTES && !submit_active()) {
+    dropped++;  // the card is too slow; never wait for it here
+    metrics_add(MET_TLOG_DROPPED, 1);
+  } else {
+    uint8_t *p = &write_buf[active][write_len[active]];
+    p[0] = signal_ids[sig];
+    p[1] = col->count;
+    put_le(&p[2], col->len, 2);
+    put_le(&p[4], col->t0, 4);
+    put_le(&p[8], (uint32_t)col->v0, 4);
+    memcpy(&p[TLOG_BLOCK_HEADER], col->payload, col->len);
+    write_len[active] += need;
+  }
+
+  col->count = 0;
+  col->len = 0;
+}
+
+static int32_t field_value(uint8_t id) {
+  switch (id) {
+    case ID_SOC:          return dashData.soc;
+    case ID_VOLTAGE:      return (int32_t)lroundf(dashData.voltage * 100.0f);
+    case ID_CURRENT:      return (int32_t)lroundf(dashData.current * 100.0f);
+    case ID_TEMP:         return dashData.battery_temp;
+    case ID_SPEED:        return dashData.speed;
+    case ID_MODE:
+      if (dashData.mode == "Eco") return MODE_ECO;
+      if (dashData.mode == "City") return MODE_CITY;
+      return MODE_SPORT;
+    case ID_ARMED:        return dashData.status == "ARMED";
+    case ID_RANGE:        return dashData.range;
+    case ID_CONSUMPTION:  return dashData.avg_wkm;
+    case ID_AMBIENT_TEMP: return dashData.motor_temp;
+    case ID_TRIP:         return dashData.trip;
+    case ID_ODOMETER:     return dashData.odo;
+    case ID_AVG_SPEED:    return dashData.avg_kmh;
+    case ID_LATITUDE:     return dashData.latitude;
+    case ID_LONGITUDE:    return dashData.longitude;
+    case ID_HEADING:      return dashData.heading;
+  }
+  return 0;
+}
+
+static int signal_of(uint8_t id) {
+  for (uint8_t sig = 0; sig < TLOG_SIGNALS; sig++) {
+    if (signal_ids[sig] == id) return sig;
+  }
+  return -1;
+}
+
+void telemetry_log_field(uint8_t id) {
+  int s = write_queue ? signal_of(id) : -1;
+  if (s < 0) return;
+
+  uint8_t sig = (uint8_t)s;
+  tlog_column_t *col = &columns[sig];
+  uint32_t t = millis();
+  int32_t v = field_value(id);
+
+  if (col->count == 255 || col->len + 2 * TLOG_VARINT_MAX > TLOG_COLUMN_BYTES) {
+    close_column(sig);
+  }
+
+  if (col->count == 0) {
+    col->t0 = t;
+    col->v0 = v;
+  } else {
+    int32_t dv = v - col->v_prev;
+    uint32_t zz = ((uint32_t)dv << 1) ^ (uint32_t)(dv >> 31);
+    col->len += put_varint(&col->payload[col->len], t - col->t_prev);
+    col->len += put_varint(&col->payload[col->len], zz);
+  }
+  col->count++;
+  col->t_prev = t;
+  col->v_prev = v;
+}
+
+void telemetry_log_poll() {
+  if (!write_queue || millis() - last_flush < TLOG_FLUSH_INTERVAL_MS) return;
+  last_flush = millis();
+
+  for (uint8_t sig = 0; sig < TLOG_SIGNALS; sig++) close_column(sig);
+  submit_active();  // if the writer is still busy, the next poll retries
+}
+
+uint32_t telemetry_log_dropped() {
+  return dropped;
+}
+
+uint32_t telemetry_log_write_errors() {
+  return write_errors;
+}
+
+bool telemetry_log_begin() {
+  if (!SD.exists(TLOG_DIR)) SD.mkdir(TLOG_DIR);
+
+  // One file per boot: /telemetry/T0000.evt, T0001.evt, ...
+  char path[32];
+  for (uint16_t n = 0; n < 10000; n++) {
+    snprintf(path, sizeof(path), TLOG_DIR "/T%04u.evt", n);
+    if (!SD.exists(path)) break;
+  }
+
+  log_file = SD.open(path, FILE_WRITE);
+  if (!log_file) {
+    Serial.println("ERROR: Failed to create telemetry log!");
+    return false;
+  }
+
+  uint8_t header[8] = { 0, 0, 0, 0, TLOG_VERSION, 0, 0, 0 };
+  memcpy(header, TLOG_MAGIC, 4);
+  log_file.write(header, sizeof(header));
+  log_file.flush();
+
+  write_queue = xQueueCreate(2, sizeof(uint8_t));
+  if (!write_queue ||
+      xTaskCreatePinnedToCore(writer_task, "tlog", 4096, NULL, tskIDLE_PRIORITY + 1,
+                              NULL, 0) != pdPASS) {
+    Serial.println("ERROR: Failed to start telemetry writer!");
+    log_file.close();
+    write_queue = NULL;
+    return false;
+  }
+
+  last_flush = millis();
+  Serial.printf("Telemetry log: %s\n", path);
+  return true;
+}
@@ -0,0 +1,197 @@
+#include "trace.h"
+
+#if LV_USE_PROFILER && LV_USE_PROFILER_BUILTIN
+
+#include <src/misc/lv_profiler_builtin_private.h>
+#include <Arduino.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <esp_timer.h>
+#else
+#include <pthread.h>
+#endif
+
+// LVGL's profiler keeps its markers as { tick, 'B'/'E', tag pointer } (plus thread
+// and CPU with an OS) and flushes them here in one batch, under its lock. A marker
+// becomes 4-5 bytes instead of a ~70 character systrace line: tags are interned by
+// pointer and sent once, times are deltas in microseconds.
+
+#define NAME_SLOTS      (TRACE_MAX_NAMES * 2)  // open addressing, at most half full
+#define NAME_MAX_LEN    63
+#define PAYLOAD_MAX     255
+#define THREAD_MAX      8
+
+static const char *name_ptr[NAME_SLOTS];
+static uint8_t name_id[NAME_SLOTS];
+static uint16_t name_cnt;
+
+static uint8_t packet[4 + PAYLOAD_MAX + 2];
+static uint16_t payload_len;
+static uint8_t seq;
+static uint64_t last_tick;
+
+// ===== Platform =====
+// On the host it is the stand-in's clock, which the tests move
+static uint64_t tick_us(void) {
+#ifdef ARDUINO
+  return (uint64_t)esp_timer_get_time();
+#else
+  return micros();
+#endif
+}
+
+static void write_out(const uint8_t *buf, size_t len) {
+  Serial.write(buf, len);
+}
+
+#if LV_USE_OS
+// Threads are numbered in order of appearance to keep the tid varint one byte.
+// Called by the profiler under its lock.
+static int thread_id(void) {
+#ifdef ARDUINO
+  static TaskHandle_t threads[THREAD_MAX];
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+#else
+  static pthread_t threads[THREAD_MAX];
+  pthread_t self = pthread_self();
+#endif
+  static int thread_cnt;
+  for (int i = 0; i < thread_cnt; i++) {
+    if (threads[i] == self) return i + 1;
+  }
+  if (thread_cnt == THREAD_MAX) return 0;
+  threads[thread_cnt++] = self;
+  return thread_cnt;
+}
+
+static int cpu_id(void) {
+#ifdef ARDUINO
+  return xPortGetCoreID();
+#else
+  return 0;
+#endif
+}
+#endif
+
+// ===== Packets =====
+static void send_packet(void) {
+  if (payload_len == 0) return;
+
+  packet[0] = TRACE_SYNC1;
+  packet[1] = TRACE_SYNC2;
+  packet[2] = (uint8_t)payload_len;
+  packet[3] = seq++;
+
+  // Fletcher-16 of seq and payload
+  uint16_t sum1 = 0, sum2 = 0;
+  for (uint16_t i = 3; i < 4 + payload_len; i++) {
+    sum1 = (sum1 + packet[i]) % 255;
+    sum2 = (sum2 + sum1) % 255;
+  }
+  packet[4 + payload_len] = (uint8_t)sum1;
+  packet[5 + payload_len] = (uint8_t)sum2;
+
+  write_out(packet, 6 + payload_len);
+  payload_len = 0;
+}
+
+// Make room for a record of up to `len` bytes
+static uint8_t *reserve(uint16_t len) {
+  if (payload_len + len > PAYLOAD_MAX) send_packet();
+  return &packet[4 + payload_len];
+}
+
+static uint8_t *put_varint(uint8_t *p, uint32_t v) {
+  while (v >= 0x80) {
+    *p++ = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  *p++ = (uint8_t)v;
+  return p;
+}
+
+static void commit(const uint8_t *end) {
+  payload_len = end - &packet[4];
+}
+
+// ===== Names =====
+static uint8_t name_to_id(const char *name) {
+  uint32_t h = ((uint32_t)(uintptr_t)name * 2654435761u) >> 8;
+  for (uint32_t i = 0;; i++) {
+    uint32_t slot = (h + i) % NAME_SLOTS;
+    if (name_ptr[slot] == name) return name_id[slot];
+    if (name_ptr[slot] != NULL) continue;
+
+    if (name_cnt == TRACE_MAX_NAMES) return 0;  // "?"
+    name_ptr[slot] = name;
+    name_id[slot] = ++name_cnt;
+
+    size_t len = strlen(name);
+    if (len > NAME_MAX_LEN) len = NAME_MAX_LEN;
+    uint8_t *p = reserve(1 + 2 + 1 + len);
+    *p++ = TRACE_REC_NAME;
+    p = put_varint(p, name_cnt);
+    *p++ = (uint8_t)len;
+    memcpy(p, name, len);
+    commit(p + len);
+    return name_cnt;
+  }
+}
+
+static void flush_items_cb(const lv_profiler_builtin_item_t *items, uint32_t cnt) {
+  for (uint32_t i = 0; i < cnt; i++) {
+    const lv_profiler_builtin_item_t *item = &items[i];
+    uint8_t id = name_to_id(item->func);
+#if LV_USE_OS
+    uint8_t cpu = item->cpu & 0x0F;
+    uint32_t tid = item->tid;
+#else
+    uint8_t cpu = 0;
+    uint32_t tid = 0;
+#endif
+
+    uint8_t *p = reserve(1 + 2 + 5 + 2);
+    *p++ = (item->tag == 'B' ? TRACE_REC_BEGIN : TRACE_REC_END) | cpu << 4;
+    p = put_varint(p, id);
+    p = put_varint(p, (uint32_t)(item->tick - last_tick));
+    p = put_varint(p, tid);
+    commit(p);
+    last_tick = item->tick;
+  }
+  send_packet();
+}
+
+void trace_begin(void) {
+  memset(name_ptr, 0, sizeof(name_ptr));
+  name_cnt = 0;
+  payload_len = 0;
+  last_tick = tick_us();
+
+  lv_profiler_builtin_config_t config;
+  lv_profiler_builtin_config_init(&config);
+  config.tick_per_sec = 1000000;
+  config.tick_get_cb = tick_us;
+  config.flush_items_cb = flush_items_cb;
+#if LV_USE_OS
+  config.tid_get_cb = thread_id;
+  config.cpu_get_cb = cpu_id;
+#endif
+  lv_profiler_builtin_init(&config);
+
+  uint8_t *p = reserve(1);
+  *p++ = TRACE_REC_START;
+  commit(p);
+  send_packet();
+}
+
+void trace_poll(void) {
+  lv_profiler_builtin_flush();
+}
+
+#else
+
+void trace_begin(void) {}
+void trace_poll(void) {}
+
+#endif
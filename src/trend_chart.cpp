@@ -0,0 +1,190 @@
+#include "trend_chart.h"
+#include <src/misc/cache/lv_cache.h>
+
+// Unlike lv_chart, which re-renders every series point on each update, the plot
+// lives in a retained RGB565 strip. A new sample rasterises one column into it and
+// the draw callback just blits the strip (in two parts when the ring has wrapped).
+
+#define TREND_SWEEP_GAP  4   // erased columns ahead of the sweep cursor
+
+typedef struct {
+  uint16_t *strip;           // w x h RGB565, row stride w
+  lv_image_dsc_t part[2];    // [0] = oldest columns, [1] = wrapped remainder
+  int32_t w;
+  int32_t h;
+  int32_t head;              // next column to write
+  trend_chart_mode_t mode;
+  int16_t min;
+  int16_t max;
+  uint16_t bg;
+  uint16_t band;
+  uint16_t line;
+} trend_chart_t;
+
+static int32_t value_to_y(const trend_chart_t *tc, int16_t v) {
+  if (v <= tc->min) return tc->h - 1;
+  if (v >= tc->max) return 0;
+  return (tc->h - 1) - (int32_t)(v - tc->min) * (tc->h - 1) / (tc->max - tc->min);
+}
+
+static void fill_column(trend_chart_t *tc, int32_t x, uint16_t color) {
+  uint16_t *px = tc->strip + x;
+  for (int32_t y = 0; y < tc->h; y++, px += tc->w) *px = color;
+}
+
+static void raster_column(trend_chart_t *tc, int32_t x, const hist_point_t *p) {
+  if (p->min > p->max) {
+    fill_column(tc, x, tc->bg);
+    return;
+  }
+
+  int32_t y_top = value_to_y(tc, p->max);
+  int32_t y_bottom = value_to_y(tc, p->min);
+  int32_t y_avg = value_to_y(tc, p->avg);
+
+  uint16_t *px = tc->strip + x;
+  for (int32_t y = 0; y < tc->h; y++, px += tc->w) {
+    if (y == y_avg) *px = tc->line;
+    else if (y >= y_top && y <= y_bottom) *px = tc->band;
+    else *px = tc->bg;
+  }
+}
+
+static void set_part(trend_chart_t *tc, uint8_t i, int32_t first_col, int32_t cols) {
+  lv_image_dsc_t *img = &tc->part[i];
+  img->header.w = cols;
+  img->data = (const uint8_t *)(tc->strip + first_col);
+  img->data_size = (tc->h - 1) * img->header.stride + cols * 2;
+  lv_image_cache_drop(img);
+}
+
+static void draw_cb(lv_event_t *e) {
+  lv_obj_t *obj = (lv_obj_t *)lv_event_get_target(e);
+  trend_chart_t *tc = (trend_chart_t *)lv_obj_get_user_data(obj);
+  lv_layer_t *layer = lv_event_get_layer(e);
+
+  lv_area_t area;
+  lv_obj_get_coords(obj, &area);
+
+  lv_draw_image_dsc_t dsc;
+  lv_draw_image_dsc_init(&dsc);
+
+  if (tc->mode == TREND_CHART_SCROLL && tc->head > 0) {
+    // Oldest columns [head, w) on the left, newest [0, head) on the right
+    set_part(tc, 0, tc->head, tc->w - tc->head);
+    set_part(tc, 1, 0, tc->head);
+
+    lv_area_t a = area;
+    a.x2 = a.x1 + (tc->w - tc->head) - 1;
+    dsc.src = &tc->part[0];
+    lv_draw_image(layer, &dsc, &a);
+
+    a.x1 = a.x2 + 1;
+    a.x2 = area.x2;
+    dsc.src = &tc->part[1];
+    lv_draw_image(layer, &dsc, &a);
+  } else {
+    set_part(tc, 0, 0, tc->w);
+    dsc.src = &tc->part[0];
+    lv_draw_image(layer, &dsc, &area);
+  }
+}
+
+static void delete_cb(lv_event_t *e) {
+  lv_obj_t *obj = (lv_obj_t *)lv_event_get_target(e);
+  trend_chart_t *tc = (trend_chart_t *)lv_obj_get_user_data(obj);
+  free(tc->strip);
+  free(tc);
+}
+
+lv_obj_t *trend_chart_create(lv_obj_t *parent, int32_t w, int32_t h, trend_chart_mode_t mode) {
+  trend_chart_t *tc = (trend_chart_t *)calloc(1, sizeof(trend_chart_t));
+  if (!tc) return NULL;
+  tc->strip = (uint16_t *)malloc(w * h * sizeof(uint16_t));
+  if (!tc->strip) {
+    free(tc);
+    return NULL;
+  }
+
+  tc->w = w;
+  tc->h = h;
+  tc->mode = mode;
+  tc->min = 0;
+  tc->max = 100;
+  tc->bg = lv_color_to_u16(lv_color_white());
+  tc->band = lv_color_to_u16(lv_color_hex(0x99ccff));
+  tc->line = lv_color_to_u16(lv_color_hex(0x0055cc));
+  for (int32_t x = 0; x < w; x++) fill_column(tc, x, tc->bg);
+
+  for (uint8_t i = 0; i < 2; i++) {
+    tc->part[i].header.magic = LV_IMAGE_HEADER_MAGIC;
+    tc->part[i].header.cf = LV_COLOR_FORMAT_RGB565;
+    tc->part[i].header.h = h;
+    tc->part[i].header.stride = w * sizeof(uint16_t);
+  }
+
+  lv_obj_t *obj = lv_obj_create(parent);
+  lv_obj_remove_style_all(obj);
+  lv_obj_set_size(obj, w, h);
+  lv_obj_remove_flag(obj, LV_OBJ_FLAG_CLICKABLE);
+  lv_obj_set_user_data(obj, tc);
+  lv_obj_add_event_cb(obj, draw_cb, LV_EVENT_DRAW_MAIN, NULL);
+  lv_obj_add_event_cb(obj, delete_cb, LV_EVENT_DELETE, NULL);
+  return obj;
+}
+
+void trend_chart_set_range(lv_obj_t *chart, int16_t min, int16_t max) {
+  trend_chart_t *tc = (trend_chart_t *)lv_obj_get_user_data(chart);
+  tc->min = min;
+  tc->max = max > min ? max : min + 1;
+}
+
+void trend_chart_set_colors(lv_obj_t *chart, lv_color_t bg, lv_color_t band, lv_color_t line) {
+  trend_chart_t *tc = (trend_chart_t *)lv_obj_get_user_data(chart);
+  tc->bg = lv_color_to_u16(bg);
+  tc->band = lv_color_to_u16(band);
+  tc->line = lv_color_to_u16(line);
+}
+
+void trend_chart_push(lv_obj_t *chart, const hist_point_t *p) {
+  trend_chart_t *tc = (trend_chart_t *)lv_obj_get_user_data(chart);
+  int32_t x = tc->head;
+
+  raster_column(tc, x, p);
+  tc->head = (x + 1) % tc->w;
+
+  if (tc->mode == TREND_CHART_SCROLL) {
+    // Every on-screen column moved one pixel to the left
+    lv_obj_invalidate(chart);
+    return;
+  }
+
+  // Sweep: erase the gap ahead of the cursor; flush only the new column + gap
+  lv_area_t a;
+  lv_obj_get_coords(chart, &a);
+  int32_t x0 = a.x1;
+  int32_t last = x + TREND_SWEEP_GAP;
+  for (int32_t g = x + 1; g <= last; g++) fill_column(tc, g % tc->w, tc->bg);
+
+  a.x1 = x0 + x;
+  a.x2 = x0 + LV_MIN(last, tc->w - 1);
+  lv_obj_invalidate_area(chart, &a);
+  if (last >= tc->w) {
+    a.x1 = x0;
+    a.x2 = x0 + (last - tc->w);
+    lv_obj_invalidate_area(chart, &a);
+  }
+}
+
+void trend_chart_load_history(lv_obj_t *chart, hist_signal_t sig, uint32_t span_ms) {
+  trend_chart_t *tc = (trend_chart_t *)lv_obj_get_user_data(chart);
+  hist_point_t *cols = (hist_point_t *)malloc(tc->w * sizeof(hist_point_t));
+  if (!cols) return;
+
+  uint16_t n = history_query(sig, span_ms, cols, tc->w);
+  for (uint16_t x = 0; x < n; x++) raster_column(tc, x, &cols[x]);
+  free(cols);
+
+  tc->head = 0;   // column 0 holds the oldest point
+  lv_obj_invalidate(chart);
+}
@@ -0,0 +1,111 @@
+#include "trend_screen.h"
+#include "settings_screen.h"
+#include "trend_chart.h"
+#include "history.h"
+
+typedef struct {
+  const char *range;        // shown under the chart
+  int16_t min;
+  int16_t max;
+} signal_info_t;
+
+// In history units (power in 10 W)
+static const signal_info_t signals[HIST_SIGNAL_COUNT] = {
+  { "0 - 150 km/h",  0,    150 },
+  { "-2 - 10 kW",    -200, 1000 },
+  { "0 - 100 %",     0,    100 },
+  { "-20 - 80 °C",   -20,  80 },
+  { "-20 - 120 °C",  -20,  120 },
+};
+static const char *const signal_map[] = { "Speed", "Power", "SoC", "Battery", "Motor", "" };
+
+static lv_obj_t *chart;
+static lv_obj_t *info_label;
+static lv_timer_t *push_timer;
+static hist_signal_t shown = HIST_SPEED;
+
+// One column per TREND_SCREEN_CHART_W-th of the span
+static uint32_t column_ms(void) {
+  return ui_settings.trend_span_ms / TREND_SCREEN_CHART_W;
+}
+
+static void push_cb(lv_timer_t *t) {
+  hist_point_t p;
+  if (history_query(shown, column_ms(), &p, 1)) trend_chart_push(chart, &p);
+}
+
+static void reload(void) {
+  const signal_info_t *info = &signals[shown];
+  uint32_t span_min = ui_settings.trend_span_ms / 60000;
+  trend_chart_set_range(chart, info->min, info->max);
+  trend_chart_load_history(chart, shown, ui_settings.trend_span_ms);
+  if (span_min < 60) lv_label_set_text_fmt(info_label, "%s, last %lu min", info->range, (unsigned long)span_min);
+  else lv_label_set_text_fmt(info_label, "%s, last %lu h", info->range, (unsigned long)(span_min / 60));
+  lv_timer_set_period(push_timer, column_ms());
+  lv_timer_reset(push_timer);
+}
+
+static void signal_cb(lv_event_t *e) {
+  uint32_t i = lv_buttonmatrix_get_selected_button(lv_event_get_target_obj(e));
+  if (i >= HIST_SIGNAL_COUNT) return;
+  shown = (hist_signal_t)i;
+  reload();
+}
+
+static void deleted_cb(lv_event_t *e) {
+  if (push_timer) lv_timer_delete(push_timer);
+  push_timer = NULL;
+  chart = NULL;
+  info_label = NULL;
+}
+
+static lv_obj_t *build(void) {
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(scr, lv_color_hex(0xe5e5e5), 0);
+  lv_obj_add_event_cb(scr, deleted_cb, LV_EVENT_DELETE, NULL);
+
+  chart = trend_chart_create(scr, TREND_SCREEN_CHART_W, TREND_SCREEN_CHART_H, ui_settings.trend_mode);
+  if (!chart) {
+    lv_obj_delete(scr);
+    return NULL;
+  }
+  lv_obj_align(chart, LV_ALIGN_TOP_MID, 0, 115);
+
+  screen_mgr_top_bar(scr, "Trends");
+
+  lv_obj_t *btnm = lv_buttonmatrix_create(scr);
+  lv_buttonmatrix_set_map(btnm, signal_map);
+  lv_buttonmatrix_set_button_ctrl_all(btnm, LV_BUTTONMATRIX_CTRL_CHECKABLE);
+  lv_buttonmatrix_set_one_checked(btnm, true);
+  lv_buttonmatrix_set_button_ctrl(btnm, shown, LV_BUTTONMATRIX_CTRL_CHECKED);
+  lv_obj_set_size(btnm, 440, 50);
+  lv_obj_align(btnm, LV_ALIGN_TOP_MID, 0, 60);
+  lv_obj_set_style_pad_all(btnm, 4, 0);
+  lv_obj_set_style_text_font(btnm, &lv_font_montserrat_14, 0);
+  lv_obj_add_event_cb(btnm, signal_cb, LV_EVENT_VALUE_CHANGED, NULL);
+
+  info_label = lv_label_create(scr);
+  lv_obj_set_style_text_color(info_label, lv_color_black(), 0);
+  lv_obj_set_style_text_font(info_label, &lv_font_montserrat_14, 0);
+  lv_obj_align(info_label, LV_ALIGN_TOP_MID, 0, 115 + TREND_SCREEN_CHART_H + 8);
+
+  push_timer = lv_timer_create(push_cb, column_ms(), NULL);
+  lv_timer_pause(push_timer);
+  return scr;
+}
+
+static void on_show(lv_obj_t *scr) {
+  // Columns were not pushed while hidden, and the span may have changed
+  reload();
+  lv_timer_resume(push_timer);
+}
+
+static void on_hide(lv_obj_t *scr) {
+  lv_timer_pause(push_timer);
+}
+
+const screen_desc_t trend_screen_desc = {
+  "trends", build, on_show, on_hide,
+  3 * 1024, TREND_SCREEN_CHART_W * TREND_SCREEN_CHART_H * 2,
+  SCREEN_MENU, false,
+};
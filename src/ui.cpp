@@ -1,117 +1,150 @@
 #include "ui.h"
+#include "num_label.h"
+#include "map_screen.h"
+#include "fonts/lv_font_montserrat_78.h"
 
 DashboardData dashData;
 lv_display_t *disp;
 void *draw_buf;
-uint8_t *image_data;
-uint32_t image_size;
 
-/* Update specific UI element based on ID */
-void update_ui_element(uint8_t id) {
-  char buf[32];
-  
-  switch(id) {
-    case ID_SPEED:
-      snprintf(buf, sizeof(buf), "%d", dashData.speed);
-      lv_label_set_text(speed_label, buf);
-      break;
-      
-    case ID_RANGE:
-      snprintf(buf, sizeof(buf), "Range %d km", dashData.range);
-      lv_label_set_text(range_label, buf);
-      break;
-      
-    case ID_CONSUMPTION:
-      snprintf(buf, sizeof(buf), "Avg. %d W/km", dashData.avg_wkm);
-      lv_label_set_text(avg_wkm_label, buf);
-      break;
-      
-    case ID_TRIP:
-      snprintf(buf, sizeof(buf), "TRIP %d km", dashData.trip);
-      lv_label_set_text(trip_label, buf);
-      break;
-      
-    case ID_ODOMETER:
-      snprintf(buf, sizeof(buf), "ODO %d km", dashData.odo);
-      lv_label_set_text(odo_label, buf);
-      break;
-      
-    case ID_AVG_SPEED:
-      snprintf(buf, sizeof(buf), "AVG. %d km/h", dashData.avg_kmh);
-      lv_label_set_text(avg_kmh_label, buf);
-      break;
-      
-    case ID_TEMP:
-      snprintf(buf, sizeof(buf), "Battery %d°C", dashData.battery_temp);
-      lv_label_set_text(battery_temp_label, buf);
-      break;
-      
-    case ID_AMBIENT_TEMP:
-      snprintf(buf, sizeof(buf), "Motor %d°C", dashData.motor_temp);
-      lv_label_set_text(motor_temp_label, buf);
-      break;
-      
-    case ID_MODE:
-      lv_label_set_text(mode_label, dashData.mode.c_str());
-      // Update color based on mode
-      if (dashData.mode == "Eco") {
-        lv_obj_set_style_text_color(mode_label, lv_color_hex(0x00cc00), 0);
-      } else if (dashData.mode == "City") {
-        lv_obj_set_style_text_color(mode_label, lv_color_hex(0x0088ff), 0);
-      } else if (dashData.mode == "Sport") {
-        lv_obj_set_style_text_color(mode_label, lv_color_hex(0xff0000), 0);
-      }
-      break;
-      
-    case ID_ARMED:
-      lv_label_set_text(status_label, dashData.status.c_str());
-      break;
+// One field widget of the dashboard. The table below both creates the widgets
+// and updates them, so a field's format can't differ between the two.
+struct ui_field_t {
+  uint8_t id;                    // ID_* shown
+  uint8_t parent;                // ui_parent_t
+  const lv_font_t *font;
+  uint32_t color;                // 0xRRGGBB
+  const uint32_t *colors;        // 0xRRGGBB by number() for a text field, or NULL
+  lv_align_t align;
+  int16_t x, y;
+  const char *prefix, *suffix;   // around a number (num_label_set_text)
+  int32_t min, max;              // number range, in units of 10^-decimals
+  uint8_t decimals;
+  int32_t (*number)(void);       // value of a numeric field (with colors: color index, <0 keeps it)
+  const char *(*text)(void);     // value of a text field
+  lv_obj_t **obj;
+};
 
-      case ID_SOC:
-      snprintf(buf, sizeof(buf), "SoC: %d%%", dashData.soc);
-      lv_label_set_text(soc, buf);
-      break;
+static int32_t get_speed(void)        { return dashData.speed; }
+static int32_t get_range(void)        { return dashData.range; }
+static int32_t get_avg_wkm(void)      { return dashData.avg_wkm; }
+static int32_t get_voltage(void)      { return lroundf(dashData.voltage * 100); }
+static int32_t get_current(void)      { return lroundf(dashData.current * 100); }
+static int32_t get_motor_temp(void)   { return dashData.motor_temp; }
+static int32_t get_battery_temp(void) { return dashData.battery_temp; }
+static int32_t get_soc(void)          { return dashData.soc; }
+static int32_t get_trip(void)         { return dashData.trip; }
+static int32_t get_odo(void)          { return dashData.odo; }
+static int32_t get_avg_kmh(void)      { return dashData.avg_kmh; }
+static const char *get_mode(void)     { return dashData.mode.c_str(); }
+static int32_t get_mode_index(void) {
+  if (dashData.mode == "Eco") return MODE_ECO;
+  if (dashData.mode == "City") return MODE_CITY;
+  if (dashData.mode == "Sport") return MODE_SPORT;
+  return -1;
+}
 
-    case ID_VOLTAGE:
-      snprintf(buf, sizeof(buf), "Volt: %.2f V", dashData.voltage);
-      lv_label_set_text(voltage, buf);
-      break;
+// Indexed by DrivingMode
+static const uint32_t mode_colors[] = { 0x00cc00, 0x0088ff, 0xff0000 };
 
-    case ID_CURRENT:
-      snprintf(buf, sizeof(buf), "Curr: %.2f A", dashData.current);
-      lv_label_set_text(current, buf);
-      break;
-  }
+
+// Constant data: stays in flash. Created in this order.
+static constexpr ui_field_t fields[] = {
+  // id             parent                font                    color     colors       align               x    y    prefix          suffix     min     max     dec  number            text      object
+  { ID_SPEED,        UI_PARENT_SCREEN,     &lv_font_montserrat_78, 0x000000, NULL,        LV_ALIGN_CENTER,    -24, -40, NULL,           NULL,      0,      199,    0,   get_speed,        NULL,     &speed_label },
+  { ID_MODE,         UI_PARENT_MODE_BOX,   &lv_font_montserrat_20, 0x00cc00, mode_colors, LV_ALIGN_CENTER,    0,   0,   NULL,           NULL,      0,      0,      0,   get_mode_index,   get_mode, &mode_label },
+  // Left side
+  { ID_RANGE,        UI_PARENT_SCREEN,     &lv_font_montserrat_16, 0x000000, NULL,        LV_ALIGN_LEFT_MID,  10,  -60, "Range: ",      " km",     0,      999,    0,   get_range,        NULL,     &range_label },
+  { ID_CONSUMPTION,  UI_PARENT_SCREEN,     &lv_font_montserrat_16, 0x000000, NULL,        LV_ALIGN_LEFT_MID,  10,  -20, "Avg. con: ",   " W/km",   0,      999,    0,   get_avg_wkm,      NULL,     &avg_wkm_label },
+  { ID_VOLTAGE,      UI_PARENT_SCREEN,     &lv_font_montserrat_16, 0x000000, NULL,        LV_ALIGN_LEFT_MID,  10,  60,  "Volt: ",       " V",      0,      9999,   2,   get_voltage,      NULL,     &voltage },
+  { ID_CURRENT,      UI_PARENT_SCREEN,     &lv_font_montserrat_16, 0x000000, NULL,        LV_ALIGN_LEFT_MID,  10,  90,  "Current: ",    " A",      -99999, 99999,  2,   get_current,      NULL,     &current },
+  // Right side
+  { ID_AMBIENT_TEMP, UI_PARENT_SCREEN,     &lv_font_montserrat_16, 0x000000, NULL,        LV_ALIGN_RIGHT_MID, -10, -60, "Motor: ",      "°C",      -40,    199,    0,   get_motor_temp,   NULL,     &motor_temp_label },
+  { ID_TEMP,         UI_PARENT_SCREEN,     &lv_font_montserrat_16, 0x000000, NULL,        LV_ALIGN_RIGHT_MID, -10, -20, "Battery: ",    "°C",      -40,    199,    0,   get_battery_temp, NULL,     &battery_temp_label },
+  { ID_SOC,          UI_PARENT_SCREEN,     &lv_font_montserrat_16, 0x000000, NULL,        LV_ALIGN_RIGHT_MID, -10, 60,  "SoC: ",        "%",       0,      100,    0,   get_soc,          NULL,     &soc },
+  // Bottom bar
+  { ID_TRIP,         UI_PARENT_BOTTOM_BAR, &lv_font_montserrat_14, 0x000000, NULL,        LV_ALIGN_LEFT_MID,  5,   0,   "TRIP: ",       " km",     0,      99999,  0,   get_trip,         NULL,     &trip_label },
+  { ID_ODOMETER,     UI_PARENT_BOTTOM_BAR, &lv_font_montserrat_14, 0x000000, NULL,        LV_ALIGN_CENTER,    0,   0,   "ODO: ",        " km",     0,      999999, 0,   get_odo,          NULL,     &odo_label },
+  { ID_AVG_SPEED,    UI_PARENT_BOTTOM_BAR, &lv_font_montserrat_14, 0x000000, NULL,        LV_ALIGN_RIGHT_MID, -2,  0,   "Avg. SPEED: ", " km/h",   0,      199,    0,   get_avg_kmh,      NULL,     &avg_kmh_label },
+};
+
+#define FIELD_CNT  (sizeof(fields) / sizeof(fields[0]))
+
+// Checked at compile time: each field once, each entry numeric, text, or text
+// coloured by number()
+static constexpr bool entry_valid(const ui_field_t &f) {
+  return f.text ? !f.number == !f.colors : f.number && !f.colors;
 }
+static constexpr bool fields_valid(size_t i, size_t j) {
+  return i >= FIELD_CNT ? true
+       : j >= FIELD_CNT ? entry_valid(fields[i]) && fields_valid(i + 1, i + 2)
+       : fields[i].id != fields[j].id && fields_valid(i, j + 1);
+}
+static_assert(fields_valid(0, 1), "a field is in the table twice, or has no single value source");
 
-bool load_image_to_ram(const char *path) {
-  Serial.printf("Loading image: %s\n", path);
+static const ui_field_t *find_field(uint8_t id) {
+  for (const ui_field_t &f : fields) {
+    if (f.id == id) return &f;
+  }
+  return NULL;
+}
 
-  File file = SD.open(path);
-  if (!file) {
-    Serial.println("ERROR: Failed to open image file!");
-    return false;
+static void set_field(const ui_field_t *f) {
+  lv_obj_t *obj = *f->obj;
+  if (!obj) return;              // the dashboard isn't built yet
+  if (!f->text) {
+    num_label_set_value(obj, f->number());
+    return;
   }
+  lv_label_set_text(obj, f->text());
+  int32_t c = f->colors ? f->number() : -1;
+  if (c >= 0) lv_obj_set_style_text_color(obj, lv_color_hex(f->colors[c]), 0);
+}
 
-  image_size = file.size();
-  image_data = (uint8_t *)malloc(image_size);
-  if (!image_data) {
-    Serial.println("ERROR: Failed to allocate memory for image!");
-    file.close();
-    return false;
+void ui_create_fields(lv_obj_t *const parents[UI_PARENT_COUNT]) {
+  for (const ui_field_t &f : fields) {
+    lv_obj_t *obj;
+    if (f.text) {
+      obj = lv_label_create(parents[f.parent]);
+    } else {
+      obj = num_label_create(parents[f.parent], f.min, f.max, f.decimals);
+    }
+    // Font first: num_label sizes itself for it
+    lv_obj_set_style_text_font(obj, f.font, 0);
+    lv_obj_set_style_text_color(obj, lv_color_hex(f.color), 0);
+    if (f.prefix || f.suffix) num_label_set_text(obj, f.prefix, f.suffix);
+    *f.obj = obj;
+    set_field(&f);
+    lv_obj_align(obj, f.align, f.x, f.y);
   }
+}
 
-  size_t bytes_read = file.read(image_data, image_size);
-  file.close();
+/* Update specific UI element based on ID */
+void update_ui_element(uint8_t id) {
+  LV_PROFILER_BEGIN;
+  const ui_field_t *f = find_field(id);
+  if (f) set_field(f);
 
-  if (bytes_read != image_size) {
-    free(image_data);
-    image_data = NULL;
-    return false;
+  switch(id) {
+    case ID_LATITUDE:
+    case ID_LONGITUDE:
+    case ID_HEADING:
+      map_screen_position_changed();
+      break;
   }
+  LV_PROFILER_END;
+}
+
+/* Object showing a field, NULL if none */
+static lv_obj_t *field_object(uint8_t id) {
+  const ui_field_t *f = find_field(id);
+  return f ? *f->obj : NULL;
+}
 
-  Serial.println("Image loaded into RAM successfully!");
-  return true;
+void ui_set_stale(uint8_t id, bool stale) {
+  lv_obj_t *obj = field_object(id);
+  if (!obj) return;
+  lv_obj_set_style_text_opa(obj, stale ? UI_STALE_OPA : LV_OPA_COVER, 0);
 }
 
 /* Update time display */
@@ -120,7 +153,11 @@ void update_time_display() {
   int hours = (now / 3600) % 24;
   int minutes = (now / 60) % 60;
 
-  char time_str[16];
-  snprintf(time_str, sizeof(time_str), "%d:%02d AM", hours == 0 ? 12 : hours, minutes);
-  lv_label_set_text(time_label, time_str);
+  // The label points at time_str, so it neither allocates nor redraws until the minute changes
+  static char time_str[16];
+  char next[sizeof(time_str)];
+  snprintf(next, sizeof(next), "%d:%02d AM", hours == 0 ? 12 : hours, minutes);
+  if (strcmp(next, time_str) == 0) return;
+  memcpy(time_str, next, sizeof(time_str));
+  lv_label_set_text_static(time_label, time_str);
 }
\ No newline at end of file
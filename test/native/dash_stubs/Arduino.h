@@ -0,0 +1,68 @@
+#pragma once
+// Arduino.h - host stand-in for the native test env (see [env:native])
+//
+// Only what the modules under test use from the Arduino core: String for
+// DashboardData, millis()/micros() driven by the test, Serial writing to
+// stdout or to a test's capture, and the heap queries of a board without PSRAM.
+
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+class String {
+public:
+  String(const char *s = "") : s_(s) {}
+  const char *c_str() const { return s_.c_str(); }
+  String &operator=(const char *s) { s_ = s; return *this; }
+  bool operator==(const char *s) const { return s_ == s; }
+private:
+  std::string s_;
+};
+
+class HardwareSerial {
+public:
+  std::string *capture = NULL;   // set by a test to collect everything written
+
+  int printf(const char *fmt, ...) {
+    char buf[256];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n > 0) write((const uint8_t *)buf, (size_t)n < sizeof(buf) ? n : sizeof(buf) - 1);
+    return n;
+  }
+  size_t write(const uint8_t *buf, size_t len) {
+    if (capture) capture->append((const char *)buf, len);
+    else fwrite(buf, 1, len, stdout);
+    return len;
+  }
+  size_t write(uint8_t b) { return write(&b, 1); }
+};
+extern HardwareSerial Serial;
+
+// The clock only moves when a test sets it
+extern unsigned long native_millis;
+inline unsigned long millis() { return native_millis; }
+inline unsigned long micros() { return native_millis * 1000; }
+
+// No PSRAM: heap_caps_malloc(MALLOC_CAP_SPIRAM) fails and callers fall back to malloc()
+#define MALLOC_CAP_8BIT    (1 << 2)
+#define MALLOC_CAP_SPIRAM  (1 << 10)
+inline void *heap_caps_malloc(size_t, uint32_t) { return NULL; }
+
+// The system heap reports what a test sets, not what the host has
+class EspClass {
+public:
+  uint32_t free_heap = 160 * 1024;
+
+  uint32_t getFreeHeap() { return free_heap; }
+  uint32_t getMinFreeHeap() { return free_heap; }
+};
+extern EspClass ESP;
+inline size_t heap_caps_get_largest_free_block(uint32_t) { return ESP.free_heap; }
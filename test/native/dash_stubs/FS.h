@@ -0,0 +1,116 @@
+#pragma once
+// FS.h - host stand-in: an in-memory file system behind a counting SD card model
+//
+// Tests add read-only files with sd_card_add_file(); any other path fails to
+// open, so without files the code under test sees a missing SD card. Reads
+// follow FatFs: a run of whole sectors goes to the card as one multi-block
+// command, and a partial sector is read into the file's one-sector buffer, so
+// the next partial read of that sector costs nothing. sd_card counts what the
+// card would have to do.
+
+#include <Arduino.h>
+
+#define FILE_READ    "r"
+#define FILE_WRITE   "w"
+#define FILE_APPEND  "a"
+
+#define SD_CARD_SECTOR    512
+#define SD_CARD_MAX_FILES 8
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+typedef struct {
+  unsigned long opens;
+  unsigned long reads;        // File::read() calls
+  unsigned long read_bytes;   // bytes returned to the caller
+  unsigned long commands;     // card read commands (single- or multi-block)
+  unsigned long sectors;      // sectors transferred by the card
+} sd_card_stats_t;
+
+extern sd_card_stats_t sd_card;
+
+typedef struct {
+  const char *path;
+  const uint8_t *data;        // not copied; must outlive the files opened on it
+  size_t size;
+} sd_card_file_t;
+
+// Make `data` readable as `path` until sd_card_remove_files()
+void sd_card_add_file(const char *path, const uint8_t *data, size_t size);
+void sd_card_remove_files(void);
+const sd_card_file_t *sd_card_find(const char *path);
+
+namespace fs {
+
+class File {
+public:
+  File(const sd_card_file_t *f = NULL) : f_(f) {}
+
+  size_t read(uint8_t *buf, size_t len) {
+    if (!f_) return 0;
+    sd_card.reads++;
+    size_t n = pos_ < f_->size ? f_->size - pos_ : 0;
+    if (n > len) n = len;
+    size_t end = pos_ + n;
+    for (size_t p = pos_; p < end;) {
+      long sector = (long)(p / SD_CARD_SECTOR);
+      size_t whole = p % SD_CARD_SECTOR ? 0 : (end - p) / SD_CARD_SECTOR;
+      if (whole) {
+        sd_card.commands++;
+        sd_card.sectors += whole;
+        p += whole * SD_CARD_SECTOR;
+        continue;
+      }
+      if (sector != buffered_) {
+        sd_card.commands++;
+        sd_card.sectors++;
+        buffered_ = sector;
+      }
+      size_t sector_end = (size_t)(sector + 1) * SD_CARD_SECTOR;
+      p = end < sector_end ? end : sector_end;
+    }
+    memcpy(buf, f_->data + pos_, n);
+    pos_ = end;
+    sd_card.read_bytes += n;
+    return n;
+  }
+  size_t read() {
+    uint8_t b;
+    return read(&b, 1) ? b : (size_t)-1;
+  }
+  size_t write(const uint8_t *, size_t) { return 0; }
+  bool seek(uint32_t pos, SeekMode mode = SeekSet) {
+    if (!f_) return false;
+    size_t base = mode == SeekSet ? 0 : mode == SeekCur ? pos_ : f_->size;
+    if (base + pos > f_->size) return false;
+    pos_ = base + pos;
+    return true;
+  }
+  size_t position() const { return pos_; }
+  size_t size() const { return f_ ? f_->size : 0; }
+  size_t available() const { return f_ && pos_ < f_->size ? f_->size - pos_ : 0; }
+  void flush() {}
+  void close() { f_ = NULL; }
+  operator bool() const { return f_ != NULL; }
+
+private:
+  const sd_card_file_t *f_;
+  size_t pos_ = 0;
+  long buffered_ = -1;       // sector in the file's FatFs buffer
+};
+
+class FS {
+public:
+  File open(const char *path, const char *mode = FILE_READ, bool = false) {
+    const sd_card_file_t *f = strcmp(mode, FILE_READ) == 0 ? sd_card_find(path) : NULL;
+    if (f) sd_card.opens++;
+    return File(f);
+  }
+  bool exists(const char *path) { return sd_card_find(path) != NULL; }
+  bool mkdir(const char *) { return false; }
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
@@ -0,0 +1,12 @@
+#pragma once
+// SD.h - host stand-in: the SD card of FS.h, always mounted
+
+#include <FS.h>
+#include <SPI.h>
+
+class SDFS : public fs::FS {
+public:
+  bool begin(uint8_t = 5, SPIClass & = SPI, uint32_t = 4000000, const char * = "/sd") { return true; }
+  void end() {}
+};
+extern SDFS SD;
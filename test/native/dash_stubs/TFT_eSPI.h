@@ -0,0 +1,109 @@
+#pragma once
+// TFT_eSPI.h - host stand-in that models the panel and counts the SPI traffic
+//
+// Follows what LVGL's TFT_eSPI driver sends: address windows (setAddrWindow() or
+// raw CASET/PASET/RAMWR), pixels into tft_panel[], command bytes, bus writes and
+// transactions. test/test_tft_flush turns the counts into bus time.
+
+#include <Arduino.h>
+
+#define TFT_CASET    0x2A
+#define TFT_PASET    0x2B
+#define TFT_RAMWR    0x2C
+
+#define TFT_PANEL_W  480
+#define TFT_PANEL_H  320
+
+typedef struct {
+  unsigned long px;            // pixels sent
+  unsigned long cmd_bytes;     // command and parameter bytes
+  unsigned long windows;       // address windows opened
+  unsigned long writes;        // bus writes: a command, its parameters, a pixel push
+  unsigned long transactions;  // startWrite()..endWrite(), or a write outside of one
+  unsigned long out_of_window; // pixels past the end of the window
+} tft_bus_stats_t;
+
+extern tft_bus_stats_t tft_bus;
+extern uint16_t tft_panel[TFT_PANEL_W * TFT_PANEL_H];
+
+class TFT_eSPI {
+public:
+  TFT_eSPI(int16_t = TFT_PANEL_W, int16_t = TFT_PANEL_H) {}
+  void init() {}
+  void begin() {}
+  void setRotation(uint8_t) {}
+  void setSwapBytes(bool) {}
+  void fillScreen(uint32_t) {}
+
+  void startWrite() {
+    if (!open_) tft_bus.transactions++;
+    open_ = true;
+  }
+  void endWrite() { open_ = false; }
+
+  // CASET, PASET and RAMWR with 16-bit parameters: 11 bytes in 5 writes
+  void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h) {
+    lone_write();
+    tft_bus.cmd_bytes += 11;
+    tft_bus.writes += 4;
+    x1_ = x; x2_ = x + w - 1;
+    y1_ = y; y2_ = y + h - 1;
+    open_window();
+  }
+
+  void writecommand(uint8_t c) {
+    lone_write();
+    tft_bus.cmd_bytes++;
+    if (c == TFT_RAMWR) open_window();
+    else pending_ = c;
+  }
+  void writedata(uint8_t) {
+    lone_write();
+    tft_bus.cmd_bytes++;
+  }
+
+  // Pixels, or the parameters of a pending CASET/PASET
+  void pushColors(uint16_t *p, uint32_t n, bool = true) {
+    lone_write();
+    if (pending_ == TFT_CASET || pending_ == TFT_PASET) {
+      if (pending_ == TFT_CASET) { x1_ = p[0]; x2_ = p[1]; }
+      else { y1_ = p[0]; y2_ = p[1]; }
+      tft_bus.cmd_bytes += n * 2;
+      pending_ = 0;
+      return;
+    }
+    for (uint32_t i = 0; i < n; i++) pixel(p[i]);
+  }
+  void pushPixels(const void *p, uint32_t n) {
+    lone_write();
+    for (uint32_t i = 0; i < n; i++) pixel(((const uint16_t *)p)[i]);
+  }
+  void pushBlock(uint16_t c, uint32_t n) {
+    lone_write();
+    for (uint32_t i = 0; i < n; i++) pixel(c);
+  }
+
+private:
+  bool open_ = false;
+  uint8_t pending_ = 0;
+  int32_t x1_ = 0, x2_ = 0, y1_ = 0, y2_ = 0, pos_ = 0;
+
+  void lone_write() {
+    if (!open_) tft_bus.transactions++;
+    tft_bus.writes++;
+  }
+  void open_window() {
+    tft_bus.windows++;
+    pending_ = 0;
+    pos_ = 0;
+  }
+  void pixel(uint16_t c) {
+    int32_t w = x2_ - x1_ + 1;
+    int32_t x = x1_ + pos_ % w;
+    int32_t y = y1_ + pos_ / w;
+    pos_++;
+    tft_bus.px++;
+    if (y > y2_ || x >= TFT_PANEL_W || y >= TFT_PANEL_H) tft_bus.out_of_window++;
+    else tft_panel[y * TFT_PANEL_W + x] = c;
+  }
+};
@@ -0,0 +1,61 @@
+// dash_stubs.cpp - globals that main.cpp, rs485.cpp and the Arduino core provide on the target
+
+#include "shared.h"
+#include <SD.h>
+#include <TFT_eSPI.h>
+
+HardwareSerial Serial;
+EspClass ESP;
+SPIClass SPI;
+SDFS SD;
+unsigned long native_millis = 0;
+
+sd_card_stats_t sd_card;
+static sd_card_file_t sd_files[SD_CARD_MAX_FILES];
+static size_t sd_file_cnt;
+
+void sd_card_add_file(const char *path, const uint8_t *data, size_t size) {
+  if (sd_file_cnt < SD_CARD_MAX_FILES) sd_files[sd_file_cnt++] = { path, data, size };
+}
+
+void sd_card_remove_files(void) {
+  sd_file_cnt = 0;
+}
+
+const sd_card_file_t *sd_card_find(const char *path) {
+  for (size_t i = 0; i < sd_file_cnt; i++) {
+    if (strcmp(sd_files[i].path, path) == 0) return &sd_files[i];
+  }
+  return NULL;
+}
+
+tft_bus_stats_t tft_bus;
+uint16_t tft_panel[TFT_PANEL_W * TFT_PANEL_H];
+
+// Dashboard widgets, created by ui_create_fields()
+lv_obj_t *speed_label;
+lv_obj_t *range_label;
+lv_obj_t *avg_wkm_label;
+lv_obj_t *trip_label;
+lv_obj_t *odo_label;
+lv_obj_t *avg_kmh_label;
+lv_obj_t *motor_temp_label;
+lv_obj_t *battery_temp_label;
+lv_obj_t *mode_label;
+lv_obj_t *status_label;
+lv_obj_t *soc;
+lv_obj_t *voltage;
+lv_obj_t *current;
+lv_obj_t *time_label;
+
+// Same CRC-16/MODBUS as rs485.cpp, which cannot be built off-target
+extern "C" uint16_t calculateChecksum(const uint8_t *data, uint16_t length) {
+  uint16_t crc = 0xFFFF;
+  for (uint16_t pos = 0; pos < length; pos++) {
+    crc ^= data[pos];
+    for (uint8_t i = 8; i != 0; i--) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+    }
+  }
+  return crc;
+}
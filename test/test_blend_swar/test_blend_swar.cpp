@@ -0,0 +1,337 @@
+// test_blend_swar.cpp - SWAR blend kernels against lv_color_16_16_mix(), byte for byte
+//
+//   pio test -e native -f test_blend_swar -v
+//
+// The reference is LVGL's own per-pixel C path: lv_color_16_16_mix() with the
+// weight LVGL's dispatcher would pass (opa, mask, or LV_OPA_MIX2(mask, opa)).
+// Every kernel runs over all 256 opacities, widths 0-33 plus a few long rows,
+// word-aligned and half-word-offset destination, source and mask rows, and
+// random colours and masks. Rows are padded so writes outside the area fail too.
+// test_kernel_timings reports host ns per pixel of each blending kernel against
+// the per-pixel lv_color_16_16_mix() loop on one 480 x 40 render band; host
+// times only compare to each other.
+
+#include <unity.h>
+#include <lvgl.h>
+#include <src/draw/sw/blend/lv_draw_sw_blend_private.h>
+#include <stdio.h>
+#include <time.h>
+#include "blend_swar.h"
+
+#define ROWS      3
+#define PAD       4                  // pixels of canary on each side of a row
+#define MAX_W     160
+#define STRIDE_PX (MAX_W + 2 * PAD + 2)
+
+static const int32_t widths[] = {
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17,
+  18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 64, 127, MAX_W
+};
+#define WIDTH_CNT (sizeof(widths) / sizeof(widths[0]))
+
+// Word-aligned so that an offset of one pixel is a misaligned row
+static uint16_t dest[ROWS * STRIDE_PX] __attribute__((aligned(4)));
+static uint16_t expect[ROWS * STRIDE_PX] __attribute__((aligned(4)));
+static uint16_t src[ROWS * STRIDE_PX] __attribute__((aligned(4)));
+static lv_opa_t mask[ROWS * STRIDE_PX] __attribute__((aligned(4)));
+
+static uint32_t rng_state = 0x2545F491u;
+
+static uint32_t rng() {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static lv_color_t random_color() {
+  return lv_color_make((uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng());
+}
+
+static void fill_random(uint16_t *buf) {
+  for (uint32_t i = 0; i < ROWS * STRIDE_PX; i++) buf[i] = (uint16_t)rng();
+}
+
+// Random coverage with the runs of 0 and 255 that anti-aliased edges produce,
+// or the same value everywhere (the equal-weight pair path)
+static void fill_mask(int kind) {
+  for (uint32_t i = 0; i < ROWS * STRIDE_PX; i++) {
+    uint32_t r = rng();
+    if (kind >= 0) mask[i] = (lv_opa_t)kind;
+    else if ((r & 3) == 0) mask[i] = 0;
+    else if ((r & 3) == 1) mask[i] = 255;
+    else mask[i] = (lv_opa_t)(r >> 8);
+  }
+}
+
+// Weight LVGL's dispatcher uses for a masked pixel
+static lv_opa_t mask_weight(lv_opa_t m, lv_opa_t opa) {
+  return opa >= LV_OPA_MAX ? m : LV_OPA_MIX2(m, opa);
+}
+
+static void check(const char *kernel, int32_t w, int32_t offset, int opa) {
+  for (uint32_t i = 0; i < ROWS * STRIDE_PX; i++) {
+    if (dest[i] != expect[i]) {
+      char msg[160];
+      snprintf(msg, sizeof(msg), "%s: w %d, offset %d, opa %d: row %u px %d is %04x, expected %04x",
+               kernel, (int)w, (int)offset, opa, (unsigned)(i / STRIDE_PX),
+               (int)(i % STRIDE_PX) - PAD - (int)offset, dest[i], expect[i]);
+      TEST_FAIL_MESSAGE(msg);
+    }
+  }
+}
+
+// ===== Solid color =====
+static void run_fill(int opa, bool masked, int mask_kind) {
+  for (uint32_t wi = 0; wi < WIDTH_CNT; wi++) {
+    for (int32_t off = 0; off < 2; off++) {
+      int32_t w = widths[wi];
+      lv_color_t color = random_color();
+      uint16_t c16 = lv_color_to_u16(color);
+      fill_random(dest);
+      memcpy(expect, dest, sizeof(dest));
+      if (masked) fill_mask(mask_kind);
+
+      lv_draw_sw_blend_fill_dsc_t dsc;
+      memset(&dsc, 0, sizeof(dsc));
+      dsc.dest_buf = &dest[PAD + off];
+      dsc.dest_w = w;
+      dsc.dest_h = ROWS;
+      dsc.dest_stride = STRIDE_PX * sizeof(uint16_t);
+      dsc.color = color;
+      dsc.opa = (lv_opa_t)opa;
+      if (masked) {
+        // The mask row starts on the other alignment than the destination
+        dsc.mask_buf = &mask[PAD + (off ^ 1)];
+        dsc.mask_stride = STRIDE_PX;
+      }
+
+      for (int32_t y = 0; y < ROWS; y++) {
+        for (int32_t x = 0; x < w; x++) {
+          uint16_t *e = &expect[y * STRIDE_PX + PAD + off + x];
+          lv_opa_t weight = masked ? mask_weight(mask[y * STRIDE_PX + PAD + (off ^ 1) + x], (lv_opa_t)opa)
+                                   : (lv_opa_t)opa;
+          *e = lv_color_16_16_mix(c16, *e, weight);
+        }
+      }
+
+      const char *kernel;
+      if (masked) {
+        kernel = "color_to_rgb565_with_mask";
+        TEST_ASSERT_EQUAL(LV_RESULT_OK, blend_swar_color_to_rgb565_with_mask(&dsc));
+      } else if (opa >= LV_OPA_MAX) {
+        kernel = "color_to_rgb565";
+        TEST_ASSERT_EQUAL(LV_RESULT_OK, blend_swar_color_to_rgb565(&dsc));
+      } else {
+        kernel = "color_to_rgb565_with_opa";
+        TEST_ASSERT_EQUAL(LV_RESULT_OK, blend_swar_color_to_rgb565_with_opa(&dsc));
+      }
+      check(kernel, w, off, opa);
+    }
+  }
+}
+
+static void test_color_fill() {
+  for (int opa = 0; opa < 256; opa++) run_fill(opa, false, -1);
+}
+
+static void test_color_fill_random_mask() {
+  for (int opa = 0; opa < 256; opa++) run_fill(opa, true, -1);
+}
+
+static void test_color_fill_uniform_mask() {
+  for (int m = 0; m < 256; m++) {
+    run_fill(LV_OPA_COVER, true, m);
+    run_fill(LV_OPA_50, true, m);
+  }
+}
+
+// ===== RGB565 image =====
+static void run_image(int opa, bool masked, int mask_kind) {
+  for (uint32_t wi = 0; wi < WIDTH_CNT; wi++) {
+    for (int32_t alignment = 0; alignment < 4; alignment++) {
+      int32_t w = widths[wi];
+      int32_t off = alignment & 1;          // destination
+      int32_t src_off = alignment >> 1;     // source, independently
+      fill_random(dest);
+      fill_random(src);
+      memcpy(expect, dest, sizeof(dest));
+      if (masked) fill_mask(mask_kind);
+
+      lv_draw_sw_blend_image_dsc_t dsc;
+      memset(&dsc, 0, sizeof(dsc));
+      dsc.dest_buf = &dest[PAD + off];
+      dsc.dest_w = w;
+      dsc.dest_h = ROWS;
+      dsc.dest_stride = STRIDE_PX * sizeof(uint16_t);
+      dsc.src_buf = &src[PAD + src_off];
+      dsc.src_stride = STRIDE_PX * sizeof(uint16_t);
+      dsc.src_color_format = LV_COLOR_FORMAT_RGB565;
+      dsc.opa = (lv_opa_t)opa;
+      dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+      if (masked) {
+        dsc.mask_buf = &mask[PAD + (off ^ 1)];
+        dsc.mask_stride = STRIDE_PX;
+      }
+
+      for (int32_t y = 0; y < ROWS; y++) {
+        for (int32_t x = 0; x < w; x++) {
+          uint16_t *e = &expect[y * STRIDE_PX + PAD + off + x];
+          uint16_t s = src[y * STRIDE_PX + PAD + src_off + x];
+          lv_opa_t weight = masked ? mask_weight(mask[y * STRIDE_PX + PAD + (off ^ 1) + x], (lv_opa_t)opa)
+                                   : (lv_opa_t)opa;
+          *e = lv_color_16_16_mix(s, *e, weight);
+        }
+      }
+
+      if (masked) {
+        TEST_ASSERT_EQUAL(LV_RESULT_OK, blend_swar_rgb565_to_rgb565_with_mask(&dsc));
+        check("rgb565_to_rgb565_with_mask", w, off, opa);
+      } else {
+        TEST_ASSERT_EQUAL(LV_RESULT_OK, blend_swar_rgb565_to_rgb565_with_opa(&dsc));
+        check("rgb565_to_rgb565_with_opa", w, off, opa);
+      }
+    }
+  }
+}
+
+// LVGL copies full-opacity images itself, but the kernel is exact there too
+static void test_image_opa() {
+  for (int opa = 0; opa < 256; opa++) run_image(opa, false, -1);
+}
+
+static void test_image_random_mask() {
+  for (int opa = 0; opa < 256; opa++) run_image(opa, true, -1);
+}
+
+static void test_image_uniform_mask() {
+  for (int m = 0; m < 256; m++) {
+    run_image(LV_OPA_COVER, true, m);
+    run_image(LV_OPA_50, true, m);
+  }
+}
+
+// ===== Timings =====
+#define BAND_W    480
+#define BAND_H    40
+#define BAND_PX   (BAND_W * BAND_H)
+#define ROUNDS    200
+
+static uint16_t band_dest[BAND_PX] __attribute__((aligned(4)));
+static uint16_t band_src[BAND_PX] __attribute__((aligned(4)));
+static lv_opa_t band_mask[BAND_PX] __attribute__((aligned(4)));
+
+typedef enum { FILL_OPA, FILL_MASK, IMAGE_OPA, IMAGE_MASK } bench_kind_t;
+
+static double now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void reference(bench_kind_t kind, uint16_t c16, lv_opa_t opa) {
+  for (uint32_t i = 0; i < BAND_PX; i++) {
+    uint16_t fg = kind == FILL_OPA || kind == FILL_MASK ? c16 : band_src[i];
+    lv_opa_t weight = kind == FILL_MASK || kind == IMAGE_MASK ? mask_weight(band_mask[i], opa) : opa;
+    band_dest[i] = lv_color_16_16_mix(fg, band_dest[i], weight);
+  }
+}
+
+static void kernel(bench_kind_t kind, lv_color_t color, lv_opa_t opa) {
+  if (kind == FILL_OPA || kind == FILL_MASK) {
+    lv_draw_sw_blend_fill_dsc_t dsc;
+    memset(&dsc, 0, sizeof(dsc));
+    dsc.dest_buf = band_dest;
+    dsc.dest_w = BAND_W;
+    dsc.dest_h = BAND_H;
+    dsc.dest_stride = BAND_W * sizeof(uint16_t);
+    dsc.color = color;
+    dsc.opa = opa;
+    if (kind == FILL_MASK) {
+      dsc.mask_buf = band_mask;
+      dsc.mask_stride = BAND_W;
+      blend_swar_color_to_rgb565_with_mask(&dsc);
+    } else {
+      blend_swar_color_to_rgb565_with_opa(&dsc);
+    }
+    return;
+  }
+  lv_draw_sw_blend_image_dsc_t dsc;
+  memset(&dsc, 0, sizeof(dsc));
+  dsc.dest_buf = band_dest;
+  dsc.dest_w = BAND_W;
+  dsc.dest_h = BAND_H;
+  dsc.dest_stride = BAND_W * sizeof(uint16_t);
+  dsc.src_buf = band_src;
+  dsc.src_stride = BAND_W * sizeof(uint16_t);
+  dsc.src_color_format = LV_COLOR_FORMAT_RGB565;
+  dsc.opa = opa;
+  dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+  if (kind == IMAGE_MASK) {
+    dsc.mask_buf = band_mask;
+    dsc.mask_stride = BAND_W;
+    blend_swar_rgb565_to_rgb565_with_mask(&dsc);
+  } else {
+    blend_swar_rgb565_to_rgb565_with_opa(&dsc);
+  }
+}
+
+// ns per pixel; both paths start from the same band and must end with the same one
+static void bench(bench_kind_t kind, const char *name, lv_opa_t opa) {
+  static uint16_t start[BAND_PX], ref_out[BAND_PX];
+  lv_color_t color = random_color();
+  uint16_t c16 = lv_color_to_u16(color);
+  for (uint32_t i = 0; i < BAND_PX; i++) {
+    start[i] = (uint16_t)rng();
+    band_src[i] = (uint16_t)rng();
+    uint32_t r = rng();
+    band_mask[i] = (r & 3) == 0 ? 0 : (r & 3) == 1 ? 255 : (lv_opa_t)(r >> 8);
+  }
+
+  double ref_ns = 0, swar_ns = 0;
+  for (int r = 0; r < ROUNDS; r++) {
+    memcpy(band_dest, start, sizeof(start));
+    double t0 = now_ns();
+    reference(kind, c16, opa);
+    ref_ns += now_ns() - t0;
+    memcpy(ref_out, band_dest, sizeof(ref_out));
+
+    memcpy(band_dest, start, sizeof(start));
+    t0 = now_ns();
+    kernel(kind, color, opa);
+    swar_ns += now_ns() - t0;
+    TEST_ASSERT_EQUAL_INT(0, memcmp(band_dest, ref_out, sizeof(ref_out)));
+  }
+  ref_ns /= (double)ROUNDS * BAND_PX;
+  swar_ns /= (double)ROUNDS * BAND_PX;
+
+  char msg[120];
+  snprintf(msg, sizeof(msg), "%-27s per pixel: mix loop %5.2f ns, kernel %5.2f ns (%.1fx)", name, ref_ns, swar_ns,
+           ref_ns / swar_ns);
+  TEST_MESSAGE(msg);
+}
+
+static void test_kernel_timings() {
+  bench(FILL_OPA, "color_to_rgb565_with_opa", LV_OPA_50);
+  bench(FILL_MASK, "color_to_rgb565_with_mask", LV_OPA_COVER);
+  bench(IMAGE_OPA, "rgb565_to_rgb565_with_opa", LV_OPA_50);
+  bench(IMAGE_MASK, "rgb565_to_rgb565_with_mask", LV_OPA_COVER);
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_color_fill);
+  RUN_TEST(test_color_fill_random_mask);
+  RUN_TEST(test_color_fill_uniform_mask);
+  RUN_TEST(test_image_opa);
+  RUN_TEST(test_image_random_mask);
+  RUN_TEST(test_image_uniform_mask);
+  RUN_TEST(test_kernel_timings);
+  return UNITY_END();
+}
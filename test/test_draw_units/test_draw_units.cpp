@@ -0,0 +1,77 @@
+// test_draw_units.cpp - the "stress" screen rendered with one or two SW draw units
+//
+//   pio test -e native -f test_draw_units -v        one unit, no OS (the default build)
+//   pio test -e native_dual_core -v                 two units on pthreads (DASH_DUAL_CORE)
+//
+// draw_stress_run() redraws the stress screen (12 x 10 tiles, three draw tasks
+// each) at 480 x 320 in 40-row bands, as the "stress" serial command does.
+// Its own timing uses micros(), which the stand-in clock doesn't move, so the
+// run is timed here and includes building the screen. Reported: host us per
+// frame and a checksum of the flushed pixels, which must be the same in both
+// envs. The host times only compare the two envs on the same machine, and two
+// units can only help there with two free CPUs.
+
+#include <unity.h>
+#include <lvgl.h>
+#include <Arduino.h>
+#include <stdio.h>
+#include <string>
+#include <time.h>
+#include "draw_stress.h"
+
+#define HOR_RES   480
+#define VER_RES   320
+#define BAND_ROWS 40
+#define FRAMES    50
+
+static uint16_t band[HOR_RES * BAND_ROWS];
+static uint32_t frame_crc;
+static std::string capture;
+
+// Order-dependent checksum of everything flushed
+static void flush_cb(lv_display_t *d, const lv_area_t *area, uint8_t *px) {
+  uint32_t n = lv_area_get_size(area) * 2;
+  for (uint32_t i = 0; i < n; i++) frame_crc = frame_crc * 31 + px[i];
+  lv_display_flush_ready(d);
+}
+
+static double now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void test_stress_frames() {
+  // One run to warm up, one to time
+  draw_stress_run(1);
+  frame_crc = 0;
+  double t0 = now_us();
+  draw_stress_run(FRAMES);
+  double us = (now_us() - t0) / (FRAMES + 1);
+  TEST_ASSERT_TRUE(capture.find("stress: 120 tiles") != std::string::npos);
+
+  char msg[120];
+  snprintf(msg, sizeof(msg), "%d draw unit(s): %6.0f us per frame, checksum %08lx", LV_DRAW_SW_DRAW_UNIT_CNT, us,
+           (unsigned long)frame_crc);
+  TEST_MESSAGE(msg);
+}
+
+void setUp() {
+  lv_init();
+  disp = lv_display_create(HOR_RES, VER_RES);
+  lv_display_set_flush_cb(disp, flush_cb);
+  lv_display_set_buffers(disp, band, NULL, sizeof(band), LV_DISPLAY_RENDER_MODE_PARTIAL);
+  capture.clear();
+  Serial.capture = &capture;
+}
+
+void tearDown() {
+  Serial.capture = NULL;
+  lv_deinit();
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_stress_frames);
+  return UNITY_END();
+}
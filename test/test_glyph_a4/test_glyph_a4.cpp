@@ -0,0 +1,133 @@
+// test_glyph_a4.cpp - labels drawn with and without LV_DRAW_SW_GLYPH_A4_DIRECT's fused path
+//
+//   pio test -e native -f test_glyph_a4 -v
+//
+// The same screen of labels (a 48 px readout, 16 px label texts, one at the
+// stale opacity) is rendered at 480 x 320 in 40-row bands, once with the
+// Montserrat fonts themselves and once with copies whose get_glyph_bitmap is a
+// wrapper. draw_a4_glyph_rgb565() only takes fonts that use
+// lv_font_get_bitmap_fmt_txt() directly, so the copies go through the A8
+// unpack and lv_draw_sw_blend(). The flushed pixels must be the same.
+// Reported: host us per frame and per glyph drawn; host times only compare to
+// each other.
+
+#include <unity.h>
+#include <lvgl.h>
+#include <stdio.h>
+#include <time.h>
+
+#define HOR_RES   480
+#define VER_RES   320
+#define BAND_ROWS 40
+#define FRAMES    100
+
+static const char *const texts[] = {
+  "Range: 123 km", "Avg. con: 45 W/km", "Volt: 72.40 V", "Current: -12.50 A",
+  "Motor: 65°C", "Battery: 41°C", "SoC: 87%", "TRIP: 1234 km", "ODO: 123456 km",
+  "Avg. SPEED: 42 km/h",
+};
+
+#define TEXT_CNT (sizeof(texts) / sizeof(texts[0]))
+
+static uint16_t band[HOR_RES * BAND_ROWS];
+static lv_display_t *display;
+static uint32_t frame_crc;
+static lv_font_t unpack_48, unpack_16;
+
+// Order-dependent checksum of everything flushed
+static void flush_cb(lv_display_t *d, const lv_area_t *area, uint8_t *px) {
+  uint32_t n = lv_area_get_size(area) * 2;
+  for (uint32_t i = 0; i < n; i++) frame_crc = frame_crc * 31 + px[i];
+  lv_display_flush_ready(d);
+}
+
+static const void *unpack_bitmap(lv_font_glyph_dsc_t *g, lv_draw_buf_t *draw_buf) {
+  return lv_font_get_bitmap_fmt_txt(g, draw_buf);
+}
+
+static double now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// UTF-8 characters other than spaces
+static uint32_t glyphs_of(const char *txt) {
+  uint32_t n = 0;
+  for (; *txt; txt++) {
+    if (*txt != ' ' && (*txt & 0xC0) != 0x80) n++;
+  }
+  return n;
+}
+
+// us per frame; *glyphs is the number of glyphs on the screen
+static double run(const lv_font_t *big, const lv_font_t *small, uint32_t *crc, uint32_t *glyphs) {
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(scr, lv_color_white(), 0);
+  lv_screen_load(scr);
+
+  const char *readout = "188 0123456789";
+  lv_obj_t *speed = lv_label_create(scr);
+  lv_obj_set_style_text_font(speed, big, 0);
+  lv_label_set_text_static(speed, readout);
+  lv_obj_align(speed, LV_ALIGN_TOP_MID, 0, 4);
+  *glyphs = glyphs_of(readout);
+
+  for (uint32_t i = 0; i < TEXT_CNT; i++) {
+    lv_obj_t *l = lv_label_create(scr);
+    lv_obj_set_style_text_font(l, small, 0);
+    lv_obj_set_style_text_color(l, lv_color_hex(i & 1 ? 0x0088ff : 0x000000), 0);
+    if (i == 3) lv_obj_set_style_text_opa(l, LV_OPA_40, 0);
+    lv_label_set_text_static(l, texts[i]);
+    lv_obj_set_pos(l, i < 5 ? 10 : 250, 80 + (i % 5) * 45);
+    *glyphs += glyphs_of(texts[i]);
+  }
+  lv_refr_now(display);
+
+  frame_crc = 0;
+  double t0 = now_us();
+  for (int f = 0; f < FRAMES; f++) {
+    lv_obj_invalidate(scr);
+    lv_refr_now(display);
+  }
+  double us = (now_us() - t0) / FRAMES;
+  *crc = frame_crc;
+  lv_obj_delete(scr);
+  return us;
+}
+
+static void test_direct_against_unpack() {
+  uint32_t crc_unpack, crc_direct, glyphs;
+  double unpack = run(&unpack_48, &unpack_16, &crc_unpack, &glyphs);
+  double direct = run(&lv_font_montserrat_48, &lv_font_montserrat_16, &crc_direct, &glyphs);
+  TEST_ASSERT_EQUAL_UINT32(crc_unpack, crc_direct);
+
+  char msg[120];
+  snprintf(msg, sizeof(msg), "unpack + blend: %6.0f us per frame, %5.2f us per glyph", unpack, unpack / glyphs);
+  TEST_MESSAGE(msg);
+  snprintf(msg, sizeof(msg), "A4 direct:      %6.0f us per frame, %5.2f us per glyph", direct, direct / glyphs);
+  TEST_MESSAGE(msg);
+  snprintf(msg, sizeof(msg), "%u glyphs per frame, background fill included", (unsigned)glyphs);
+  TEST_MESSAGE(msg);
+}
+
+void setUp() {
+  lv_init();
+  display = lv_display_create(HOR_RES, VER_RES);
+  lv_display_set_flush_cb(display, flush_cb);
+  lv_display_set_buffers(display, band, NULL, sizeof(band), LV_DISPLAY_RENDER_MODE_PARTIAL);
+  unpack_48 = lv_font_montserrat_48;
+  unpack_48.get_glyph_bitmap = unpack_bitmap;
+  unpack_16 = lv_font_montserrat_16;
+  unpack_16.get_glyph_bitmap = unpack_bitmap;
+}
+
+void tearDown() {
+  lv_deinit();
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_direct_against_unpack);
+  return UNITY_END();
+}
@@ -0,0 +1,306 @@
+// test_map_replay.cpp - the map screen following a track, with and without prefetch
+//
+//   pio test -e native -f test_map_replay -v
+//
+// A 14 minute drive at 50 km/h (five straight legs, 1 position per second) is
+// fed to the map screen the way rs485.cpp and loop() do: dashData and
+// map_screen_position_changed(), a refresh, map_screen_poll() right after it
+// with LVGL busy, then IDLE_POLLS polls and refreshes in the rest of the second.
+// The pack is built here at zoom 16 (RLE tiles, every 7th raw) and read through
+// the SD card model in test/native. Without prefetch the idle polls pass 0 ms,
+// so only visible misses are read. Reported: the miss rate of tiles coming into
+// view (the map.* counters), card time per tile load (20 MHz SPI, ~100 us per
+// read command, ~10 us per File::read() call) and host time per refresh, which
+// only compares the two runs.
+
+#include <unity.h>
+#include <lvgl.h>
+#include <SD.h>
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+#include <vector>
+#include "map_screen.h"
+#include "map_tiles.h"
+#include "metrics.h"
+
+#define HOR_RES     480
+#define VER_RES     320
+#define BAND_ROWS   40
+#define ZOOM        16
+#define IDLE_POLLS  10
+#define SPEED_KMH   50
+#define START_LAT   51.50
+#define START_LON   -0.10
+#define MARGIN      4              // tiles around the track's bounding box
+
+typedef struct {
+  int heading;
+  int seconds;
+} leg_t;
+
+static const leg_t legs[] = { { 90, 180 }, { 135, 120 }, { 180, 150 }, { 270, 210 }, { 0, 180 } };
+
+typedef struct {
+  int32_t lat_e7, lon_e7;
+  int heading;
+} fix_t;
+
+typedef struct {
+  uint32_t hits, misses, loads, prefetch_hits;
+  sd_card_stats_t card;
+  double refresh_us;
+  uint32_t refreshes;
+} result_t;
+
+static uint32_t tick;
+static uint16_t band[HOR_RES * BAND_ROWS];
+static lv_display_t *display;
+static unsigned long flushed_px;
+static std::vector<fix_t> track;
+static std::vector<uint8_t> pack;
+static int32_t pack_x0, pack_y0;
+
+static uint32_t tick_cb() {
+  return tick;
+}
+
+static void flush_cb(lv_display_t *d, const lv_area_t *area, uint8_t *) {
+  flushed_px += lv_area_get_size(area);
+  lv_display_flush_ready(d);
+}
+
+static double now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// ===== Track and pack =====
+static void make_track() {
+  double lat = START_LAT, lon = START_LON;
+  const double m_per_s = SPEED_KMH / 3.6;
+  for (const leg_t &l : legs) {
+    double h = l.heading * M_PI / 180;
+    for (int s = 0; s < l.seconds; s++) {
+      lat += m_per_s * cos(h) / 111320;
+      lon += m_per_s * sin(h) / (111320 * cos(lat * M_PI / 180));
+      track.push_back({ (int32_t)lround(lat * 1e7), (int32_t)lround(lon * 1e7), l.heading });
+    }
+  }
+}
+
+// Tile of a position at ZOOM, as map_screen.cpp projects it
+static void tile_of(const fix_t &f, int32_t *tx, int32_t *ty) {
+  double lat = f.lat_e7 * 1e-7 * M_PI / 180;
+  double mx = (f.lon_e7 * 1e-7 + 180) / 360;
+  double my = (1 - log(tan(lat) + 1 / cos(lat)) / M_PI) / 2;
+  *tx = (int32_t)(mx * (256.0 * (1UL << ZOOM))) >> 6;
+  *ty = (int32_t)(my * (256.0 * (1UL << ZOOM))) >> 6;
+}
+
+// Each row: four 12 px runs and a 16 px literal, like road and area fills
+static void tile_pixels(int32_t tx, int32_t ty, uint16_t *px) {
+  for (int r = 0; r < MAP_TILE_SIZE; r++) {
+    for (int c = 0; c < MAP_TILE_SIZE; c++) {
+      uint32_t k = c < 48 ? c / 12 : c;
+      px[r * MAP_TILE_SIZE + c] = (uint16_t)((tx * 7919 + ty * 104729 + (r / 8) * 31 + k * 977) * 2654435761u >> 16);
+    }
+  }
+}
+
+static void rle_encode(const uint16_t *px, std::vector<uint8_t> &out) {
+  const uint32_t n = MAP_TILE_SIZE * MAP_TILE_SIZE;
+  uint32_t i = 0;
+  while (i < n) {
+    uint32_t run = 1;
+    while (i + run < n && run < 128 && px[i + run] == px[i]) run++;
+    if (run >= 2) {
+      out.push_back(0x80 | (run - 1));
+      out.push_back(px[i] & 0xFF);
+      out.push_back(px[i] >> 8);
+      i += run;
+      continue;
+    }
+    uint32_t lit = 1;
+    while (i + lit < n && lit < 128 && !(i + lit + 1 < n && px[i + lit] == px[i + lit + 1])) lit++;
+    out.push_back(lit - 1);
+    for (uint32_t j = 0; j < lit; j++) {
+      out.push_back(px[i + j] & 0xFF);
+      out.push_back(px[i + j] >> 8);
+    }
+    i += lit;
+  }
+}
+
+static void put32(std::vector<uint8_t> &v, size_t at, uint32_t x) {
+  for (int b = 0; b < 4; b++) v[at + b] = x >> (8 * b);
+}
+
+static void make_pack() {
+  int32_t x1 = INT32_MAX, y1 = INT32_MAX, x2 = INT32_MIN, y2 = INT32_MIN;
+  for (const fix_t &f : track) {
+    int32_t tx, ty;
+    tile_of(f, &tx, &ty);
+    x1 = LV_MIN(x1, tx);
+    y1 = LV_MIN(y1, ty);
+    x2 = LV_MAX(x2, tx);
+    y2 = LV_MAX(y2, ty);
+  }
+  pack_x0 = x1 - MARGIN;
+  pack_y0 = y1 - MARGIN;
+  uint16_t cols = x2 - x1 + 1 + 2 * MARGIN, rows = y2 - y1 + 1 + 2 * MARGIN;
+  uint32_t cnt = (uint32_t)cols * rows;
+
+  // Header, one zoom, the directory, then the tiles
+  const uint8_t header[8] = { 'D', 'M', 'A', 'P', 1, 1, MAP_TILE_SIZE, 0 };
+  pack.assign(header, header + 8);
+  pack.resize(8 + 20 + 8 * cnt);
+  pack[8] = ZOOM;
+  put32(pack, 12, pack_x0);
+  put32(pack, 16, pack_y0);
+  pack[20] = cols & 0xFF;
+  pack[21] = cols >> 8;
+  pack[22] = rows & 0xFF;
+  pack[23] = rows >> 8;
+  put32(pack, 24, 0);
+
+  static uint16_t px[MAP_TILE_SIZE * MAP_TILE_SIZE];
+  std::vector<uint8_t> data;
+  for (uint32_t i = 0; i < cnt; i++) {
+    tile_pixels(pack_x0 + i % cols, pack_y0 + i / cols, px);
+    size_t entry = 28 + 8 * i, start = pack.size();
+    bool raw = i % 7 == 0;
+    if (raw) {
+      pack.insert(pack.end(), (uint8_t *)px, (uint8_t *)px + MAP_TILE_BYTES);
+    } else {
+      data.clear();
+      rle_encode(px, data);
+      pack.insert(pack.end(), data.begin(), data.end());
+    }
+    uint32_t size = pack.size() - start;
+    put32(pack, entry, start);
+    pack[entry + 4] = size & 0xFF;
+    pack[entry + 5] = size >> 8;
+    pack[entry + 6] = raw ? MAP_TILE_RAW : MAP_TILE_RLE;
+  }
+  sd_card_add_file(MAP_TILE_PACK, pack.data(), pack.size());
+}
+
+// ===== Replay =====
+static lv_obj_t *build_blank() {
+  return lv_obj_create(NULL);
+}
+
+static const screen_desc_t blank_desc = { "dashboard", build_blank, NULL, NULL, 0, 0, SCREEN_COUNT, true };
+
+static void set_fix(const fix_t &f) {
+  dashData.latitude = f.lat_e7;
+  dashData.longitude = f.lon_e7;
+  dashData.heading = f.heading;
+}
+
+static void refresh(result_t *r) {
+  flushed_px = 0;
+  double t0 = now_us();
+  lv_refr_now(display);
+  double t = now_us() - t0;
+  if (flushed_px) {
+    r->refresh_us += t;
+    r->refreshes++;
+  }
+}
+
+static result_t replay(bool prefetch) {
+  result_t r;
+  memset(&r, 0, sizeof(r));
+  uint32_t hits = metrics_get(MET_MAP_TILE_HITS), misses = metrics_get(MET_MAP_TILE_MISSES);
+  uint32_t loads = metrics_get(MET_MAP_TILE_LOADS), prefetch_hits = metrics_get(MET_MAP_PREFETCH_HITS);
+  memset(&sd_card, 0, sizeof(sd_card));
+
+  set_fix(track[0]);
+  TEST_ASSERT_TRUE(screen_mgr_show(SCREEN_MAP));
+  refresh(&r);
+  for (const fix_t &f : track) {
+    set_fix(f);
+    map_screen_position_changed();
+    refresh(&r);
+    map_screen_poll(0);
+    refresh(&r);
+    for (int i = 0; i < IDLE_POLLS; i++) {
+      tick += 1000 / (IDLE_POLLS + 1);
+      map_screen_poll(prefetch ? MAP_SCREEN_LOAD_MS : 0);
+      refresh(&r);
+    }
+    tick += 1000 / (IDLE_POLLS + 1);
+  }
+
+  // The decoded tile under the vehicle is the one in the pack
+  int32_t tx, ty;
+  tile_of(track.back(), &tx, &ty);
+  const lv_image_dsc_t *img = map_tiles_get(map_tiles_index(ZOOM, tx, ty));
+  TEST_ASSERT_NOT_NULL(img);
+  static uint16_t px[MAP_TILE_SIZE * MAP_TILE_SIZE];
+  tile_pixels(tx, ty, px);
+  TEST_ASSERT_EQUAL_INT(0, memcmp(img->data, px, MAP_TILE_BYTES));
+
+  r.hits = metrics_get(MET_MAP_TILE_HITS) - hits;
+  r.misses = metrics_get(MET_MAP_TILE_MISSES) - misses;
+  r.loads = metrics_get(MET_MAP_TILE_LOADS) - loads;
+  r.prefetch_hits = metrics_get(MET_MAP_PREFETCH_HITS) - prefetch_hits;
+  r.card = sd_card;
+
+  screen_mgr_back();
+  screen_mgr_drop(SCREEN_MAP);     // frees the tile cache: the next run starts cold
+
+  double card_us = r.card.sectors * SD_CARD_SECTOR * 8 / 20.0 + r.card.commands * 100.0 + r.card.reads * 10.0;
+  char msg[200];
+  snprintf(msg, sizeof(msg),
+           "%-11s %3lu of %4lu tiles into view missed (%4.1f%%), %4lu loads, %3lu prefetch hits, "
+           "~%4.1f ms card time per load, %5.0f us per refresh",
+           prefetch ? "prefetch:" : "no prefetch:", (unsigned long)r.misses, (unsigned long)(r.hits + r.misses),
+           100.0 * r.misses / (r.hits + r.misses), (unsigned long)r.loads, (unsigned long)r.prefetch_hits,
+           card_us / r.loads / 1000, r.refresh_us / r.refreshes);
+  TEST_MESSAGE(msg);
+  return r;
+}
+
+static void test_replay() {
+  result_t none = replay(false);
+  result_t ahead = replay(true);
+
+  TEST_ASSERT_EQUAL_UINT32(0, none.prefetch_hits);
+  TEST_ASSERT_TRUE(ahead.prefetch_hits > 0);
+  TEST_ASSERT_EQUAL_UINT32(none.hits + none.misses, ahead.hits + ahead.misses);
+  TEST_ASSERT_TRUE(ahead.misses < none.misses);
+
+  char msg[120];
+  snprintf(msg, sizeof(msg), "%u positions, pack %lu KB", (unsigned)track.size(), (unsigned long)(pack.size() / 1024));
+  TEST_MESSAGE(msg);
+}
+
+void setUp() {
+  lv_init();
+  lv_tick_set_cb(tick_cb);
+  display = lv_display_create(HOR_RES, VER_RES);
+  lv_display_set_flush_cb(display, flush_cb);
+  lv_display_set_buffers(display, band, NULL, sizeof(band), LV_DISPLAY_RENDER_MODE_PARTIAL);
+
+  if (track.empty()) {
+    make_track();
+    make_pack();
+  }
+  screen_mgr_register(SCREEN_DASHBOARD, &blank_desc);
+  screen_mgr_register(SCREEN_MAP, &map_screen_desc);
+  TEST_ASSERT_TRUE(screen_mgr_show(SCREEN_DASHBOARD));
+}
+
+void tearDown() {
+  lv_deinit();
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_replay);
+  return UNITY_END();
+}
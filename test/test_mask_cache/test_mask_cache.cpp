@@ -0,0 +1,184 @@
+// test_mask_cache.cpp - shadow and rounded-corner masks with and without LV_DRAW_SW_MASK_CACHE_SIZE
+//
+//   pio test -e native -f test_mask_cache -v
+//
+// The cache is switched off and on at run time with lv_draw_sw_mask_cache_resize()
+// (a budget of 0 caches nothing, as LV_DRAW_SW_MASK_CACHE_SIZE 0 would; the
+// single-entry shadow cache is off in lv_conf.h either way). 300 random scenes
+// of shadowed and clip-corner objects must flush the same pixels uncached, on a
+// cold cache and on a warm one. Then single objects (their area only) and a
+// dashboard-like scene (the whole screen) are redrawn at 480 x 320 in 40-row
+// bands. Reported: host us per redraw and the cache's hits and misses; host
+// times only compare to each other.
+
+#include <unity.h>
+#include <lvgl.h>
+#include <src/draw/sw/lv_draw_sw_mask_cache.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define HOR_RES   480
+#define VER_RES   320
+#define BAND_ROWS 40
+#define SCENES    300
+#define REDRAWS   500
+
+static uint16_t band[HOR_RES * BAND_ROWS];
+static lv_display_t *display;
+static uint32_t frame_crc;
+
+// Order-dependent checksum of everything flushed
+static void flush_cb(lv_display_t *d, const lv_area_t *area, uint8_t *px) {
+  uint32_t n = lv_area_get_size(area) * 2;
+  for (uint32_t i = 0; i < n; i++) frame_crc = frame_crc * 31 + px[i];
+  lv_display_flush_ready(d);
+}
+
+static double now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static uint32_t redraw(lv_obj_t *obj) {
+  frame_crc = 0;
+  lv_obj_invalidate(obj);
+  lv_refr_now(display);
+  return frame_crc;
+}
+
+static lv_obj_t *new_screen() {
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(scr, lv_color_hex(0xe5e5e5), 0);
+  lv_screen_load(scr);
+  return scr;
+}
+
+static lv_obj_t *shadowed(lv_obj_t *parent, int32_t w, int32_t h, int32_t radius, int32_t shadow_w, int32_t spread) {
+  lv_obj_t *obj = lv_obj_create(parent);
+  lv_obj_remove_style_all(obj);
+  lv_obj_set_size(obj, w, h);
+  lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
+  lv_obj_set_style_bg_color(obj, lv_color_white(), 0);
+  lv_obj_set_style_radius(obj, radius, 0);
+  lv_obj_set_style_shadow_width(obj, shadow_w, 0);
+  lv_obj_set_style_shadow_spread(obj, spread, 0);
+  lv_obj_set_style_shadow_opa(obj, LV_OPA_50, 0);
+  return obj;
+}
+
+// A rounded container clipping a child that fills it: a clip-corner layer
+static lv_obj_t *clip_corner(lv_obj_t *parent, int32_t w, int32_t h, int32_t radius) {
+  lv_obj_t *box = lv_obj_create(parent);
+  lv_obj_remove_style_all(box);
+  lv_obj_set_size(box, w, h);
+  lv_obj_set_style_radius(box, radius, 0);
+  lv_obj_set_style_clip_corner(box, true, 0);
+  lv_obj_t *fill = lv_obj_create(box);
+  lv_obj_remove_style_all(fill);
+  lv_obj_set_size(fill, w, h);
+  lv_obj_set_style_bg_opa(fill, LV_OPA_COVER, 0);
+  lv_obj_set_style_bg_grad_color(fill, lv_color_hex(0x0060ff), 0);
+  lv_obj_set_style_bg_grad_dir(fill, LV_GRAD_DIR_VER, 0);
+  lv_obj_set_style_bg_color(fill, lv_color_hex(0x00cc00), 0);
+  return box;
+}
+
+static void test_same_output() {
+  srand(39);
+  for (int s = 0; s < SCENES; s++) {
+    lv_obj_t *scr = new_screen();
+    int n = 1 + rand() % 4;
+    for (int i = 0; i < n; i++) {
+      int32_t w = 8 + rand() % 160, h = 8 + rand() % 120;
+      lv_obj_t *obj = rand() % 3 == 0 ? clip_corner(scr, w, h, rand() % 40)
+                                       : shadowed(scr, w, h, rand() % 40, rand() % 40, rand() % 8 - 2);
+      lv_obj_set_pos(obj, rand() % (HOR_RES - 100), rand() % (VER_RES - 80));
+    }
+
+    lv_draw_sw_mask_cache_resize(0, true);
+    uint32_t off = redraw(scr);
+    lv_draw_sw_mask_cache_resize(LV_DRAW_SW_MASK_CACHE_SIZE, true);
+    uint32_t cold = redraw(scr);
+    uint32_t warm = redraw(scr);
+    TEST_ASSERT_EQUAL_UINT32(off, cold);
+    TEST_ASSERT_EQUAL_UINT32(off, warm);
+    lv_obj_delete(scr);
+  }
+}
+
+// us per redraw of `obj` (its shadow included) with the given budget
+static double time_redraws(lv_obj_t *obj, uint32_t budget, lv_draw_sw_mask_cache_stats_t *stats) {
+  lv_draw_sw_mask_cache_resize(budget, true);
+  redraw(obj);
+  lv_draw_sw_mask_cache_reset_stats();
+  double t0 = now_us();
+  for (int r = 0; r < REDRAWS; r++) redraw(obj);
+  double us = (now_us() - t0) / REDRAWS;
+  lv_draw_sw_mask_cache_get_stats(stats);
+  return us;
+}
+
+static void report(lv_obj_t *obj, const char *name) {
+  lv_draw_sw_mask_cache_stats_t off_stats, on_stats;
+  double off = time_redraws(obj, 0, &off_stats);
+  double on = time_redraws(obj, LV_DRAW_SW_MASK_CACHE_SIZE, &on_stats);
+  TEST_ASSERT_EQUAL_UINT32(0, off_stats.hits);
+
+  char msg[160];
+  snprintf(msg, sizeof(msg), "%-34s off %7.1f us, on %7.1f us per redraw (%lu hits, %lu misses)", name, off, on,
+           (unsigned long)on_stats.hits, (unsigned long)on_stats.misses);
+  TEST_MESSAGE(msg);
+}
+
+static void test_timings() {
+  const int32_t widths[] = { 20, 4, 2 };
+  for (int32_t sw : widths) {
+    lv_obj_t *scr = new_screen();
+    lv_obj_t *obj = shadowed(scr, 100, 60, 10, sw, 0);
+    lv_obj_center(obj);
+    char name[48];
+    snprintf(name, sizeof(name), "100x60 r10, shadow width %d", (int)sw);
+    report(obj, name);
+    lv_obj_delete(scr);
+  }
+
+  lv_obj_t *scr = new_screen();
+  lv_obj_t *box = clip_corner(scr, 100, 60, 10);
+  lv_obj_center(box);
+  report(box, "100x60 r10 clip corner");
+  lv_obj_delete(scr);
+
+  // Default theme buttons and a rounded container clipping its content
+  scr = new_screen();
+  for (int i = 0; i < 4; i++) {
+    lv_obj_t *btn = lv_button_create(scr);
+    lv_obj_set_size(btn, 100, 50);
+    lv_obj_set_pos(btn, 10 + i * 115, 250);
+    lv_obj_t *label = lv_label_create(btn);
+    lv_label_set_text(label, "Menu");
+    lv_obj_center(label);
+  }
+  lv_obj_set_pos(clip_corner(scr, 200, 120, 12), 140, 60);
+  report(scr, "4 buttons and a clip-corner box");
+  lv_obj_delete(scr);
+}
+
+void setUp() {
+  lv_init();
+  display = lv_display_create(HOR_RES, VER_RES);
+  lv_display_set_flush_cb(display, flush_cb);
+  lv_display_set_buffers(display, band, NULL, sizeof(band), LV_DISPLAY_RENDER_MODE_PARTIAL);
+}
+
+void tearDown() {
+  lv_deinit();
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_same_output);
+  RUN_TEST(test_timings);
+  return UNITY_END();
+}
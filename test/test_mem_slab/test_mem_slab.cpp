@@ -0,0 +1,141 @@
+// test_mem_slab.cpp - heap soak: label text churn and popups on the builtin heap
+//
+//   pio test -e native -f test_mem_slab -v
+//   PLATFORMIO_BUILD_FLAGS="-D LV_MEM_SLAB_SIZE=0" pio test -e native -f test_mem_slab -v
+//
+// The second run is the TLSF-only baseline. Labels get texts of varying length,
+// like the status strings and formatted readouts, and a popup with a few labels
+// comes and goes every 50 updates; LVGL renders every 4th update. The largest
+// free block is sampled every 1000 updates. This is a 64-bit build: its
+// structures are larger than on the ESP32, so the sizes only compare to each
+// other, not to the target.
+
+#include <unity.h>
+#include <lvgl.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ITERATIONS   200000
+#define SAMPLE_EVERY 1000
+#define LABELS       12
+#define HOR_RES      480
+#define VER_RES      320
+
+static uint32_t tick;
+static uint16_t frame[HOR_RES * VER_RES];
+
+static uint32_t tick_cb() {
+  return tick;
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *, uint8_t *) {
+  lv_display_flush_ready(disp);
+}
+
+static const char *const prefixes[] = { "Volt:", "Range", "Status: ARMED", "Mode: Sport", "Trip total distance" };
+
+static void set_random_text(lv_obj_t *label) {
+  char buf[96];
+  int n = snprintf(buf, sizeof(buf), "%s %d", prefixes[rand() % 5], rand() % (1 + rand() % 100000));
+  if (rand() % 4 == 0) {
+    for (int k = rand() % 40; k > 0 && n < 90; k--) buf[n++] = '.';
+    buf[n] = '\0';
+  }
+  lv_label_set_text(label, buf);
+}
+
+static lv_obj_t *popup_create(lv_obj_t *scr) {
+  lv_obj_t *popup = lv_obj_create(scr);
+  lv_obj_set_size(popup, 200 + rand() % 80, 100);
+  lv_obj_center(popup);
+  for (int k = rand() % 6 + 1; k > 0; k--) {
+    lv_obj_t *l = lv_label_create(popup);
+    lv_label_set_text_fmt(l, "Alarm %d: cell %d", k, rand());
+    lv_obj_set_y(l, k * 14);
+  }
+  return popup;
+}
+
+static void test_soak_keeps_largest_free_block() {
+  lv_init();
+  lv_tick_set_cb(tick_cb);
+  lv_display_t *disp = lv_display_create(HOR_RES, VER_RES);
+  lv_display_set_flush_cb(disp, flush_cb);
+  lv_display_set_buffers(disp, frame, NULL, sizeof(frame), LV_DISPLAY_RENDER_MODE_DIRECT);
+
+  lv_obj_t *scr = lv_screen_active();
+  lv_obj_t *labels[LABELS];
+  for (int i = 0; i < LABELS; i++) {
+    labels[i] = lv_label_create(scr);
+    lv_obj_set_pos(labels[i], (i % 3) * 160 + 5, (i / 3) * 70 + 10);
+    lv_obj_set_style_text_font(labels[i], i == 0 ? &lv_font_montserrat_48 : &lv_font_montserrat_16, 0);
+  }
+  lv_obj_t *popup = NULL;
+  srand(7);
+
+  // Worst (smallest) largest free block in the first and the last fifth of the run
+  size_t first_worst = (size_t)-1, last_worst = (size_t)-1, worst = (size_t)-1;
+  lv_mem_monitor_t mon;
+  char msg[160];
+
+  for (long it = 1; it <= ITERATIONS; it++) {
+    set_random_text(labels[rand() % LABELS]);
+    if (it % 50 == 0) {
+      if (popup) {
+        lv_obj_delete(popup);
+        popup = NULL;
+      } else {
+        popup = popup_create(scr);
+      }
+    }
+    tick += 5;
+    if (it % 4 == 0) lv_timer_handler();
+
+    if (it % SAMPLE_EVERY == 0) {
+      lv_mem_monitor(&mon);
+      worst = LV_MIN(worst, mon.free_biggest_size);
+      if (it <= ITERATIONS / 5) first_worst = LV_MIN(first_worst, mon.free_biggest_size);
+      if (it > ITERATIONS - ITERATIONS / 5) last_worst = LV_MIN(last_worst, mon.free_biggest_size);
+      if (it % (ITERATIONS / 5) == 0) {
+        snprintf(msg, sizeof(msg), "%7ld updates: free %6zu, largest block %6zu (worst %6zu), frag %2u%%, max used %zu",
+                 it, mon.free_size, mon.free_biggest_size, worst, mon.frag_pct, mon.max_used);
+        TEST_MESSAGE(msg);
+      }
+    }
+  }
+
+#if LV_MEM_SLAB_SIZE
+  lv_mem_slab_stats_t s;
+  lv_mem_slab_get_stats(&s);
+  snprintf(msg, sizeof(msg), "slab: %u of %u pages (max %u), %zu B free in owned pages",
+           s.page_used, s.page_cnt, s.page_used_max, s.free_size);
+  TEST_MESSAGE(msg);
+  for (int c = 0; c < LV_MEM_SLAB_CLASS_CNT; c++) {
+    snprintf(msg, sizeof(msg), "  %3u B: %2u pages, %4u used (max %4u), %8u allocs, %u to TLSF",
+             s.cls[c].slot_size, s.cls[c].page_cnt, s.cls[c].used_cnt, s.cls[c].used_max,
+             s.cls[c].alloc_cnt, s.cls[c].fallback_cnt);
+    TEST_MESSAGE(msg);
+  }
+  TEST_ASSERT_TRUE(s.page_used_max <= s.page_cnt);
+  // With the slab the small blocks stop carving up TLSF: no drift over the run
+  TEST_ASSERT_TRUE(last_worst >= first_worst);
+#endif
+  snprintf(msg, sizeof(msg), "largest free block: worst %zu in the first fifth, %zu in the last",
+           first_worst, last_worst);
+  TEST_MESSAGE(msg);
+
+  TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_mem_test());
+  lv_deinit();
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_soak_keeps_largest_free_block);
+  return UNITY_END();
+}
@@ -0,0 +1,187 @@
+// test_num_label.cpp - num_label against content-sized lv_labels on the dashboard readouts
+//
+//   pio test -e native -f test_num_label -v
+//
+// Six readouts of ui.cpp's field table (speed, range, consumption, voltage,
+// current, SoC) take 500 random telemetry steps, a refresh after each, once as
+// lv_labels formatted with snprintf (the dashboard before num_label) and once as
+// num_labels. Reported per update: pixels flushed and how often a readout's
+// size or position changed. The speed uses the 48 px Montserrat instead of the
+// dashboard's 78 px font.
+
+#include <unity.h>
+#include <lvgl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "num_label.h"
+
+#define HOR_RES   480
+#define VER_RES   320
+#define BAND_ROWS 40
+#define STEPS     500
+
+typedef struct {
+  const lv_font_t *font;
+  lv_align_t align;
+  int16_t x, y;
+  const char *prefix, *suffix;
+  int32_t min, max;
+  uint8_t decimals;
+  int32_t step;              // largest change per telemetry step
+} readout_t;
+
+// As in ui.cpp
+static const readout_t readouts[] = {
+  { &lv_font_montserrat_48, LV_ALIGN_CENTER,   -24, -40, NULL,         NULL,    0,      199,   0, 7 },
+  { &lv_font_montserrat_16, LV_ALIGN_LEFT_MID, 10,  -60, "Range: ",    " km",   0,      999,   0, 3 },
+  { &lv_font_montserrat_16, LV_ALIGN_LEFT_MID, 10,  -20, "Avg. con: ", " W/km", 0,      999,   0, 9 },
+  { &lv_font_montserrat_16, LV_ALIGN_LEFT_MID, 10,  60,  "Volt: ",     " V",    0,      9999,  2, 40 },
+  { &lv_font_montserrat_16, LV_ALIGN_LEFT_MID, 10,  90,  "Current: ",  " A",    -99999, 99999, 2, 1500 },
+  { &lv_font_montserrat_16, LV_ALIGN_RIGHT_MID, -10, 60, "SoC: ",      "%",     0,      100,   0, 1 },
+};
+
+#define READOUT_CNT (sizeof(readouts) / sizeof(readouts[0]))
+
+typedef struct {
+  double px_per_update;
+  uint32_t geometry_changes;
+} result_t;
+
+static uint32_t tick;
+static uint16_t band[HOR_RES * BAND_ROWS];
+static lv_display_t *display;
+static unsigned long flushed_px;
+
+static uint32_t tick_cb() {
+  return tick;
+}
+
+static void flush_cb(lv_display_t *d, const lv_area_t *area, uint8_t *) {
+  flushed_px += lv_area_get_size(area);
+  lv_display_flush_ready(d);
+}
+
+static void set_label(lv_obj_t *obj, const readout_t *r, int32_t v) {
+  char buf[48];
+  if (r->decimals) {
+    snprintf(buf, sizeof(buf), "%s%.2f%s", r->prefix, v / 100.0, r->suffix);
+  } else {
+    snprintf(buf, sizeof(buf), "%s%d%s", r->prefix ? r->prefix : "", (int)v, r->suffix ? r->suffix : "");
+  }
+  lv_label_set_text(obj, buf);
+}
+
+static result_t run(bool use_num_label) {
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_screen_load(scr);
+
+  lv_obj_t *objs[READOUT_CNT];
+  int32_t values[READOUT_CNT];
+  for (uint32_t i = 0; i < READOUT_CNT; i++) {
+    const readout_t *r = &readouts[i];
+    values[i] = LV_CLAMP(r->min, (r->min + r->max) / 2, r->max);
+    if (use_num_label) {
+      objs[i] = num_label_create(scr, r->min, r->max, r->decimals);
+      lv_obj_set_style_text_font(objs[i], r->font, 0);
+      if (r->prefix || r->suffix) num_label_set_text(objs[i], r->prefix, r->suffix);
+      num_label_set_value(objs[i], values[i]);
+    } else {
+      objs[i] = lv_label_create(scr);
+      lv_obj_set_style_text_font(objs[i], r->font, 0);
+      set_label(objs[i], r, values[i]);
+    }
+    lv_obj_align(objs[i], r->align, r->x, r->y);
+  }
+  lv_refr_now(display);
+
+  srand(5);
+  result_t res = { 0, 0 };
+  flushed_px = 0;
+  for (int s = 0; s < STEPS; s++) {
+    uint32_t i = rand() % READOUT_CNT;
+    const readout_t *r = &readouts[i];
+    values[i] = LV_CLAMP(r->min, values[i] + rand() % (2 * r->step + 1) - r->step, r->max);
+
+    lv_area_t before;
+    lv_obj_get_coords(objs[i], &before);
+    if (use_num_label) num_label_set_value(objs[i], values[i]);
+    else set_label(objs[i], r, values[i]);
+    tick += 100;
+    lv_refr_now(display);
+
+    lv_area_t after;
+    lv_obj_get_coords(objs[i], &after);
+    if (memcmp(&before, &after, sizeof(lv_area_t)) != 0) res.geometry_changes++;
+  }
+  res.px_per_update = (double)flushed_px / STEPS;
+
+  lv_obj_delete(scr);
+  return res;
+}
+
+static void test_against_lv_label() {
+  result_t label = run(false);
+  result_t num = run(true);
+
+  char msg[120];
+  snprintf(msg, sizeof(msg), "lv_label:  %5.0f px flushed per update, geometry changed on %3u of %u updates",
+           label.px_per_update, (unsigned)label.geometry_changes, STEPS);
+  TEST_MESSAGE(msg);
+  snprintf(msg, sizeof(msg), "num_label: %5.0f px flushed per update, geometry changed on %3u of %u updates",
+           num.px_per_update, (unsigned)num.geometry_changes, STEPS);
+  TEST_MESSAGE(msg);
+
+  TEST_ASSERT_EQUAL_UINT32(0, num.geometry_changes);
+  TEST_ASSERT_TRUE(num.px_per_update < label.px_per_update);
+}
+
+// Only the font and the letter space change the geometry
+static void test_style_changes() {
+  lv_obj_t *nl = num_label_create(lv_screen_active(), 0, 999, 0);
+  lv_obj_set_style_text_font(nl, &lv_font_montserrat_16, 0);
+  num_label_set_value(nl, 123);
+  lv_refr_now(display);
+  int32_t w16 = lv_obj_get_width(nl);
+
+  // Like ui_set_stale(): redraws the object, nothing else
+  flushed_px = 0;
+  lv_obj_set_style_text_opa(nl, LV_OPA_40, 0);
+  lv_refr_now(display);
+  TEST_ASSERT_EQUAL_INT32(w16, lv_obj_get_width(nl));
+  TEST_ASSERT_TRUE(flushed_px > 0);
+
+  lv_obj_set_style_text_letter_space(nl, 2, 0);
+  lv_refr_now(display);
+  TEST_ASSERT_EQUAL_INT32(w16 + 3 * 2, lv_obj_get_width(nl));
+
+  lv_obj_set_style_text_font(nl, &lv_font_montserrat_20, 0);
+  lv_refr_now(display);
+  TEST_ASSERT_TRUE(lv_obj_get_width(nl) > w16 + 3 * 2);
+
+  // Cells follow the new geometry: one changed digit redraws about one cell
+  flushed_px = 0;
+  num_label_set_value(nl, 124);
+  lv_refr_now(display);
+  TEST_ASSERT_TRUE(flushed_px > 0);
+  TEST_ASSERT_TRUE(flushed_px < (unsigned long)lv_obj_get_width(nl) * lv_obj_get_height(nl));
+}
+
+void setUp() {
+  lv_init();
+  lv_tick_set_cb(tick_cb);
+  display = lv_display_create(HOR_RES, VER_RES);
+  lv_display_set_flush_cb(display, flush_cb);
+  lv_display_set_buffers(display, band, NULL, sizeof(band), LV_DISPLAY_RENDER_MODE_PARTIAL);
+}
+
+void tearDown() {
+  lv_deinit();
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_against_lv_label);
+  RUN_TEST(test_style_changes);
+  return UNITY_END();
+}
@@ -0,0 +1,262 @@
+// test_odometer.cpp - odometer log against a file-backed flash emulator
+//
+//   pio test -e native -f test_odometer -v
+//
+// The emulator behaves like the ESP32's NOR flash: erase sets a whole sector to
+// 0xFF, programming can only clear bits, and the injected power cut stops a
+// write or erase after any number of bytes. Writes are torn front to back and
+// back to front, so the CRC is tested on its own and not only the magic.
+// Every test reboots with odometer_init() and checks that the last committed
+// record comes back.
+
+#include <unity.h>
+#include <stdio.h>
+#include "odometer.h"
+
+#define SECTOR_SIZE    4096
+#define SECTOR_COUNT   4                         // the 16 KiB "odo" partition
+#define RECORD_SIZE    16
+#define SLOTS          (SECTOR_SIZE / RECORD_SIZE)
+
+// ===== Flash emulator =====
+static FILE *image;
+static long write_cut = -1;        // bytes still programmed before the power fails, -1 = never
+static long erase_cut = -1;        // same for erasing
+static bool powered = true;
+static bool backwards;             // program the last byte of a write first
+static uint32_t erase_count[SECTOR_COUNT];
+static uint32_t reprogrammed;      // bytes programmed twice without an erase
+
+// One byte of progress on a write or erase; false once the power is gone
+static bool tick_byte(long *cut) {
+  if (!powered) return false;
+  if (*cut == 0) {
+    powered = false;
+    return false;
+  }
+  if (*cut > 0) (*cut)--;
+  return true;
+}
+
+static uint8_t peek(uint32_t addr) {
+  fseek(image, addr, SEEK_SET);
+  return (uint8_t)fgetc(image);
+}
+
+static void poke(uint32_t addr, uint8_t b) {
+  fseek(image, addr, SEEK_SET);
+  fputc(b, image);
+}
+
+static bool emu_read(uint32_t addr, void *buf, uint32_t len) {
+  if (!powered || addr + len > SECTOR_SIZE * SECTOR_COUNT) return false;
+  fseek(image, addr, SEEK_SET);
+  return fread(buf, 1, len, image) == len;
+}
+
+static bool emu_write(uint32_t addr, const void *buf, uint32_t len) {
+  if (addr + len > SECTOR_SIZE * SECTOR_COUNT) return false;
+  const uint8_t *src = (const uint8_t *)buf;
+  for (uint32_t n = 0; n < len; n++) {
+    uint32_t i = backwards ? len - 1 - n : n;
+    if (!tick_byte(&write_cut)) return false;
+    uint8_t old = peek(addr + i);
+    if (old != 0xFF) reprogrammed++;
+    poke(addr + i, old & src[i]);
+  }
+  return true;
+}
+
+static bool emu_erase(uint32_t sector) {
+  if (sector >= SECTOR_COUNT) return false;
+  erase_count[sector]++;
+  for (uint32_t i = 0; i < SECTOR_SIZE; i++) {
+    if (!tick_byte(&erase_cut)) return false;
+    poke(sector * SECTOR_SIZE + i, 0xFF);
+  }
+  return true;
+}
+
+static const odo_flash_t emu = { emu_read, emu_write, emu_erase, SECTOR_SIZE, SECTOR_COUNT };
+
+// ===== Helpers =====
+static int32_t committed_odo, committed_trip;
+
+// Power up with the boot placeholders from setup() and restore from flash
+static bool reboot() {
+  powered = true;
+  write_cut = erase_cut = -1;
+  dashData.odo = 10;
+  dashData.trip = 110;
+  return odometer_init(&emu);
+}
+
+// Move by one km and let the odometer save it; tracks what reached flash
+static bool step_km() {
+  uint32_t before = odometer_write_count();
+  dashData.odo++;
+  dashData.trip++;
+  native_millis += 1000;
+  odometer_update();
+  if (odometer_write_count() == before) return false;
+  committed_odo = dashData.odo;
+  committed_trip = dashData.trip;
+  return true;
+}
+
+// Fresh store with `records` records written
+static void fill(uint32_t records) {
+  TEST_ASSERT_FALSE(reboot());
+  dashData.odo = 1000;
+  dashData.trip = 0;
+  for (uint32_t i = 0; i < records; i++) {
+    TEST_ASSERT_TRUE(step_km());
+  }
+}
+
+static void assert_restored(int32_t odo, int32_t trip) {
+  TEST_ASSERT_TRUE(reboot());
+  TEST_ASSERT_EQUAL_INT32(odo, dashData.odo);
+  TEST_ASSERT_EQUAL_INT32(trip, dashData.trip);
+}
+
+void setUp() {
+  image = tmpfile();
+  TEST_ASSERT_NOT_NULL(image);
+  for (uint32_t i = 0; i < SECTOR_SIZE * SECTOR_COUNT; i++) fputc(0xFF, image);
+  memset(erase_count, 0, sizeof(erase_count));
+  reprogrammed = 0;
+  committed_odo = committed_trip = 0;
+  native_millis = 0;
+  backwards = false;
+}
+
+void tearDown() {
+  fclose(image);
+  TEST_ASSERT_EQUAL_UINT32(0, reprogrammed);
+}
+
+// ===== Tests =====
+static void test_empty_store_keeps_placeholders() {
+  TEST_ASSERT_FALSE(reboot());
+  TEST_ASSERT_EQUAL_INT32(10, dashData.odo);
+  TEST_ASSERT_EQUAL_INT32(110, dashData.trip);
+}
+
+static void test_restores_across_sector_wrap() {
+  // More than one lap over all sectors
+  fill(SLOTS * SECTOR_COUNT + SLOTS / 2);
+  assert_restored(committed_odo, committed_trip);
+
+  // And keeps appending after the reboot
+  TEST_ASSERT_TRUE(step_km());
+  assert_restored(committed_odo, committed_trip);
+}
+
+// Power cut after every byte count of a record, in the middle of a sector, in
+// its last slot, and in the first slot of the next sector
+static void test_power_cut_during_write() {
+  const uint32_t at[] = { 5, SLOTS - 1, SLOTS };
+
+  for (uint32_t i = 0; i < sizeof(at) / sizeof(at[0]) * 2; i++) {
+    for (long cut = 0; cut <= RECORD_SIZE; cut++) {
+      tearDown();
+      setUp();
+      backwards = i & 1;
+      fill(at[i / 2]);
+      int32_t odo = committed_odo, trip = committed_trip;
+
+      write_cut = cut;
+      bool done = step_km();
+      TEST_ASSERT_EQUAL(cut == RECORD_SIZE, done);
+      TEST_ASSERT_TRUE(reboot());
+      if (cut < RECORD_SIZE - 1) {
+        TEST_ASSERT_EQUAL_INT32(odo, dashData.odo);
+        TEST_ASSERT_EQUAL_INT32(trip, dashData.trip);
+      } else {
+        // One byte short: it may already hold its value as erased 0xFF
+        TEST_ASSERT_TRUE(dashData.odo == odo || dashData.odo == odo + 1);
+      }
+
+      // The torn slot is skipped, never programmed again
+      for (int k = 0; k < 3; k++) TEST_ASSERT_TRUE(step_km());
+      assert_restored(committed_odo, committed_trip);
+    }
+  }
+}
+
+// Power cut while erasing the oldest sector to reuse it
+static void test_power_cut_during_erase() {
+  const long cuts[] = { 0, 1, RECORD_SIZE, SECTOR_SIZE / 2, SECTOR_SIZE - 1 };
+
+  for (uint32_t i = 0; i < sizeof(cuts) / sizeof(cuts[0]); i++) {
+    tearDown();
+    setUp();
+    fill(SLOTS * SECTOR_COUNT);   // every sector full: the next record erases sector 0
+    int32_t odo = committed_odo, trip = committed_trip;
+
+    erase_cut = cuts[i];
+    TEST_ASSERT_FALSE(step_km());
+    assert_restored(odo, trip);
+
+    for (int k = 0; k < 3; k++) TEST_ASSERT_TRUE(step_km());
+    assert_restored(committed_odo, committed_trip);
+  }
+}
+
+// Drive with a trip that was reset part-way through a km, so trip and odometer
+// tick over at different points: writes per km and erases per sector
+static void drive(double kmh, double km) {
+  TEST_ASSERT_FALSE(reboot());
+  double odo = 1000.0, trip = 0.37;
+  uint32_t writes = odometer_write_count();
+
+  for (double t = 0; t < km / kmh * 3600.0; t++) {
+    odo += kmh / 3600.0;
+    trip += kmh / 3600.0;
+    dashData.odo = (int32_t)odo;
+    dashData.trip = (int32_t)trip;
+    native_millis += 1000;
+    odometer_update();
+  }
+  writes = odometer_write_count() - writes;
+
+  char msg[128];
+  snprintf(msg, sizeof(msg), "%5.0f km/h: %.2f writes/km (%u records over %.0f km)",
+           kmh, writes / km, (unsigned)writes, km);
+  TEST_MESSAGE(msg);
+  // One record per km for the odometer, at most one more for the trip
+  TEST_ASSERT_TRUE(writes <= 2 * km + 1);
+  TEST_ASSERT_TRUE(writes >= km - 1);
+}
+
+static void test_writes_per_km() {
+  const double speeds[] = { 5, 25, 60, 120 };
+  for (uint32_t i = 0; i < sizeof(speeds) / sizeof(speeds[0]); i++) {
+    tearDown();
+    setUp();
+    drive(speeds[i], 1000);
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "        erases per sector: %u %u %u %u",
+             (unsigned)erase_count[0], (unsigned)erase_count[1],
+             (unsigned)erase_count[2], (unsigned)erase_count[3]);
+    TEST_MESSAGE(msg);
+    uint32_t lo = erase_count[0], hi = erase_count[0];
+    for (int s = 1; s < SECTOR_COUNT; s++) {
+      if (erase_count[s] < lo) lo = erase_count[s];
+      if (erase_count[s] > hi) hi = erase_count[s];
+    }
+    TEST_ASSERT_TRUE(hi - lo <= 1);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_store_keeps_placeholders);
+  RUN_TEST(test_restores_across_sector_wrap);
+  RUN_TEST(test_power_cut_during_write);
+  RUN_TEST(test_power_cut_during_erase);
+  RUN_TEST(test_writes_per_km);
+  return UNITY_END();
+}
@@ -0,0 +1,114 @@
+// test_sd_image.cpp - SD card traffic of the splash image, with and without the read cache
+//
+//   pio test -e native -f test_sd_image -v
+//
+// The splash is drawn from "S:" (LVGL's Arduino SD driver) the way setup() does it:
+// a 320 x 200 RGB565 .bin that LVGL's bin decoder reads row by row while the
+// display renders in 40-row bands. Each configuration redraws it 10 times, with
+// the driver's cache_size set to 0 and to LV_FS_ARDUINO_SD_CACHE_SIZE. The card
+// is the FatFs-like model in test/native. Card time is modelled at 20 MHz SPI,
+// ~100 us per read command and ~10 us per File::read() call.
+
+#include <unity.h>
+#include <lvgl.h>
+#include <SD.h>
+#include <stdio.h>
+
+#define HOR_RES   480
+#define VER_RES   320
+#define BAND_ROWS 40
+#define IMG_W     320
+#define IMG_H     200
+#define FRAMES    10
+
+static uint32_t tick;
+static uint16_t band[HOR_RES * BAND_ROWS];
+static uint8_t image[sizeof(lv_image_header_t) + IMG_W * IMG_H * 2];
+static uint32_t frame_crc;
+
+static uint32_t tick_cb() {
+  return tick;
+}
+
+// Order-dependent checksum of everything flushed
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px) {
+  uint32_t n = lv_area_get_size(area) * 2;
+  for (uint32_t i = 0; i < n; i++) frame_crc = frame_crc * 31 + px[i];
+  lv_display_flush_ready(disp);
+}
+
+static void make_image() {
+  lv_image_header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic = LV_IMAGE_HEADER_MAGIC;
+  header.cf = LV_COLOR_FORMAT_RGB565;
+  header.w = IMG_W;
+  header.h = IMG_H;
+  header.stride = IMG_W * 2;
+  memcpy(image, &header, sizeof(header));
+
+  uint16_t *px = (uint16_t *)(image + sizeof(header));
+  for (int y = 0; y < IMG_H; y++) {
+    for (int x = 0; x < IMG_W; x++) px[y * IMG_W + x] = (uint16_t)(x * 97 + y * 1031);
+  }
+  sd_card_add_file("/lvgl/logo1.bin", image, sizeof(image));
+}
+
+typedef struct {
+  sd_card_stats_t card;
+  uint32_t crc;
+} result_t;
+
+static result_t run(lv_obj_t *img, uint32_t cache_size) {
+  lv_fs_get_drv('S')->cache_size = cache_size;
+  memset(&sd_card, 0, sizeof(sd_card));
+  frame_crc = 0;
+  for (int f = 0; f < FRAMES; f++) {
+    lv_obj_invalidate(img);
+    lv_refr_now(NULL);
+  }
+  result_t r = { sd_card, frame_crc };
+
+  double us = r.card.sectors * SD_CARD_SECTOR * 8 / 20.0 + r.card.commands * 100.0 + r.card.reads * 10.0;
+  char msg[200];
+  snprintf(msg, sizeof(msg),
+           "cache %4u B: per frame %4lu reads, %4lu commands, %4lu sectors for %6lu B, ~%5.1f ms card time",
+           (unsigned)cache_size, r.card.reads / FRAMES, r.card.commands / FRAMES, r.card.sectors / FRAMES,
+           r.card.read_bytes / FRAMES, us / FRAMES / 1000);
+  TEST_MESSAGE(msg);
+  return r;
+}
+
+static void test_splash_reads() {
+  lv_obj_t *img = lv_image_create(lv_screen_active());
+  lv_image_set_src(img, "S:/lvgl/logo1.bin");
+  lv_obj_center(img);
+  lv_refr_now(NULL);
+
+  result_t direct = run(img, 0);
+  result_t cached = run(img, LV_FS_ARDUINO_SD_CACHE_SIZE);
+
+  TEST_ASSERT_TRUE(direct.card.sectors > 0);
+  TEST_ASSERT_EQUAL_UINT32(direct.crc, cached.crc);
+  TEST_ASSERT_TRUE(cached.card.commands < direct.card.commands);
+}
+
+void setUp() {
+  lv_init();
+  lv_tick_set_cb(tick_cb);
+  lv_display_t *disp = lv_display_create(HOR_RES, VER_RES);
+  lv_display_set_flush_cb(disp, flush_cb);
+  lv_display_set_buffers(disp, band, NULL, sizeof(band), LV_DISPLAY_RENDER_MODE_PARTIAL);
+  make_image();
+}
+
+void tearDown() {
+  lv_deinit();
+  sd_card_remove_files();
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_splash_reads);
+  return UNITY_END();
+}
@@ -0,0 +1,130 @@
+// test_text_adv.cpp - text measurement with and without the ASCII advance tables
+//
+//   pio test -e native -f test_text_adv -v
+//
+// The dashboard's label texts are measured at Montserrat 18 with
+// lv_text_get_size(), content-sized and wrapped to 200 px, once through the
+// font itself and once through a copy whose get_glyph_dsc is a wrapper, so
+// lv_text.c can't build a table for it and takes the per-glyph path. Both must
+// give the same sizes. Reported: host ns per label text and the time to build
+// one table. Host times only compare to each other.
+
+#include <unity.h>
+#include <lvgl.h>
+#include <src/core/lv_global.h>
+#include <src/misc/lv_text_private.h>
+#include <stdio.h>
+#include <time.h>
+
+#define ROUNDS 20000
+
+static const char *const texts[] = {
+  "Range: 123 km", "Avg. con: 45 W/km", "Volt: 72.40 V", "Current: -12.50 A",
+  "Motor: 65°C", "Battery: 41°C", "SoC: 87%", "TRIP: 1234 km", "ODO: 123456 km",
+  "Avg. SPEED: 42 km/h", "Eco", "Diagnostics", "Tap a tile to zoom, drag to pan the map view",
+};
+
+#define TEXT_CNT (sizeof(texts) / sizeof(texts[0]))
+
+static lv_font_t plain_font;   // Montserrat 18 without a table
+static lv_font_t kern_font;    // Montserrat 18 with its own table, for the kerning test
+
+static bool plain_glyph_dsc(const lv_font_t *font, lv_font_glyph_dsc_t *dsc, uint32_t letter, uint32_t next) {
+  return lv_font_get_glyph_dsc_fmt_txt(font, dsc, letter, next);
+}
+
+static double now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// ns per text, and the sum of the sizes to compare the paths
+static double measure(const lv_font_t *font, int32_t max_w, long *sum) {
+  lv_point_t size;
+  *sum = 0;
+  double t0 = now_ns();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (uint32_t i = 0; i < TEXT_CNT; i++) {
+      lv_text_get_size(&size, texts[i], font, 0, 0, max_w, LV_TEXT_FLAG_NONE);
+      *sum += size.x * 1000 + size.y;
+    }
+  }
+  return (now_ns() - t0) / ROUNDS / TEXT_CNT;
+}
+
+static uint32_t tables_of(const lv_font_t *font) {
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < LV_TEXT_ASCII_ADV_CACHE_CNT; i++) {
+    if (LV_GLOBAL_DEFAULT()->text_ascii_adv[i].font == font) n++;
+  }
+  return n;
+}
+
+static void test_table_against_glyphs() {
+  const lv_font_t *font = &lv_font_montserrat_18;
+  lv_point_t size;
+
+  double t0 = now_ns();
+  lv_text_get_size(&size, "0", font, 0, 0, LV_COORD_MAX, LV_TEXT_FLAG_NONE);
+  double build_us = (now_ns() - t0) / 1000;
+  TEST_ASSERT_EQUAL_UINT32(1, tables_of(font));
+
+  const int32_t widths[] = { LV_COORD_MAX, 200 };
+  const char *names[] = { "content-sized", "200 px wrap" };
+  for (int w = 0; w < 2; w++) {
+    long sum_plain, sum_table;
+    double plain = measure(&plain_font, widths[w], &sum_plain);
+    double table = measure(font, widths[w], &sum_table);
+    TEST_ASSERT_EQUAL_INT32(sum_plain, sum_table);
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "%-14s per glyph %6.0f ns, table %6.0f ns per text", names[w], plain, table);
+    TEST_MESSAGE(msg);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, tables_of(&plain_font));
+
+  char msg[80];
+  snprintf(msg, sizeof(msg), "building one table with the kerning scan: %.0f us", build_us);
+  TEST_MESSAGE(msg);
+}
+
+// A font whose kerning changes keeps its one table and is measured without it meanwhile
+static void test_kerning_change() {
+  const char *txt = "AVATAR To Ty";
+  lv_point_t kerned, unkerned, again;
+
+  lv_text_get_size(&kerned, txt, &kern_font, 0, 0, LV_COORD_MAX, LV_TEXT_FLAG_NONE);
+  TEST_ASSERT_EQUAL_UINT32(1, tables_of(&kern_font));
+
+  kern_font.kerning = LV_FONT_KERNING_NONE;
+  lv_text_get_size(&unkerned, txt, &kern_font, 0, 0, LV_COORD_MAX, LV_TEXT_FLAG_NONE);
+  TEST_ASSERT_EQUAL_UINT32(1, tables_of(&kern_font));
+  int32_t sum = 0;
+  for (const char *c = txt; *c; c++) sum += lv_font_get_glyph_width(&kern_font, *c, 0);
+  TEST_ASSERT_EQUAL_INT32(sum, unkerned.x);
+  TEST_ASSERT_TRUE(kerned.x != unkerned.x);
+
+  kern_font.kerning = LV_FONT_KERNING_NORMAL;
+  lv_text_get_size(&again, txt, &kern_font, 0, 0, LV_COORD_MAX, LV_TEXT_FLAG_NONE);
+  TEST_ASSERT_EQUAL_UINT32(1, tables_of(&kern_font));
+  TEST_ASSERT_EQUAL_INT32(kerned.x, again.x);
+}
+
+void setUp() {
+  lv_init();
+  plain_font = lv_font_montserrat_18;
+  plain_font.get_glyph_dsc = plain_glyph_dsc;
+  kern_font = lv_font_montserrat_18;
+}
+
+void tearDown() {
+  lv_deinit();
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_table_against_glyphs);
+  RUN_TEST(test_kerning_change);
+  return UNITY_END();
+}
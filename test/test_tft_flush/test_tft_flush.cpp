@@ -0,0 +1,201 @@
+// test_tft_flush.cpp - SPI traffic of LVGL's TFT_eSPI flush on a dashboard workload
+//
+//   pio test -e native -f test_tft_flush -v
+//   PLATFORMIO_BUILD_FLAGS="-D LV_TFT_ESPI_TILE_DIFF=0" pio test -e native -f test_tft_flush -v
+//   PLATFORMIO_BUILD_FLAGS="-D LV_TFT_ESPI_BATCH_WRITES=0" pio test -e native -f test_tft_flush -v
+//
+// The other runs are the baselines without the tile hashes and without one SPI
+// transaction per refresh. TFT_eSPI is the panel model in test/native; after
+// every refresh the panel has to show exactly what LVGL rendered. A
+// dashboard-like screen (bars, a 48 px speed readout, small readouts) goes
+// through three workloads:
+//   telemetry  500 frames of speed/voltage/current updates, slower fields now and then
+//   no-change  100 invalidations of the whole screen without a change
+//   screens    10 round trips to a second screen
+// Bus time is modelled at 27 MHz plus ~0.5 us per bus write and ~6 us per transaction.
+
+#include <unity.h>
+#include <lvgl.h>
+#include <TFT_eSPI.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BAND_ROWS  40
+
+static uint32_t tick;
+static uint16_t band[TFT_PANEL_W * BAND_ROWS];
+static uint16_t rendered[TFT_PANEL_W * TFT_PANEL_H];
+static lv_display_t *disp;
+static unsigned long mismatches;
+static unsigned long refreshes;    // refreshes that flushed something
+
+static lv_obj_t *dash_scr, *other_scr;
+static lv_obj_t *speed, *voltage, *current, *soc, *range, *trip;
+
+static uint32_t tick_cb() {
+  return tick;
+}
+
+// Runs before the driver's flush_cb: keep what LVGL rendered
+static void flush_start_cb(lv_event_t *e) {
+  const lv_area_t *a = (const lv_area_t *)lv_event_get_param(e);
+  const uint16_t *px = (const uint16_t *)lv_display_get_buf_active(disp)->data;
+  int32_t w = lv_area_get_width(a);
+  if (lv_display_flush_is_last(disp)) refreshes++;
+  for (int32_t y = a->y1; y <= a->y2; y++) {
+    memcpy(&rendered[y * TFT_PANEL_W + a->x1], px + (y - a->y1) * w, w * sizeof(uint16_t));
+  }
+}
+
+static void refresh() {
+  lv_refr_now(disp);
+  if (memcmp(rendered, tft_panel, sizeof(rendered)) != 0) mismatches++;
+}
+
+static lv_obj_t *bar(lv_obj_t *scr, int32_t h, lv_align_t align) {
+  lv_obj_t *obj = lv_obj_create(scr);
+  lv_obj_set_size(obj, TFT_PANEL_W, h);
+  lv_obj_align(obj, align, 0, 0);
+  lv_obj_set_style_bg_color(obj, lv_color_white(), 0);
+  lv_obj_set_style_border_width(obj, 0, 0);
+  lv_obj_set_style_radius(obj, 0, 0);
+  return obj;
+}
+
+static lv_obj_t *readout(lv_obj_t *parent, const lv_font_t *font, lv_align_t align, int32_t x, int32_t y) {
+  lv_obj_t *label = lv_label_create(parent);
+  lv_obj_set_style_text_font(label, font, 0);
+  lv_obj_align(label, align, x, y);
+  return label;
+}
+
+static void create_screens() {
+  dash_scr = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(dash_scr, lv_color_hex(0xe5e5e5), 0);
+  lv_obj_t *top = bar(dash_scr, 55, LV_ALIGN_TOP_MID);
+  lv_label_set_text(readout(top, &lv_font_montserrat_18, LV_ALIGN_CENTER, 0, 0), "9:41 AM");
+  lv_obj_t *bottom = bar(dash_scr, 50, LV_ALIGN_BOTTOM_MID);
+
+  speed = readout(dash_scr, &lv_font_montserrat_48, LV_ALIGN_CENTER, 0, -40);
+  voltage = readout(dash_scr, &lv_font_montserrat_16, LV_ALIGN_LEFT_MID, 20, -20);
+  current = readout(dash_scr, &lv_font_montserrat_16, LV_ALIGN_LEFT_MID, 20, 10);
+  soc = readout(dash_scr, &lv_font_montserrat_16, LV_ALIGN_RIGHT_MID, -20, -20);
+  range = readout(dash_scr, &lv_font_montserrat_16, LV_ALIGN_RIGHT_MID, -20, 10);
+  trip = readout(bottom, &lv_font_montserrat_14, LV_ALIGN_LEFT_MID, 5, 0);
+
+  lv_obj_t *mode = lv_obj_create(dash_scr);
+  lv_obj_set_size(mode, 100, 60);
+  lv_obj_align(mode, LV_ALIGN_CENTER, 0, 45);
+  lv_obj_set_style_radius(mode, 10, 0);
+  lv_label_set_text(readout(mode, &lv_font_montserrat_16, LV_ALIGN_CENTER, 0, 0), "ECO");
+
+  // A second, mostly text screen like the diagnostics page
+  other_scr = lv_obj_create(NULL);
+  bar(other_scr, 40, LV_ALIGN_TOP_MID);
+  for (int i = 0; i < 12; i++) {
+    lv_label_set_text_fmt(readout(other_scr, &lv_font_montserrat_14, LV_ALIGN_TOP_LEFT, 10 + (i % 2) * 240, 50 + (i / 2) * 40),
+                          "metric.%d  %d", i, i * 37);
+  }
+}
+
+static int spd = 40, pct = 80, km = 210, trip_km = 11;
+static int centivolts = 7240, centiamps = 0;
+
+static void update_labels() {
+  lv_label_set_text_fmt(speed, "%d", spd);
+  lv_label_set_text_fmt(voltage, "%d.%02d V", centivolts / 100, centivolts % 100);
+  lv_label_set_text_fmt(current, "%d.%02d A", centiamps / 100, abs(centiamps % 100));
+  lv_label_set_text_fmt(soc, "%d %%", pct);
+  lv_label_set_text_fmt(range, "%d km", km);
+  lv_label_set_text_fmt(trip, "TRIP: %d km", trip_km);
+}
+
+// Bytes on the bus and modelled time since the last report
+static void report(const char *name, unsigned long frames) {
+  double us = (tft_bus.px * 2 + tft_bus.cmd_bytes) * 8 / 27.0 + tft_bus.writes * 0.5 + tft_bus.transactions * 6.0;
+  char msg[200];
+  snprintf(msg, sizeof(msg), "%-9s %4lu fr: %6lu kB px, %5.1f kB cmd, %5lu windows, %5lu txn, ~%7.1f ms bus",
+           name, frames, tft_bus.px * 2 / 1000, tft_bus.cmd_bytes / 1000.0, tft_bus.windows,
+           tft_bus.transactions, us / 1000);
+  TEST_MESSAGE(msg);
+}
+
+static void reset_counts() {
+  memset(&tft_bus, 0, sizeof(tft_bus));
+  refreshes = 0;
+}
+
+static void check_transactions() {
+#if LV_TFT_ESPI_BATCH_WRITES
+  // The bus is claimed once per refresh, not once per band
+  TEST_ASSERT_EQUAL_UINT32(refreshes, tft_bus.transactions);
+#endif
+}
+
+static void test_panel_matches_and_traffic() {
+  lv_init();
+  lv_tick_set_cb(tick_cb);
+  disp = lv_tft_espi_create(TFT_PANEL_W, TFT_PANEL_H, band, sizeof(band));
+  lv_display_add_event_cb(disp, flush_start_cb, LV_EVENT_FLUSH_START, NULL);
+  create_screens();
+  update_labels();
+  lv_screen_load(dash_scr);
+  refresh();
+  reset_counts();
+  srand(1);
+
+  for (int f = 0; f < 500; f++) {
+    tick += 50;
+    spd = LV_CLAMP(0, spd + rand() % 3 - 1, 199);
+    centivolts += rand() % 5 - 2;
+    centiamps = rand() % 2000 - 500;
+    if (f % 50 == 0) { pct--; km--; }
+    if (f % 20 == 0) trip_km++;
+    update_labels();
+    refresh();
+  }
+  report("telemetry", 500);
+  TEST_ASSERT_EQUAL_UINT32(0, mismatches);
+  TEST_ASSERT_EQUAL_UINT32(0, tft_bus.out_of_window);
+  check_transactions();
+
+  reset_counts();
+  for (int f = 0; f < 100; f++) {
+    lv_obj_invalidate(lv_screen_active());
+    refresh();
+  }
+  report("no-change", 100);
+  TEST_ASSERT_EQUAL_UINT32(0, mismatches);
+  TEST_ASSERT_EQUAL_UINT32(0, tft_bus.out_of_window);
+  check_transactions();
+#if LV_TFT_ESPI_TILE_DIFF
+  // Every tile is covered by a band and hashes as before: under 1% of the panel per frame
+  TEST_ASSERT_TRUE(tft_bus.px < 100 * TFT_PANEL_W * TFT_PANEL_H / 100);
+#endif
+
+  reset_counts();
+  for (int f = 0; f < 10; f++) {
+    lv_screen_load(other_scr);
+    refresh();
+    lv_screen_load(dash_scr);
+    refresh();
+  }
+  report("screens", 20);
+  TEST_ASSERT_EQUAL_UINT32(0, mismatches);
+  TEST_ASSERT_EQUAL_UINT32(0, tft_bus.out_of_window);
+  check_transactions();
+
+  lv_deinit();
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_panel_matches_and_traffic);
+  return UNITY_END();
+}
@@ -0,0 +1,118 @@
+// test_trace.cpp - trace.cpp's serial stream decoded by tools/trace_to_chrome.py
+//
+//   pio test -e native_trace -v
+//
+// Needs DASH_TRACE (LVGL's profiler), hence its own env. Markers are recorded
+// on the stand-in clock, the stream the Serial stand-in captured is written
+// to a file, and python3 runs the converter on it; its Chrome trace JSON must
+// hold every marker with its time. Text printed between the packets, as on
+// the real port, must be skipped.
+
+#include <unity.h>
+#include <lvgl.h>
+#include <Arduino.h>
+#include <stdio.h>
+#include <string>
+#include "trace.h"
+
+#define CAPTURE_PATH  "test_trace.bin"
+#define MANY          300
+
+// Tags are interned by pointer, so a few distinct literals
+static const char *const many_tags[] = { "tag_a", "tag_b", "tag_c", "tag_d" };
+
+static std::string capture;
+
+static std::string convert(const std::string &data) {
+  FILE *f = fopen(CAPTURE_PATH, "wb");
+  TEST_ASSERT_NOT_NULL(f);
+  fwrite(data.data(), 1, data.size(), f);
+  fclose(f);
+
+  FILE *p = popen("python3 tools/trace_to_chrome.py " CAPTURE_PATH " 2>&1", "r");
+  TEST_ASSERT_NOT_NULL(p);
+  std::string json;
+  char buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), p)) > 0) json.append(buf, n);
+  TEST_ASSERT_EQUAL_INT(0, pclose(p));
+  remove(CAPTURE_PATH);
+  return json;
+}
+
+static size_t count(const std::string &s, const std::string &what) {
+  size_t n = 0;
+  for (size_t pos = s.find(what); pos != std::string::npos; pos = s.find(what, pos + 1)) n++;
+  return n;
+}
+
+static void test_round_trip() {
+  native_millis = 1000;
+  trace_begin();
+
+  LV_PROFILER_BEGIN_TAG("outer");
+  native_millis += 2;
+  LV_PROFILER_BEGIN_TAG("inner");
+  native_millis += 3;
+  LV_PROFILER_END_TAG("inner");
+  LV_PROFILER_END_TAG("outer");
+  trace_poll();
+
+  Serial.printf("text on the same port \xA5\x5A between packets\n");
+
+  // Enough markers for several packets, each 1 ms after the last
+  for (int i = 0; i < MANY; i++) {
+    native_millis += 1;
+    if (i % 2 == 0) LV_PROFILER_BEGIN_TAG(many_tags[i / 2 % 4]);
+    else LV_PROFILER_END_TAG(many_tags[i / 2 % 4]);
+  }
+  trace_poll();
+
+  std::string json = convert(capture);
+  TEST_ASSERT_TRUE(capture.size() > 255);
+
+  const char *expected[] = {
+    "{\"name\": \"outer\", \"ph\": \"B\", \"ts\": 0, \"pid\": 0, \"tid\": 0}",
+    "{\"name\": \"inner\", \"ph\": \"B\", \"ts\": 2000, \"pid\": 0, \"tid\": 0}",
+    "{\"name\": \"inner\", \"ph\": \"E\", \"ts\": 5000, \"pid\": 0, \"tid\": 0}",
+    "{\"name\": \"outer\", \"ph\": \"E\", \"ts\": 5000, \"pid\": 0, \"tid\": 0}",
+    "{\"name\": \"tag_a\", \"ph\": \"B\", \"ts\": 6000, \"pid\": 0, \"tid\": 0}",
+    "{\"name\": \"tag_a\", \"ph\": \"E\", \"ts\": 7000, \"pid\": 0, \"tid\": 0}",
+    "{\"name\": \"tag_b\", \"ph\": \"B\", \"ts\": 8000, \"pid\": 0, \"tid\": 0}",
+  };
+  size_t pos = 0;
+  for (const char *e : expected) {
+    pos = json.find(e, pos);
+    if (pos == std::string::npos) TEST_FAIL_MESSAGE(e);
+  }
+
+  // The last marker, and no lost packets or unknown records
+  char last[120];
+  snprintf(last, sizeof(last), "{\"name\": \"%s\", \"ph\": \"E\", \"ts\": %d,",
+           many_tags[(MANY - 1) / 2 % 4], 5000 + MANY * 1000);
+  TEST_ASSERT_TRUE(json.find(last) != std::string::npos);
+  TEST_ASSERT_EQUAL_UINT32(2 + MANY / 2, count(json, "\"ph\": \"B\""));
+  TEST_ASSERT_EQUAL_UINT32(2 + MANY / 2, count(json, "\"ph\": \"E\""));
+  TEST_ASSERT_EQUAL_UINT32(0, count(json, "warning"));
+
+  char msg[80];
+  snprintf(msg, sizeof(msg), "%d markers in %u bytes of stream", 4 + MANY, (unsigned)capture.size());
+  TEST_MESSAGE(msg);
+}
+
+void setUp() {
+  lv_init();
+  capture.clear();
+  Serial.capture = &capture;
+}
+
+void tearDown() {
+  Serial.capture = NULL;
+  lv_deinit();
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip);
+  return UNITY_END();
+}
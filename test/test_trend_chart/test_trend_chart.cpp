@@ -0,0 +1,183 @@
+// test_trend_chart.cpp - trend_chart against lv_chart on the trend screen's plot
+//
+//   pio test -e native -f test_trend_chart -v
+//
+// A 320 x 140 plot takes 640 samples (two laps), a refresh after each, as
+// trend_chart in both modes and as an lv_chart with min, max and average
+// series of 320 points. lv_chart draws the min and max as lines, not as a
+// filled band, so it has less to draw per column. Reported per sample: host
+// time for the push and the refresh, pixels flushed, and the LVGL heap the
+// plot holds. The times are host times and only compare to each other; the
+// flushed pixels and the heap carry over to the target.
+
+#include <unity.h>
+#include <lvgl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "trend_chart.h"
+#include "trend_screen.h"
+
+#define HOR_RES   480
+#define VER_RES   320
+#define BAND_ROWS 40
+#define SAMPLES   (2 * TREND_SCREEN_CHART_W)
+
+typedef struct {
+  double us_per_sample;
+  double px_per_sample;
+  size_t heap;
+} result_t;
+
+static uint32_t tick;
+static uint16_t band[HOR_RES * BAND_ROWS];
+static lv_display_t *display;
+static unsigned long flushed_px;
+
+static uint32_t tick_cb() {
+  return tick;
+}
+
+static void flush_cb(lv_display_t *d, const lv_area_t *area, uint8_t *) {
+  flushed_px += lv_area_get_size(area);
+  lv_display_flush_ready(d);
+}
+
+static double now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static size_t heap_used() {
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  return mon.total_size - mon.free_size;
+}
+
+// Speed-like random walk, one column of min/max/avg per sample
+static hist_point_t next_point() {
+  static int32_t v = 40;
+  v = LV_CLAMP(5, v + rand() % 7 - 3, 95);
+  hist_point_t p;
+  p.min = (int16_t)(v - rand() % 6);
+  p.max = (int16_t)(v + rand() % 6);
+  p.avg = (int16_t)v;
+  return p;
+}
+
+static void report(const char *name, const result_t *r) {
+  char msg[160];
+  snprintf(msg, sizeof(msg), "%-18s %7.1f us, %6.0f px flushed per sample, %5zu B LVGL heap",
+           name, r->us_per_sample, r->px_per_sample, r->heap);
+  TEST_MESSAGE(msg);
+}
+
+// Pushes SAMPLES points into the plot created by create() and refreshes after each
+static result_t run(lv_obj_t *(*create)(lv_obj_t *), void (*push)(lv_obj_t *, const hist_point_t *)) {
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_screen_load(scr);
+  lv_refr_now(display);
+
+  srand(3);
+  size_t heap_before = heap_used();
+  lv_obj_t *plot = create(scr);
+  TEST_ASSERT_NOT_NULL(plot);
+  lv_obj_center(plot);
+  lv_refr_now(display);
+
+  result_t r;
+  flushed_px = 0;
+  double t0 = now_us();
+  for (int i = 0; i < SAMPLES; i++) {
+    hist_point_t p = next_point();
+    tick += 1000;
+    push(plot, &p);
+    lv_refr_now(display);
+  }
+  r.us_per_sample = (now_us() - t0) / SAMPLES;
+  r.px_per_sample = (double)flushed_px / SAMPLES;
+  r.heap = heap_used() - heap_before;
+
+  lv_obj_delete(scr);
+  return r;
+}
+
+// ===== trend_chart =====
+static lv_obj_t *scroll_create(lv_obj_t *scr) {
+  return trend_chart_create(scr, TREND_SCREEN_CHART_W, TREND_SCREEN_CHART_H, TREND_CHART_SCROLL);
+}
+
+static lv_obj_t *sweep_create(lv_obj_t *scr) {
+  return trend_chart_create(scr, TREND_SCREEN_CHART_W, TREND_SCREEN_CHART_H, TREND_CHART_SWEEP);
+}
+
+// ===== lv_chart, styled down to the same plot: no border, padding, grid or point markers =====
+static lv_obj_t *lv_chart_plot_create(lv_obj_t *scr) {
+  lv_obj_t *chart = lv_chart_create(scr);
+  lv_obj_set_size(chart, TREND_SCREEN_CHART_W, TREND_SCREEN_CHART_H);
+  lv_obj_set_style_border_width(chart, 0, 0);
+  lv_obj_set_style_radius(chart, 0, 0);
+  lv_obj_set_style_pad_all(chart, 0, 0);
+  lv_obj_set_style_size(chart, 0, 0, LV_PART_INDICATOR);
+  lv_chart_set_div_line_count(chart, 0, 0);
+  lv_chart_set_type(chart, LV_CHART_TYPE_LINE);
+  lv_chart_set_point_count(chart, TREND_SCREEN_CHART_W);
+  lv_chart_set_update_mode(chart, LV_CHART_UPDATE_MODE_SHIFT);
+  lv_chart_set_axis_range(chart, LV_CHART_AXIS_PRIMARY_Y, 0, 100);
+  lv_chart_add_series(chart, lv_color_hex(0x99ccff), LV_CHART_AXIS_PRIMARY_Y);
+  lv_chart_add_series(chart, lv_color_hex(0x99ccff), LV_CHART_AXIS_PRIMARY_Y);
+  lv_chart_add_series(chart, lv_color_hex(0x0055cc), LV_CHART_AXIS_PRIMARY_Y);
+  return chart;
+}
+
+static void lv_chart_push(lv_obj_t *chart, const hist_point_t *p) {
+  lv_chart_series_t *min = lv_chart_get_series_next(chart, NULL);
+  lv_chart_series_t *max = lv_chart_get_series_next(chart, min);
+  lv_chart_series_t *avg = lv_chart_get_series_next(chart, max);
+  lv_chart_set_next_value(chart, min, p->min);
+  lv_chart_set_next_value(chart, max, p->max);
+  lv_chart_set_next_value(chart, avg, p->avg);
+}
+
+static void test_against_lv_chart() {
+  result_t chart = run(lv_chart_plot_create, lv_chart_push);
+  result_t scroll = run(scroll_create, trend_chart_push);
+  result_t sweep = run(sweep_create, trend_chart_push);
+
+  report("lv_chart", &chart);
+  report("trend_chart scroll", &scroll);
+  report("trend_chart sweep", &sweep);
+  char msg[120];
+  snprintf(msg, sizeof(msg), "trend_chart strip outside the LVGL heap: %u B",
+           (unsigned)(TREND_SCREEN_CHART_W * TREND_SCREEN_CHART_H * sizeof(uint16_t)));
+  TEST_MESSAGE(msg);
+
+  // Scrolling moves every column, so it flushes the whole plot like lv_chart
+  const double plot_px = TREND_SCREEN_CHART_W * TREND_SCREEN_CHART_H;
+  TEST_ASSERT_TRUE(chart.px_per_sample >= plot_px);
+  TEST_ASSERT_TRUE(scroll.px_per_sample >= plot_px);
+  // Sweeping flushes the new column and the erased gap ahead of it
+  TEST_ASSERT_TRUE(sweep.px_per_sample <= 5 * TREND_SCREEN_CHART_H + 1);
+  // The strip is not in the LVGL heap, the series points are
+  TEST_ASSERT_TRUE(scroll.heap < chart.heap);
+  TEST_ASSERT_TRUE(sweep.heap < chart.heap);
+}
+
+void setUp() {
+  lv_init();
+  lv_tick_set_cb(tick_cb);
+  display = lv_display_create(HOR_RES, VER_RES);
+  lv_display_set_flush_cb(display, flush_cb);
+  lv_display_set_buffers(display, band, NULL, sizeof(band), LV_DISPLAY_RENDER_MODE_PARTIAL);
+}
+
+void tearDown() {
+  lv_deinit();
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_against_lv_chart);
+  return UNITY_END();
+}
@@ -0,0 +1,220 @@
+// test_ui_fields.cpp - dashboard readouts built from ui.cpp's field table against the old builder
+//
+//   pio test -e native -f test_ui_fields -v
+//
+// The old builder is create_ev_dashboard_ui()'s readout code before the table,
+// call for call (speed, unit, mode, left, right, bottom bar). Both run on the
+// same containers with the same dashData (mode "Eco"), interleaved, RUNS times
+// each. Every readout must end up at the same coordinates and the first frame
+// must flush the same pixels. Reported: host us to build the readouts and run
+// the layout pass before the first refresh, mean and best. The unit label's
+// lv_obj_align_to() lays the screen out wherever it comes in the build, so the
+// build alone doesn't compare. Host times only compare to each other.
+
+#include <unity.h>
+#include <lvgl.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "ui.h"
+#include "num_label.h"
+
+#define HOR_RES   480
+#define VER_RES   320
+#define BAND_ROWS 40
+#define RUNS      2000
+
+LV_FONT_DECLARE(lv_font_montserrat_78);
+
+typedef struct {
+  double best, sum;
+} timing_t;
+
+static lv_obj_t **const readouts[] = {
+  &speed_label, &mode_label, &range_label, &avg_wkm_label, &voltage, &current, &motor_temp_label,
+  &battery_temp_label, &soc, &trip_label, &odo_label, &avg_kmh_label,
+};
+
+#define READOUT_CNT (sizeof(readouts) / sizeof(readouts[0]))
+
+static uint16_t band[HOR_RES * BAND_ROWS];
+static lv_display_t *display;
+static uint32_t frame_crc;
+
+// Order-dependent checksum of everything flushed
+static void flush_cb(lv_display_t *d, const lv_area_t *area, uint8_t *px) {
+  uint32_t n = lv_area_get_size(area) * 2;
+  for (uint32_t i = 0; i < n; i++) frame_crc = frame_crc * 31 + px[i];
+  lv_display_flush_ready(d);
+}
+
+static double now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// ===== Builders =====
+// The screen, mode box and bottom bar, as create_ev_dashboard_ui() makes them
+static lv_obj_t *containers(lv_obj_t *parents[UI_PARENT_COUNT]) {
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(scr, lv_color_hex(0xe5e5e5), 0);
+
+  lv_obj_t *mode_container = lv_obj_create(scr);
+  lv_obj_set_size(mode_container, 100, 60);
+  lv_obj_align(mode_container, LV_ALIGN_CENTER, 0, 45);
+  lv_obj_set_style_bg_color(mode_container, lv_color_white(), 0);
+  lv_obj_set_style_radius(mode_container, 10, 0);
+  lv_obj_set_style_border_width(mode_container, 0, 0);
+
+  lv_obj_t *bottom_bar = lv_obj_create(scr);
+  lv_obj_set_size(bottom_bar, HOR_RES, 50);
+  lv_obj_align(bottom_bar, LV_ALIGN_BOTTOM_MID, 0, 0);
+  lv_obj_set_style_bg_color(bottom_bar, lv_color_white(), 0);
+  lv_obj_set_style_border_width(bottom_bar, 0, 0);
+  lv_obj_set_style_radius(bottom_bar, 0, 0);
+
+  parents[UI_PARENT_SCREEN] = scr;
+  parents[UI_PARENT_MODE_BOX] = mode_container;
+  parents[UI_PARENT_BOTTOM_BAR] = bottom_bar;
+  return scr;
+}
+
+static lv_obj_t *kmh_label(lv_obj_t *scr) {
+  lv_obj_t *kmh = lv_label_create(scr);
+  lv_label_set_text(kmh, "Km/h");
+  lv_obj_set_style_text_color(kmh, lv_color_black(), 0);
+  lv_obj_set_style_text_font(kmh, &lv_font_montserrat_16, 0);
+  lv_obj_align_to(kmh, speed_label, LV_ALIGN_OUT_RIGHT_MID, 4, 6);
+  return kmh;
+}
+
+static void table_build(lv_obj_t *const parents[UI_PARENT_COUNT]) {
+  ui_create_fields(parents);
+  kmh_label(parents[UI_PARENT_SCREEN]);
+}
+
+static lv_obj_t *old_num(lv_obj_t *parent, int32_t min, int32_t max, uint8_t decimals, const char *prefix,
+                         const char *suffix, int32_t value, const lv_font_t *font, lv_align_t align,
+                         int32_t x, int32_t y) {
+  lv_obj_t *obj = num_label_create(parent, min, max, decimals);
+  if (prefix) num_label_set_text(obj, prefix, suffix);
+  num_label_set_value(obj, value);
+  lv_obj_set_style_text_color(obj, lv_color_black(), 0);
+  lv_obj_set_style_text_font(obj, font, 0);
+  lv_obj_align(obj, align, x, y);
+  return obj;
+}
+
+// The readout code of create_ev_dashboard_ui() before the field table
+static void old_build(lv_obj_t *const parents[UI_PARENT_COUNT]) {
+  lv_obj_t *scr = parents[UI_PARENT_SCREEN];
+  lv_obj_t *bar = parents[UI_PARENT_BOTTOM_BAR];
+  const lv_font_t *f16 = &lv_font_montserrat_16, *f14 = &lv_font_montserrat_14;
+
+  speed_label = old_num(scr, 0, 199, 0, NULL, NULL, dashData.speed, &lv_font_montserrat_78, LV_ALIGN_CENTER, -24, -40);
+  kmh_label(scr);
+
+  mode_label = lv_label_create(parents[UI_PARENT_MODE_BOX]);
+  lv_label_set_text(mode_label, dashData.mode.c_str());
+  lv_obj_set_style_text_color(mode_label, lv_color_hex(0x00cc00), 0);
+  lv_obj_set_style_text_font(mode_label, &lv_font_montserrat_20, 0);
+  lv_obj_align(mode_label, LV_ALIGN_CENTER, 0, 0);
+
+  range_label = old_num(scr, 0, 999, 0, "Range: ", " km", dashData.range, f16, LV_ALIGN_LEFT_MID, 10, -60);
+  avg_wkm_label = old_num(scr, 0, 999, 0, "Avg. con: ", " W/km", dashData.avg_wkm, f16, LV_ALIGN_LEFT_MID, 10, -20);
+  voltage = old_num(scr, 0, 9999, 2, "Volt: ", " V", lroundf(dashData.voltage * 100), f16, LV_ALIGN_LEFT_MID, 10, 60);
+  current = old_num(scr, -99999, 99999, 2, "Current: ", " A", lroundf(dashData.current * 100), f16,
+                    LV_ALIGN_LEFT_MID, 10, 90);
+  motor_temp_label = old_num(scr, -40, 199, 0, "Motor: ", "°C", dashData.motor_temp, f16, LV_ALIGN_RIGHT_MID, -10, -60);
+  battery_temp_label = old_num(scr, -40, 199, 0, "Battery: ", "°C", dashData.battery_temp, f16,
+                               LV_ALIGN_RIGHT_MID, -10, -20);
+  soc = old_num(scr, 0, 100, 0, "SoC: ", "%", dashData.soc, f16, LV_ALIGN_RIGHT_MID, -10, 60);
+
+  trip_label = old_num(bar, 0, 99999, 0, "TRIP: ", " km", dashData.trip, f14, LV_ALIGN_LEFT_MID, 5, 0);
+  odo_label = old_num(bar, 0, 999999, 0, "ODO: ", " km", dashData.odo, f14, LV_ALIGN_CENTER, 0, 0);
+  avg_kmh_label = old_num(bar, 0, 199, 0, "Avg. SPEED: ", " km/h", dashData.avg_kmh, f14, LV_ALIGN_RIGHT_MID, -2, 0);
+}
+
+// ===== Tests =====
+static void run(void (*build)(lv_obj_t *const *), timing_t *t) {
+  lv_obj_t *parents[UI_PARENT_COUNT];
+  lv_obj_t *scr = containers(parents);
+  double t0 = now_us();
+  build(parents);
+  lv_obj_update_layout(scr);
+  double us = now_us() - t0;
+  lv_obj_delete(scr);
+
+  t->best = LV_MIN(t->best, us);
+  t->sum += us;
+}
+
+// Readout coordinates and the checksum of the first frame
+static uint32_t first_frame(void (*build)(lv_obj_t *const *), lv_area_t coords[READOUT_CNT]) {
+  lv_obj_t *parents[UI_PARENT_COUNT];
+  lv_obj_t *scr = containers(parents);
+  build(parents);
+  lv_screen_load(scr);
+  frame_crc = 0;
+  lv_refr_now(display);
+  for (uint32_t i = 0; i < READOUT_CNT; i++) lv_obj_get_coords(*readouts[i], &coords[i]);
+  return frame_crc;
+}
+
+static void test_same_screen() {
+  lv_area_t old_coords[READOUT_CNT], table_coords[READOUT_CNT];
+  uint32_t old_crc = first_frame(old_build, old_coords);
+  uint32_t table_crc = first_frame(table_build, table_coords);
+  for (uint32_t i = 0; i < READOUT_CNT; i++) {
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&old_coords[i], &table_coords[i], sizeof(lv_area_t)));
+  }
+  TEST_ASSERT_EQUAL_UINT32(old_crc, table_crc);
+}
+
+static void test_build_time() {
+  timing_t old_t = { 1e9, 0 }, table_t = { 1e9, 0 };
+  for (int r = 0; r < RUNS; r++) {
+    run(old_build, &old_t);
+    run(table_build, &table_t);
+  }
+
+  char msg[120];
+  snprintf(msg, sizeof(msg), "old builder: %5.0f us per build and layout (best %5.0f)", old_t.sum / RUNS, old_t.best);
+  TEST_MESSAGE(msg);
+  snprintf(msg, sizeof(msg), "field table: %5.0f us per build and layout (best %5.0f)", table_t.sum / RUNS,
+           table_t.best);
+  TEST_MESSAGE(msg);
+}
+
+void setUp() {
+  lv_init();
+  display = lv_display_create(HOR_RES, VER_RES);
+  lv_display_set_flush_cb(display, flush_cb);
+  lv_display_set_buffers(display, band, NULL, sizeof(band), LV_DISPLAY_RENDER_MODE_PARTIAL);
+
+  dashData.speed = 42;
+  dashData.range = 123;
+  dashData.avg_wkm = 45;
+  dashData.voltage = 72.4f;
+  dashData.current = -12.5f;
+  dashData.motor_temp = 65;
+  dashData.battery_temp = 41;
+  dashData.soc = 87;
+  dashData.trip = 1234;
+  dashData.odo = 123456;
+  dashData.avg_kmh = 42;
+  dashData.mode = "Eco";
+}
+
+void tearDown() {
+  lv_deinit();
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_same_screen);
+  RUN_TEST(test_build_time);
+  return UNITY_END();
+}
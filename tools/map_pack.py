@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+"""Build the offline map pack read by src/map_tiles.cpp (copy it to /map/tiles.bin on the SD card).
+
+The input is a directory of 256 px slippy map tiles, <dir>/<z>/<x>/<y>.png, rendered or
+downloaded within your tile source's terms. Each one is cut into 4 x 4 tiles of 64 px,
+converted to RGB565 and stored raw or run-length encoded, whichever is smaller.
+Identical tiles (sea, empty land) are stored once. Tiles missing from the input are
+filled with the background colour.
+
+Usage:
+  map_pack.py tiles/ --bbox 51.45,-0.20,51.55,0.00 --zooms 14-16 -o tiles.bin
+  map_pack.py tiles.bin --stats                   tiles, bytes and encodings per zoom
+
+Needs Pillow for the first form.
+"""
+import argparse
+import math
+import os
+import struct
+import sys
+
+MAGIC = b"DMAP"
+VERSION = 1
+TILE = 64
+SRC_TILE = 256
+HEADER = struct.Struct("<4sBBH")
+ZOOM = struct.Struct("<B3xiiHHI")
+ENTRY = struct.Struct("<IHBx")
+RAW, RLE = 0, 1
+MAX_ZOOMS = 8
+BACKGROUND = (0xF2, 0xEF, 0xE9)
+
+
+def world_px(lat, lon, zoom):
+    """Web mercator pixel of a position, the world being 256 << zoom pixels wide."""
+    size = SRC_TILE << zoom
+    lat = max(-85.0511287, min(85.0511287, lat))
+    s = math.sin(math.radians(lat))
+    x = (lon + 180.0) / 360.0 * size
+    y = (0.5 - math.log((1 + s) / (1 - s)) / (4 * math.pi)) * size
+    return int(x), int(y)
+
+
+def rgb565(img):
+    """Little endian RGB565 bytes of a 64 x 64 RGB image."""
+    rgb = img.tobytes()
+    out = bytearray()
+    for i in range(0, len(rgb), 3):
+        r, g, b = rgb[i], rgb[i + 1], rgb[i + 2]
+        out += struct.pack("<H", ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3))
+    return bytes(out)
+
+
+def rle(px):
+    """c < 0x80: c + 1 literal pixels follow; else one pixel repeated (c & 0x7F) + 1 times."""
+    pixels = [px[i:i + 2] for i in range(0, len(px), 2)]
+    out = bytearray()
+    literal = []
+
+    def flush():
+        while literal:
+            chunk = literal[:128]
+            del literal[:128]
+            out.append(len(chunk) - 1)
+            out.extend(b"".join(chunk))
+
+    i = 0
+    while i < len(pixels):
+        run = 1
+        while i + run < len(pixels) and run < 128 and pixels[i + run] == pixels[i]:
+            run += 1
+        if run >= 2:
+            flush()
+            out.append(0x80 | (run - 1))
+            out.extend(pixels[i])
+        else:
+            literal.append(pixels[i])
+        i += run
+    flush()
+    return bytes(out)
+
+
+def load_source(root, z, x, y, cache):
+    """256 px source tile, or None; keeps one row of them, as tiles are visited row by row."""
+    from PIL import Image
+
+    if cache.get("row") != (z, y):
+        cache.clear()
+        cache["row"] = (z, y)
+    if x not in cache:
+        path = os.path.join(root, str(z), str(x), "%d.png" % y)
+        cache[x] = Image.open(path).convert("RGB") if os.path.exists(path) else None
+    return cache[x]
+
+
+def build(args):
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit("map_pack.py needs Pillow: pip install pillow")
+
+    lat1, lon1, lat2, lon2 = (float(v) for v in args.bbox.split(","))
+    z1, _, z2 = args.zooms.partition("-")
+    zooms = list(range(int(z1), int(z2 or z1) + 1))
+    if len(zooms) > MAX_ZOOMS:
+        sys.exit("at most %d zoom levels" % MAX_ZOOMS)
+
+    ranges = []
+    first = 0
+    for z in zooms:
+        xa, ya = world_px(max(lat1, lat2), min(lon1, lon2), z)
+        xb, yb = world_px(min(lat1, lat2), max(lon1, lon2), z)
+        x0, y0 = xa // TILE, ya // TILE
+        cols, rows = xb // TILE - x0 + 1, yb // TILE - y0 + 1
+        if cols > 0xFFFF or rows > 0xFFFF:
+            sys.exit("zoom %d: the box is too large" % z)
+        ranges.append((z, x0, y0, cols, rows, first))
+        first += cols * rows
+
+    blank = Image.new("RGB", (TILE, TILE), BACKGROUND)
+    entries = []
+    data = bytearray()
+    stored = {}
+    cache = {}
+    for z, x0, y0, cols, rows, _ in ranges:
+        for y in range(y0, y0 + rows):
+            for x in range(x0, x0 + cols):
+                src = load_source(args.tiles, z, x // 4, y // 4, cache)
+                if src is None:
+                    tile = blank
+                else:
+                    sx, sy = (x % 4) * TILE, (y % 4) * TILE
+                    tile = src.crop((sx, sy, sx + TILE, sy + TILE))
+                px = rgb565(tile)
+                if px not in stored:
+                    enc = rle(px)
+                    encoding, payload = (RLE, enc) if len(enc) < len(px) else (RAW, px)
+                    stored[px] = (len(data), len(payload), encoding)
+                    data += payload
+                entries.append(stored[px])
+            print("zoom %d: row %d/%d" % (z, y - y0 + 1, rows), end="\r", file=sys.stderr)
+        print(file=sys.stderr)
+
+    data_pos = HEADER.size + ZOOM.size * len(ranges) + ENTRY.size * len(entries)
+    with open(args.output, "wb") as f:
+        f.write(HEADER.pack(MAGIC, VERSION, len(ranges), TILE))
+        for r in ranges:
+            f.write(ZOOM.pack(*r))
+        for offset, size, encoding in entries:
+            f.write(ENTRY.pack(data_pos + offset, size, encoding))
+        f.write(data)
+    print("%s: %d tiles, %d stored, %d bytes" % (args.output, len(entries), len(stored), data_pos + len(data)))
+
+
+def stats(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    magic, version, zoom_cnt, tile = HEADER.unpack_from(data, 0)
+    if magic != MAGIC or version != VERSION or tile != TILE:
+        sys.exit("not a version %d map pack" % VERSION)
+    print("%-5s %8s %8s %6s %6s %10s" % ("zoom", "origin", "size", "raw", "rle", "bytes"))
+    for i in range(zoom_cnt):
+        z, x0, y0, cols, rows, first = ZOOM.unpack_from(data, HEADER.size + i * ZOOM.size)
+        dir_pos = HEADER.size + zoom_cnt * ZOOM.size
+        counts = [0, 0]
+        seen = set()
+        size = 0
+        for k in range(first, first + cols * rows):
+            offset, n, encoding = ENTRY.unpack_from(data, dir_pos + k * ENTRY.size)
+            counts[encoding] += 1
+            if offset not in seen:
+                seen.add(offset)
+                size += n
+        print("%-5d %8s %8s %6d %6d %10d" % (z, "%d,%d" % (x0, y0), "%dx%d" % (cols, rows),
+                                            counts[RAW], counts[RLE], size))
+    print("total %d bytes" % len(data))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("tiles", help="tile directory, or a pack with --stats")
+    ap.add_argument("--bbox", help="lat1,lon1,lat2,lon2")
+    ap.add_argument("--zooms", help="zoom levels, e.g. 14-16")
+    ap.add_argument("-o", "--output", default="tiles.bin")
+    ap.add_argument("--stats", action="store_true", help="describe an existing pack")
+    args = ap.parse_args()
+
+    if args.stats:
+        stats(args.tiles)
+    elif args.bbox and args.zooms:
+        build(args)
+    else:
+        ap.error("--bbox and --zooms are needed to build a pack")
+
+
+if __name__ == "__main__":
+    main()
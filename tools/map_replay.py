@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+"""Replay a GPS track to the dashboard over RS485 and report map tile misses and frame times.
+
+The track is sent as controller frames (ID_LATITUDE, ID_LONGITUDE, ID_HEADING, ID_SPEED)
+through a USB-RS485 adapter while the map screen is open. The dashboard's metrics are
+read over its USB serial port before and after: counters are reported as the
+difference, histograms (lv.render_us, map.tile_load_us) as totals since boot, so
+reset the board first for clean numbers.
+
+Track: GPX (<trkpt lat lon> with <time>) or CSV with lat,lon[,t_s] columns (1 s apart
+without t_s).
+
+Usage:
+  map_replay.py track.gpx --rs485 /dev/ttyUSB1 --console /dev/ttyUSB0
+  map_replay.py track.csv --rs485 /dev/ttyUSB1 --console /dev/ttyUSB0 --speedup 4 --rate 10
+  map_replay.py track.gpx --frames out.bin      write the frames instead of sending them
+
+Needs pyserial to send.
+"""
+import argparse
+import csv
+import datetime
+import math
+import struct
+import sys
+import time
+import xml.etree.ElementTree as ET
+
+STX1, STX2, ETX = 0x5D, 0x47, 0x78
+ID_SPEED = 0x82
+ID_LATITUDE = 0x90
+ID_LONGITUDE = 0x91
+ID_HEADING = 0x98
+FRAME_HEADER = bytes(7)  # src, dest, cmd, subcmd, reserved: ignored by the dashboard
+
+COUNTERS = ("map.tile_hits", "map.tile_misses", "map.tile_loads", "map.prefetch_hits",
+            "lv.renders", "rs485.frames", "rs485.bad_frames")
+HISTS = ("lv.render_us", "map.tile_load_us", "rs485.frame_us")
+GAUGES = ("map.tiles_cached", "sys.heap_free", "sys.heap_min_free", "sys.heap_largest")
+
+
+def crc16_modbus(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+def frame(payload):
+    body = FRAME_HEADER + payload + bytes([ETX])
+    length = struct.pack(">H", len(body))
+    return bytes([STX1, STX2]) + length + body + struct.pack(">H", crc16_modbus(length + body))
+
+
+def position_frame(lat, lon, heading, kmh):
+    return frame(struct.pack(">BiBiBHBH",
+                             ID_LATITUDE, round(lat * 1e7),
+                             ID_LONGITUDE, round(lon * 1e7),
+                             ID_HEADING, round(heading * 10) % 3600,
+                             ID_SPEED, min(round(kmh * 10), 0xFFFF)))
+
+
+def read_track(path):
+    """[(t_s, lat, lon)] starting at t = 0."""
+    points = []
+    if path.lower().endswith(".gpx"):
+        for el in ET.parse(path).iter():
+            if el.tag.endswith("trkpt"):
+                t = None
+                for child in el:
+                    if child.tag.endswith("time") and child.text:
+                        t = datetime.datetime.fromisoformat(child.text.replace("Z", "+00:00")).timestamp()
+                points.append([t, float(el.get("lat")), float(el.get("lon"))])
+    else:
+        with open(path, newline="") as f:
+            for row in csv.DictReader(f):
+                t = float(row["t_s"]) if row.get("t_s") else None
+                points.append([t, float(row["lat"]), float(row["lon"])])
+    if len(points) < 2:
+        sys.exit("the track needs at least two points")
+    for i, p in enumerate(points):
+        if p[0] is None:
+            p[0] = float(i)
+    t0 = points[0][0]
+    return [(t - t0, lat, lon) for t, lat, lon in points]
+
+
+def distance_m(lat1, lon1, lat2, lon2):
+    r = 6371000.0
+    p1, p2 = math.radians(lat1), math.radians(lat2)
+    dp, dl = p2 - p1, math.radians(lon2 - lon1)
+    a = math.sin(dp / 2) ** 2 + math.cos(p1) * math.cos(p2) * math.sin(dl / 2) ** 2
+    return 2 * r * math.asin(math.sqrt(a))
+
+
+def bearing(lat1, lon1, lat2, lon2):
+    p1, p2 = math.radians(lat1), math.radians(lat2)
+    dl = math.radians(lon2 - lon1)
+    y = math.sin(dl) * math.cos(p2)
+    x = math.cos(p1) * math.sin(p2) - math.sin(p1) * math.cos(p2) * math.cos(dl)
+    return math.degrees(math.atan2(y, x)) % 360
+
+
+def samples(track, rate):
+    """(t_s, frame) at `rate` Hz of track time, interpolated between points."""
+    seg = 0
+    t = 0.0
+    end = track[-1][0]
+    heading = 0.0
+    while t <= end:
+        while seg < len(track) - 2 and track[seg + 1][0] < t:
+            seg += 1
+        (ta, la, oa), (tb, lb, ob) = track[seg], track[seg + 1]
+        f = (t - ta) / (tb - ta) if tb > ta else 0.0
+        lat, lon = la + (lb - la) * f, oa + (ob - oa) * f
+        d = distance_m(la, oa, lb, ob)
+        if d > 0.5:
+            heading = bearing(la, oa, lb, ob)
+        kmh = d / (tb - ta) * 3.6 if tb > ta else 0.0
+        yield t, position_frame(lat, lon, heading, kmh)
+        t += 1.0 / rate
+
+
+def read_metrics(console):
+    """{name: value string} from the dashboard's "metrics" command."""
+    console.reset_input_buffer()
+    console.write(b"metrics\n")
+    values = {}
+    deadline = time.time() + 2
+    while time.time() < deadline:
+        line = console.readline()
+        if not line:
+            if values:
+                break  # the dump is over
+            continue
+        parts = line.decode(errors="replace").strip().split(" ", 2)
+        if len(parts) == 3 and parts[1] in ("counter", "gauge", "hist"):
+            values[parts[0]] = parts[2]
+    return values
+
+
+def report(before, after, seconds, frames):
+    delta = {k: int(after.get(k, 0)) - int(before.get(k, 0)) for k in COUNTERS}
+    seen = delta["map.tile_hits"] + delta["map.tile_misses"]
+    print("replayed %d frames in %.1f s" % (frames, seconds))
+    for k in COUNTERS:
+        print("  %-20s %8d" % (k, delta[k]))
+    if seen:
+        print("  tile miss rate       %7.1f %%  (%d of %d tiles coming into view)"
+              % (100.0 * delta["map.tile_misses"] / seen, delta["map.tile_misses"], seen))
+    if delta["map.tile_loads"]:
+        print("  prefetch hit rate    %7.1f %%  of tiles read"
+              % (100.0 * delta["map.prefetch_hits"] / delta["map.tile_loads"]))
+    for k in HISTS + GAUGES:
+        print("  %-20s %s" % (k, after.get(k, "-")))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("track")
+    ap.add_argument("--rs485", help="serial port of the USB-RS485 adapter")
+    ap.add_argument("--console", help="USB serial port of the dashboard, for the metrics")
+    ap.add_argument("--baud", type=int, default=115200, help="RS485 baud rate")
+    ap.add_argument("--rate", type=float, default=5, help="position frames per second of track time")
+    ap.add_argument("--speedup", type=float, default=1, help="replay this many times faster")
+    ap.add_argument("--frames", metavar="FILE", help="write the frames to FILE instead")
+    args = ap.parse_args()
+
+    track = read_track(args.track)
+    if args.frames:
+        n = 0
+        with open(args.frames, "wb") as f:
+            for _, fr in samples(track, args.rate):
+                f.write(fr)
+                n += 1
+        print("%d frames, %.0f s of track" % (n, track[-1][0]))
+        return
+
+    if not args.rs485:
+        ap.error("--rs485 or --frames is needed")
+    try:
+        import serial
+    except ImportError:
+        sys.exit("map_replay.py needs pyserial: pip install pyserial")
+
+    bus = serial.Serial(args.rs485, args.baud)
+    console = serial.Serial(args.console, 115200, timeout=0.5) if args.console else None
+    if console:
+        console.write(b"map\n")  # open the map screen
+        time.sleep(0.5)
+    before = read_metrics(console) if console else {}
+
+    start = time.time()
+    n = 0
+    for t, fr in samples(track, args.rate):
+        wait = start + t / args.speedup - time.time()
+        if wait > 0:
+            time.sleep(wait)
+        bus.write(fr)
+        n += 1
+    seconds = time.time() - start
+    time.sleep(1)  # let the last tiles load
+
+    if console:
+        report(before, read_metrics(console), seconds, n)
+    else:
+        print("replayed %d frames in %.1f s (no --console: no metrics)" % (n, seconds))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""Decode a trip log written by src/telemetry_log.cpp (/telemetry/Txxxx.evt).
+
+Usage:
+  telemetry_decode.py T0000.evt                 long CSV (t_ms,signal,value) on stdout
+  telemetry_decode.py T0000.evt --columns out/  one <signal>.csv per signal in out/
+  telemetry_decode.py T0000.evt --stats         samples and bytes per signal
+"""
+import argparse
+import csv
+import os
+import struct
+import sys
+
+MAGIC = b"EVTL"
+VERSION = 1
+BLOCK_HEADER = struct.Struct("<BBHIi")
+
+# Protocol data IDs (include/shared.h) -> column name, scale
+SIGNALS = {
+    0x80: ("battery_temp", 1),
+    0x82: ("speed", 1),
+    0x83: ("voltage", 0.01),
+    0x84: ("current", 0.01),
+    0x85: ("soc", 1),
+    0x86: ("mode", 1),
+    0x87: ("armed", 1),
+    0x88: ("range", 1),
+    0x89: ("avg_wkm", 1),
+    0x8A: ("motor_temp", 1),
+    0x8B: ("trip", 1),
+    0x8C: ("odo", 1),
+    0x8D: ("avg_kmh", 1),
+    0x90: ("latitude", 1e-7),
+    0x91: ("longitude", 1e-7),
+    0x98: ("heading", 1),
+}
+
+
+def read_varint(buf, pos):
+    value = shift = 0
+    while True:
+        b = buf[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if b < 0x80:
+            return value, pos
+        shift += 7
+
+
+def unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def decode(data):
+    """Yield (signal_id, t_ms, raw_value, block_bytes) for every sample."""
+    if data[:4] != MAGIC:
+        raise ValueError("not a telemetry log")
+    if data[4] != VERSION:
+        raise ValueError("unsupported log version %d" % data[4])
+
+    pos = 8
+    while pos + BLOCK_HEADER.size <= len(data):
+        sig, count, plen, t, v = BLOCK_HEADER.unpack_from(data, pos)
+        pos += BLOCK_HEADER.size
+        end = pos + plen
+        if end > len(data):
+            break  # truncated by a power cut
+        size = BLOCK_HEADER.size + plen
+        yield sig, t, v, size
+        for _ in range(count - 1):
+            dt, pos = read_varint(data, pos)
+            dv, pos = read_varint(data, pos)
+            t = (t + dt) & 0xFFFFFFFF
+            v += unzigzag(dv)
+            yield sig, t, v, 0
+        pos = end
+
+
+def name_and_scale(sig):
+    return SIGNALS.get(sig, ("id_%02x" % sig, 1))
+
+
+def scaled(sig, v):
+    scale = name_and_scale(sig)[1]
+    return v if scale == 1 else round(v * scale, 2)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("log")
+    ap.add_argument("--columns", metavar="DIR", help="write one CSV per signal into DIR")
+    ap.add_argument("--stats", action="store_true", help="print samples/bytes per signal")
+    args = ap.parse_args()
+
+    with open(args.log, "rb") as f:
+        data = f.read()
+
+    if args.stats:
+        stats = {}
+        for sig, _, _, size in decode(data):
+            n, b = stats.get(sig, (0, 0))
+            stats[sig] = (n + 1, b + size)
+        total_n = sum(n for n, _ in stats.values())
+        print("%-14s %8s %8s %10s" % ("signal", "samples", "bytes", "B/sample"))
+        for sig in sorted(stats):
+            n, b = stats[sig]
+            print("%-14s %8d %8d %10.2f" % (name_and_scale(sig)[0], n, b, b / n))
+        print("total: %d samples in %d bytes" % (total_n, len(data)))
+    elif args.columns:
+        os.makedirs(args.columns, exist_ok=True)
+        files = {}
+        try:
+            for sig, t, v, _ in decode(data):
+                if sig not in files:
+                    name = name_and_scale(sig)[0]
+                    fh = open(os.path.join(args.columns, name + ".csv"), "w", newline="")
+                    w = csv.writer(fh)
+                    w.writerow(["t_ms", name])
+                    files[sig] = (fh, w)
+                files[sig][1].writerow([t, scaled(sig, v)])
+        finally:
+            for fh, _ in files.values():
+                fh.close()
+    else:
+        w = csv.writer(sys.stdout)
+        w.writerow(["t_ms", "signal", "value"])
+        rows = sorted(decode(data), key=lambda r: r[1])
+        for sig, t, v, _ in rows:
+            w.writerow([t, name_and_scale(sig)[0], scaled(sig, v)])
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""Convert a serial trace from src/trace.cpp (build flag DASH_TRACE) to Chrome trace JSON.
+
+Capture the raw serial output first, e.g.
+  pio device monitor -b 921600 --raw > trace.bin
+Text printed on the same port is skipped.
+
+Usage:
+  trace_to_chrome.py trace.bin -o trace.json     open in chrome://tracing or ui.perfetto.dev
+  trace_to_chrome.py trace.bin --stats           time per marker, worst first
+  trace_to_chrome.py trace.bin --slowest 3       breakdown of the 3 slowest frames
+"""
+import argparse
+import json
+import sys
+
+SYNC = b"\xA5\x5A"
+REC_START = 0x01
+REC_NAME = 0x02
+REC_BEGIN = 0x03
+REC_END = 0x04
+
+FRAME = "lv_display_refr_timer"
+
+
+def fletcher16(data):
+    s1 = s2 = 0
+    for b in data:
+        s1 = (s1 + b) % 255
+        s2 = (s2 + s1) % 255
+    return s1, s2
+
+
+def packets(data):
+    """Yield (seq, payload) of every valid packet, skipping anything in between."""
+    pos = 0
+    while True:
+        pos = data.find(SYNC, pos)
+        if pos < 0 or pos + 6 > len(data):
+            return
+        n = data[pos + 2]
+        end = pos + 4 + n
+        if end + 2 > len(data):
+            return
+        if n and fletcher16(data[pos + 3:end]) == (data[end], data[end + 1]):
+            yield data[pos + 3], data[pos + 4:end]
+            pos = end + 2
+        else:
+            pos += 1  # a sync pattern inside text or a corrupted packet
+
+
+def read_varint(buf, pos):
+    value = shift = 0
+    while True:
+        b = buf[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if b < 0x80:
+            return value, pos
+        shift += 7
+
+
+def decode(data, warn=sys.stderr):
+    """Yield (ph, name, ts_us, cpu, tid) for every marker; ph is "B" or "E"."""
+    names = {0: "?"}
+    t = 0
+    last_seq = None
+    for seq, p in packets(data):
+        if last_seq is not None and seq != (last_seq + 1) & 0xFF:
+            print("warning: %d packet(s) lost before #%d" % ((seq - last_seq - 1) & 0xFF, seq), file=warn)
+        last_seq = seq
+
+        pos = 0
+        while pos < len(p):
+            op = p[pos]
+            pos += 1
+            kind = op & 0x0F
+            if kind == REC_START:
+                names = {0: "?"}
+                t = 0
+            elif kind == REC_NAME:
+                nid, pos = read_varint(p, pos)
+                n = p[pos]
+                names[nid] = p[pos + 1:pos + 1 + n].decode("ascii", "replace")
+                pos += 1 + n
+            elif kind in (REC_BEGIN, REC_END):
+                nid, pos = read_varint(p, pos)
+                dt, pos = read_varint(p, pos)
+                tid, pos = read_varint(p, pos)
+                t += dt
+                yield ("B" if kind == REC_BEGIN else "E"), names.get(nid, "?%d" % nid), t, op >> 4, tid
+            else:
+                print("warning: unknown record 0x%02x in #%d" % (op, seq), file=warn)
+                break
+
+
+def spans(markers):
+    """Pair the markers per thread. Yield (name, start, dur, self, depth, cpu, tid)."""
+    stacks = {}
+    for ph, name, t, cpu, tid in markers:
+        st = stacks.setdefault((cpu, tid), [])
+        if ph == "B":
+            st.append([name, t, 0])
+            continue
+        # Close up to the matching begin; unmatched ends (trace started inside) are dropped
+        for i in range(len(st) - 1, -1, -1):
+            if st[i][0] == name:
+                break
+        else:
+            continue
+        while len(st) > i:
+            n, start, child = st.pop()
+            dur = t - start
+            if st:
+                st[-1][2] += dur
+            yield n, start, dur, dur - child, len(st), cpu, tid
+
+
+def to_chrome(markers):
+    events = []
+    threads = set()
+    for ph, name, t, cpu, tid in markers:
+        events.append({"name": name, "ph": ph, "ts": t, "pid": cpu, "tid": tid})
+        threads.add((cpu, tid))
+    for cpu in sorted({c for c, _ in threads}):
+        events.append({"name": "process_name", "ph": "M", "pid": cpu, "args": {"name": "core %d" % cpu}})
+    for cpu, tid in sorted(threads):
+        events.append({"name": "thread_name", "ph": "M", "pid": cpu, "tid": tid,
+                       "args": {"name": "thread %d" % tid if tid else "loop"}})
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+def print_stats(all_spans):
+    stats = {}
+    for name, _, dur, self_t, _, _, _ in all_spans:
+        n, total, own, worst = stats.get(name, (0, 0, 0, 0))
+        stats[name] = (n + 1, total + dur, own + self_t, max(worst, dur))
+    print("%-36s %7s %10s %10s %9s %9s" % ("marker", "count", "total ms", "self ms", "avg us", "max us"))
+    for name, (n, total, own, worst) in sorted(stats.items(), key=lambda kv: -kv[1][2]):
+        print("%-36s %7d %10.2f %10.2f %9.0f %9d" % (name[:36], n, total / 1000, own / 1000, total / n, worst))
+
+
+def print_slowest(all_spans, count):
+    frames = [s for s in all_spans if s[0] == FRAME]
+    frames.sort(key=lambda s: -s[2])
+    for name, start, dur, _, _, cpu, tid in frames[:count]:
+        print("%s at %.3f s: %.2f ms" % (FRAME, start / 1e6, dur / 1000))
+        own = {}
+        for n, s, d, self_t, _, c, t in all_spans:
+            if (c, t) == (cpu, tid) and s >= start and s + d <= start + dur:
+                own[n] = own.get(n, 0) + self_t
+        for n, self_t in sorted(own.items(), key=lambda kv: -kv[1])[:12]:
+            print("  %-36s %8.2f ms self" % (n[:36], self_t / 1000))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("capture", help="raw serial capture, - for stdin")
+    ap.add_argument("-o", "--output", help="Chrome trace JSON to write (default: stdout)")
+    ap.add_argument("--stats", action="store_true", help="print the time per marker")
+    ap.add_argument("--slowest", type=int, metavar="N", help="print where the N slowest frames went")
+    args = ap.parse_args()
+
+    if args.capture == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.capture, "rb") as f:
+            data = f.read()
+    markers = list(decode(data))
+
+    if args.stats or args.slowest:
+        all_spans = list(spans(markers))
+        if args.stats:
+            print_stats(all_spans)
+        if args.slowest:
+            print_slowest(all_spans, args.slowest)
+        return
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    try:
+        json.dump(to_chrome(markers), out)
+    finally:
+        if args.output:
+            out.close()
+    if args.output:
+        print("%d markers -> %s" % (len(markers), args.output), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()